@@ -43,6 +43,7 @@ THE SOFTWARE.
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
 #include "2d/CCComponentContainer.h"
+#include "2d/CCTransformHierarchy.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "math/TransformUtils.h"
@@ -96,6 +97,12 @@ Node::Node(void)
 , _inverseDirty(true)
 , _useAdditionalTransform(false)
 , _transformUpdated(true)
+, _transformHierarchyPass(0)
+, _transformHierarchyFlags(0)
+, _transformHierarchyStale(false)
+, _subtreeCullingEnabled(false)
+, _subtreeBoundsDirty(true)
+, _culledFlags(0)
 // children (lazy allocs)
 // lazy alloc
 , _localZOrder(0)
@@ -114,6 +121,7 @@ Node::Node(void)
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _reorderPending(false)
 , _isTransitionFinished(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
@@ -186,6 +194,7 @@ Node::~Node()
     for (auto& child : _children)
     {
         child->_parent = nullptr;
+        child->_reorderPending = false;
     }
 
     removeAllComponents();
@@ -264,6 +273,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 }
 
 float Node::getSkewY() const
@@ -285,6 +295,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 }
 
 void Node::setLocalZOrder(int z)
@@ -305,7 +316,11 @@ void Node::setLocalZOrder(int z)
 /// used internally to alter the zOrder variable. DON'T call this method manually
 void Node::_setLocalZOrder(int z)
 {
+    if (_localZOrder == z)
+        return;
+
     _localZOrder = z;
+    markReorderedInParent();
 }
 
 void Node::setGlobalZOrder(float globalZOrder)
@@ -332,6 +347,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 #if CC_USE_PHYSICS
     if (_physicsBody && _physicsBody->getWorld()) {
         _physicsBody->getWorld()->_updateBodyTransform = true;
@@ -354,6 +370,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -410,6 +427,7 @@ void Node::setRotationQuat(const Quaternion& quat)
     _rotationQuat = quat;
     updateRotation3D();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 }
 
 Quaternion Node::getRotationQuat() const
@@ -431,6 +449,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
     
     updateRotationQuat();
 }
@@ -454,6 +473,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
     
     updateRotationQuat();
 }
@@ -473,6 +493,7 @@ void Node::setScale(float scale)
     
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 #if CC_USE_PHYSICS
     if (_physicsBody && _physicsBody->getWorld()) {
         _physicsBody->getWorld()->_updateBodyTransform = true;
@@ -495,6 +516,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 #if CC_USE_PHYSICS
     if (_physicsBody && _physicsBody->getWorld()) {
         _physicsBody->getWorld()->_updateBodyTransform = true;
@@ -510,6 +532,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 #if CC_USE_PHYSICS
     if (_physicsBody && _physicsBody->getWorld()) {
         _physicsBody->getWorld()->_updateBodyTransform = true;
@@ -538,6 +561,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 }
 
 /// scaleY getter
@@ -554,6 +578,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 #if CC_USE_PHYSICS
     if (_physicsBody && _physicsBody->getWorld()) {
         _physicsBody->getWorld()->_updateBodyTransform = true;
@@ -589,6 +614,7 @@ void Node::setPosition(float x, float y)
     _position.y = y;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
     _usingNormalizedPosition = false;
 #if CC_USE_PHYSICS
     if (_physicsBody && _physicsBody->getWorld()) {
@@ -639,6 +665,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 
     _positionZ = positionZ;
 }
@@ -659,6 +686,7 @@ void Node::setNormalizedPosition(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 #if CC_USE_PHYSICS
     if (_physicsBody && _physicsBody->getWorld()) {
         _physicsBody->getWorld()->_updateBodyTransform = true;
@@ -685,6 +713,7 @@ void Node::setVisible(bool visible)
         _visible = visible;
         if(_visible)
             _transformUpdated = _transformDirty = _inverseDirty = true;
+        markParentSubtreeBoundsDirty();
     }
 }
 
@@ -714,6 +743,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markParentSubtreeBoundsDirty();
     }
 }
 
@@ -731,6 +761,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        markSubtreeBoundsDirty();
     }
 }
 
@@ -743,8 +774,23 @@ bool Node::isRunning() const
 /// parent setter
 void Node::setParent(Node * parent)
 {
+    if (_reorderPending && _parent && _parent != parent)
+    {
+        // don't leave a dangling pointer in the former parent's list
+        auto& reordered = _parent->_reorderedChildren;
+        auto it = std::find(reordered.begin(), reordered.end(), this);
+        if (it != reordered.end())
+        {
+            *it = reordered.back();
+            reordered.pop_back();
+        }
+        _reorderPending = false;
+    }
+    markParentSubtreeBoundsDirty();
     _parent = parent;
+    markParentSubtreeBoundsDirty();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    TransformHierarchy::markStructureDirty();
 }
 
 /// isRelativeAnchorPoint getter
@@ -759,6 +805,7 @@ void Node::ignoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markParentSubtreeBoundsDirty();
     }
 }
 
@@ -800,7 +847,11 @@ int Node::getOrderOfArrival() const
 void Node::setOrderOfArrival(int orderOfArrival)
 {
     CCASSERT(orderOfArrival >=0, "Invalid orderOfArrival");
+    if (_orderOfArrival == orderOfArrival)
+        return;
+
     _orderOfArrival = orderOfArrival;
+    markReorderedInParent();
 }
 
 void Node::setUserObject(Ref *userObject)
@@ -860,6 +911,80 @@ Rect Node::getBoundingBox() const
     return RectApplyAffineTransform(rect, getNodeToParentAffineTransform());
 }
 
+AABB Node::getContentAABB() const
+{
+    return AABB(Vec3::ZERO, Vec3(_contentSize.width, _contentSize.height, 0));
+}
+
+// MARK: Subtree culling
+
+void Node::setSubtreeCullingEnabled(bool enabled)
+{
+    if (enabled != _subtreeCullingEnabled)
+    {
+        _subtreeCullingEnabled = enabled;
+        _subtreeBoundsDirty = true;
+        _culledFlags = 0;
+    }
+}
+
+const AABB& Node::getSubtreeAABB()
+{
+    // only culled subtrees keep their bounds up to date, the others are recomputed on demand
+    if (_subtreeBoundsDirty || !_subtreeCullingEnabled)
+    {
+        _subtreeAABB = getContentAABB();
+        mergeChildrenAABB(Mat4::IDENTITY, &_subtreeAABB);
+        _subtreeBoundsDirty = false;
+    }
+    return _subtreeAABB;
+}
+
+void Node::mergeSubtreeAABB(const Mat4& parentTransform, AABB* aabb)
+{
+    if (!_visible)
+    {
+        // nothing below is tracked while hidden, setVisible() dirties the ancestors again
+        _subtreeBoundsDirty = true;
+        return;
+    }
+    
+    Mat4 transform = parentTransform * getNodeToParentTransform();
+    AABB bounds = _subtreeCullingEnabled ? getSubtreeAABB() : getContentAABB();
+    if (!bounds.isEmpty())
+    {
+        bounds.transform(transform);
+        aabb->merge(bounds);
+    }
+    
+    if (!_subtreeCullingEnabled)
+    {
+        mergeChildrenAABB(transform, aabb);
+        // from now on, changes in the subtree are propagated to the ancestors
+        _subtreeBoundsDirty = false;
+    }
+}
+
+void Node::mergeChildrenAABB(const Mat4& transform, AABB* aabb)
+{
+    for (const auto& child : _children)
+        child->mergeSubtreeAABB(transform, aabb);
+}
+
+bool Node::isSubtreeVisibleByVisitingCamera()
+{
+    auto camera = Camera::getVisitingCamera();
+    if (camera == nullptr)
+        return true;
+    
+    AABB bounds = getSubtreeAABB();
+    if (bounds.isEmpty())
+        return true;
+    
+    bounds.transform(_modelViewTransform);
+    return camera->isVisibleInFrustum(&bounds);
+}
+
 // MARK: Children logic
 
 // lazy allocs
@@ -1174,6 +1299,10 @@ void Node::removeFromPhysicsWorld()
 
 void Node::removeAllChildrenWithCleanup(bool cleanup)
 {
+    for (const auto& child : _reorderedChildren)
+        child->_reorderPending = false;
+    _reorderedChildren.clear();
+    
     // not using detachChild improves speed here
     for (const auto& child : _children)
     {
@@ -1237,6 +1366,7 @@ void Node::insertChild(Node* child, int z)
     _reorderChildDirty = true;
     _children.pushBack(child);
     child->_localZOrder = z;
+    markChildReordered(child);
 }
 
 void Node::reorderChild(Node *child, int zOrder)
@@ -1245,17 +1375,65 @@ void Node::reorderChild(Node *child, int zOrder)
     _reorderChildDirty = true;
     child->setOrderOfArrival(s_globalOrderOfArrival++);
     child->_localZOrder = zOrder;
+    markChildReordered(child);
 }
 
 void Node::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        std::sort(std::begin(_children), std::end(_children), nodeComparisonLess);
+        sortReorderedChildren();
         _reorderChildDirty = false;
     }
 }
 
+void Node::sortReorderedChildren()
+{
+    if (_reorderedChildren.empty())
+        return;
+    
+    auto children = _children.begin();
+    ssize_t count = _children.size();
+    
+    // pull the reordered children out, the others keep their relative order and are still sorted
+    ssize_t kept = 0;
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        Node* child = children[i];
+        if (child->_reorderPending)
+            child->_reorderPending = false;
+        else
+            children[kept++] = child;
+    }
+    
+    // entries that were not found in _children (e.g. protected children) are dropped
+    ssize_t moved = 0;
+    for (const auto& child : _reorderedChildren)
+    {
+        if (child->_reorderPending)
+            child->_reorderPending = false;
+        else
+            _reorderedChildren[moved++] = child;
+    }
+    _reorderedChildren.resize(moved);
+    CCASSERT(kept + moved == count, "reordered children out of sync");
+    
+    // sort the few reordered children, then merge both runs from the back
+    std::sort(_reorderedChildren.begin(), _reorderedChildren.end(), nodeComparisonLess);
+    ssize_t i = kept - 1;
+    ssize_t j = moved - 1;
+    ssize_t dst = count - 1;
+    while (j >= 0)
+    {
+        if (i >= 0 && nodeComparisonLess(_reorderedChildren[j], children[i]))
+            children[dst--] = children[i--];
+        else
+            children[dst--] = _reorderedChildren[j--];
+    }
+    
+    _reorderedChildren.clear();
+}
+
 // MARK: draw / visit
 
 void Node::draw()
@@ -1277,6 +1455,13 @@ void Node::visit()
 
 uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
 {
+    // the transform was already updated by a TransformHierarchy for this parent transform
+    uint32_t hierarchyFlags;
+    if (getTransformHierarchyFlags(parentTransform, parentFlags, &hierarchyFlags))
+    {
+        return hierarchyFlags;
+    }
+    
 #if CC_USE_PHYSICS
     if (_physicsBody && _updateTransformFromPhysics)
     {
@@ -1292,6 +1477,7 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
             _position.x = _normalizedPosition.x * s.width;
             _position.y = _normalizedPosition.y * s.height;
             _transformUpdated = _transformDirty = _inverseDirty = true;
+            markParentSubtreeBoundsDirty();
             _normalizedPositionDirty = false;
         }
     }
@@ -1300,9 +1486,13 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     flags |= (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
     flags |= (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
     
-
     if(flags & FLAGS_DIRTY_MASK)
+    {
         _modelViewTransform = this->transform(parentTransform);
+        // a TransformHierarchy holding this node must read its transforms again
+        if (_transformHierarchyPass != 0)
+            _transformHierarchyStale = true;
+    }
     
 #if CC_USE_PHYSICS
     if (_updateTransformFromPhysics) {
@@ -1332,7 +1522,23 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
         return;
     }
 
-    uint32_t flags = processParentFlags(parentTransform, parentFlags);
+    uint32_t flags;
+    if (!getTransformHierarchyFlags(parentTransform, parentFlags, &flags))
+    {
+        flags = processParentFlags(parentTransform, parentFlags);
+    }
+    
+    if (_subtreeCullingEnabled)
+    {
+        // the children of a culled subtree missed the dirty flags of the frames it was culled
+        flags |= _culledFlags;
+        if (!isSubtreeVisibleByVisitingCamera())
+        {
+            _culledFlags = flags & FLAGS_DIRTY_MASK;
+            return;
+        }
+        _culledFlags = 0;
+    }
 
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
@@ -1836,6 +2042,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    markParentSubtreeBoundsDirty();
 }
 
 void Node::setAdditionalTransform(const AffineTransform& additionalTransform)
@@ -1857,6 +2064,7 @@ void Node::setAdditionalTransform(Mat4* additionalTransform)
         _useAdditionalTransform = true;
     }
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markParentSubtreeBoundsDirty();
 }
 
 
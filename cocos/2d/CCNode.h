@@ -35,6 +35,10 @@
 #include "base/CCScriptSupport.h"
 #include "math/CCAffineTransform.h"
 #include "math/CCMath.h"
+#include "3d/CCAABB.h"
+#include "2d/CCTransformHierarchy.h"
+
+#include <atomic>
 
 NS_CC_BEGIN
 
@@ -860,6 +864,8 @@ public:
     /**
      * Sorts the children array once before drawing, instead of every time when a child is added or reordered.
      * This appraoch can improves the performance massively.
+     * Only the children added or reordered since the last sort are sorted, then merged with the others,
+     * so that a few z-order changes among thousands of children stay cheap.
      * @note Don't call this manually unless a child added needs to be removed in the same frame
      */
     virtual void sortAllChildren();
@@ -1092,6 +1098,43 @@ public:
     /** @deprecated Use getBoundingBox instead */
     CC_DEPRECATED(v3) inline virtual Rect boundingBox() const { return getBoundingBox(); }
 
+    /**
+     * Returns the bounds of what the node draws, in its own coordinate system.
+     * By default it is its content rect, nodes drawing something else (e.g. Sprite3D) override it.
+     *
+     * @return An AABB in the node's coordinate system
+     * @since v4.0
+     */
+    virtual AABB getContentAABB() const;
+
+    /**
+     * Enable/Disable skipping the visit of the whole subtree of this node when it is out of the visiting camera's frustum.
+     *
+     * The bounds of the subtree are cached in the coordinate system of this node, and are only recomputed when
+     * a node of the subtree is added, removed, shown, hidden, moved or resized. Moving this node itself, like scrolling
+     * a large map, keeps them. They are the union of the getContentAABB() of the visible nodes of the subtree,
+     * so subtrees with nodes drawing outside of their content size (e.g. DrawNode) should not be culled this way.
+     * Disabled by default.
+     *
+     * @param enabled Whether or not the subtree can be culled
+     * @since v4.0
+     */
+    void setSubtreeCullingEnabled(bool enabled);
+    /**
+     * Returns whether the subtree of this node is culled when it is out of the visiting camera's frustum.
+     *
+     * @since v4.0
+     */
+    bool isSubtreeCullingEnabled() const { return _subtreeCullingEnabled; }
+
+    /**
+     * Returns the bounds of the visible nodes of the subtree, this node included, in the coordinate system of this node.
+     * They are cached when subtree culling is enabled.
+     *
+     * @since v4.0
+     */
+    const AABB& getSubtreeAABB();
+
     virtual void setEventDispatcher(EventDispatcher* dispatcher);
     virtual EventDispatcher* getEventDispatcher() const { return _eventDispatcher; };
 
@@ -1590,6 +1633,27 @@ protected:
     
     /// helper that reorder a child
     void insertChild(Node* child, int z);
+    
+    /// remembers that a child was added or reordered since the last sort
+    void markChildReordered(Node* child)
+    {
+        if (!child->_reorderPending)
+        {
+            child->_reorderPending = true;
+            _reorderedChildren.push_back(child);
+        }
+    }
+    /// marks this node as reordered in its parent, for the setters that change its sort keys
+    void markReorderedInParent()
+    {
+        if (_parent)
+        {
+            _parent->_reorderChildDirty = true;
+            _parent->markChildReordered(this);
+        }
+    }
+    /// sorts _children by moving the children marked as reordered, without allocating
+    void sortReorderedChildren();
 
     /// Removes a child, call child->onExit(), do cleanup, remove it from children array.
     void detachChild(Node *child, ssize_t index, bool doCleanup);
@@ -1599,6 +1663,47 @@ protected:
 
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
+    
+    /// returns true and the flags in flags if _modelViewTransform was already computed by a TransformHierarchy for this visit
+    bool getTransformHierarchyFlags(const Mat4& parentTransform, uint32_t parentFlags, uint32_t* flags)
+    {
+        if (_transformHierarchyPass != TransformHierarchy::getCurrentPass())
+            return false;
+        
+        if (!_transformUpdated && !_contentSizeDirty && (parentFlags & ~_transformHierarchyFlags) == 0 &&
+            (_parent == nullptr || (_parent->_transformHierarchyPass == _transformHierarchyPass && &parentTransform == &_parent->_modelViewTransform)))
+        {
+            *flags = _transformHierarchyFlags;
+            // the next visits in this pass (e.g. by other cameras) see a clean transform, as without the hierarchy
+            _transformHierarchyFlags &= ~FLAGS_DIRTY_MASK;
+            return true;
+        }
+        
+        // updated again, the children can't use their results either
+        _transformHierarchyPass = 0;
+        _transformHierarchyStale = true;
+        return false;
+    }
+    
+    /// marks the cached subtree bounds of this node and its ancestors as outdated.
+    /// may be called concurrently from the jobs of a parallel TransformHierarchy update, hence the atomic flag
+    void markSubtreeBoundsDirty()
+    {
+        for (Node* node = this; node != nullptr && !node->_subtreeBoundsDirty.load(std::memory_order_relaxed); node = node->_parent)
+            node->_subtreeBoundsDirty.store(true, std::memory_order_relaxed);
+    }
+    /// marks the cached subtree bounds of the ancestors as outdated, when the transform of this node changed
+    void markParentSubtreeBoundsDirty()
+    {
+        if (_parent)
+            _parent->markSubtreeBoundsDirty();
+    }
+    /// merges the bounds of the visible subtree of this node, transformed by parentTransform * nodeToParent, into aabb
+    void mergeSubtreeAABB(const Mat4& parentTransform, AABB* aabb);
+    /// merges the bounds of the subtrees of the children, transformed by transform, into aabb
+    virtual void mergeChildrenAABB(const Mat4& transform, AABB* aabb);
+    /// returns false if subtree culling is enabled and the subtree is out of the visiting camera's frustum
+    bool isSubtreeVisibleByVisitingCamera();
 
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
@@ -1660,6 +1765,15 @@ protected:
     mutable Mat4 _additionalTransform; ///< transform
     bool _useAdditionalTransform;   ///< The flag to check whether the additional transform is dirty
     bool _transformUpdated;         ///< Whether or not the Transform object was updated since the last frame
+    
+    unsigned int _transformHierarchyPass; ///< id of the TransformHierarchy update that computed _modelViewTransform, if any
+    uint32_t _transformHierarchyFlags;    ///< flags computed by that update
+    bool _transformHierarchyStale;        ///< _modelViewTransform was updated outside of that update, its copy in the TransformHierarchy must be read again
+    
+    bool _subtreeCullingEnabled;    ///< Whether or not the subtree is skipped when out of the camera's frustum
+    std::atomic<bool> _subtreeBoundsDirty; ///< Whether or not _subtreeAABB must be recomputed
+    AABB _subtreeAABB;              ///< bounds of the visible subtree, in the node's coordinate system
+    uint32_t _culledFlags;          ///< dirty flags the children missed while the subtree was culled
 
     int _localZOrder;               ///< Local order (relative to its siblings) used to sort the node
     float _globalZOrder;            ///< Global order used to sort the node
@@ -1693,6 +1807,8 @@ protected:
                                           ///< Used by Layer and Scene.
 
     bool _reorderChildDirty;          ///< children order dirty flag
+    bool _reorderPending;             ///< whether this node is in the _reorderedChildren of its parent
+    std::vector<Node*> _reorderedChildren; ///< children added or reordered since the last sort, keeps its capacity
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -1733,6 +1849,10 @@ protected:
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
     
+    friend class TransformHierarchy;
+    friend class ProtectedNode;
+    friend class SpriteBatchNode;
+    
 #if CC_USE_PHYSICS
     friend class Layer;
 #endif //CC_USTPS
@@ -55,6 +55,12 @@ THE SOFTWARE.
 #include "renderer/CCTextureCache.h"
 #include "platform/CCFileUtils.h"
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 using namespace std;
 
 
@@ -77,15 +83,293 @@ NS_CC_BEGIN
 //  cocos2d uses a another approach, but the results are almost identical. 
 //
 
+// random number in [-1, 1), cheaper than CCRANDOM_MINUS1_1
+static inline float randomMinus1To1(unsigned int* seed)
+{
+    *seed = *seed * 134775813 + 1;
+    union { uint32_t d; float f; } u;
+    u.d = (((uint32_t)(*seed) & 0x7fff) << 8) | 0x40000000;
+    return u.f - 3.0f;
+}
+
+// 4 wide operations of the update kernels, when the compiler targets SSE or NEON
+#if defined(__SSE__)
+#define CC_PARTICLE_SIMD 1
+typedef __m128 float4;
+static inline float4 load4(const float* p) { return _mm_loadu_ps(p); }
+static inline void store4(float* p, float4 v) { _mm_storeu_ps(p, v); }
+static inline float4 splat4(float f) { return _mm_set1_ps(f); }
+static inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+static inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+static inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+static inline float4 max4(float4 a, float4 b) { return _mm_max_ps(a, b); }
+// 1 / sqrt(x), 0 if x is 0
+static inline float4 rsqrtOrZero4(float4 x)
+{
+    __m128 nonZero = _mm_cmpgt_ps(x, _mm_setzero_ps());
+    return _mm_and_ps(nonZero, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(x)));
+}
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define CC_PARTICLE_SIMD 1
+typedef float32x4_t float4;
+static inline float4 load4(const float* p) { return vld1q_f32(p); }
+static inline void store4(float* p, float4 v) { vst1q_f32(p, v); }
+static inline float4 splat4(float f) { return vdupq_n_f32(f); }
+static inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+static inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+static inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+static inline float4 max4(float4 a, float4 b) { return vmaxq_f32(a, b); }
+// 1 / sqrt(x), 0 if x is 0. The estimate is refined by two Newton-Raphson steps
+static inline float4 rsqrtOrZero4(float4 x)
+{
+    float32x4_t e = vrsqrteq_f32(x);
+    e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(x, e), e));
+    e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(x, e), e));
+    uint32x4_t nonZero = vcgtq_f32(x, vdupq_n_f32(0));
+    return vreinterpretq_f32_u32(vandq_u32(nonZero, vreinterpretq_u32_f32(e)));
+}
+#endif
+
+// the kernels process the particles 4 by 4: the arrays of ParticleData have room for it,
+// the values after the last particle are unused
+static inline int roundUpTo4(int count)
+{
+    return (count + 3) & ~3;
+}
+
+// x += c
+static void addConstant(float* x, float c, int count)
+{
+#if CC_PARTICLE_SIMD
+    float4 c4 = splat4(c);
+    for (int i = 0; i < count; i += 4)
+    {
+        store4(x + i, add4(load4(x + i), c4));
+    }
+#else
+    for (int i = 0; i < count; ++i)
+    {
+        x[i] += c;
+    }
+#endif
+}
+
+// x += dx * dt
+static void addScaled(float* x, const float* dx, float dt, int count)
+{
+#if CC_PARTICLE_SIMD
+    float4 dt4 = splat4(dt);
+    for (int i = 0; i < count; i += 4)
+    {
+        store4(x + i, add4(load4(x + i), mul4(load4(dx + i), dt4)));
+    }
+#else
+    for (int i = 0; i < count; ++i)
+    {
+        x[i] += dx[i] * dt;
+    }
+#endif
+}
+
+// x = max(0, x + dx * dt)
+static void addScaledPositive(float* x, const float* dx, float dt, int count)
+{
+#if CC_PARTICLE_SIMD
+    float4 dt4 = splat4(dt);
+    float4 zero = splat4(0);
+    for (int i = 0; i < count; i += 4)
+    {
+        store4(x + i, max4(zero, add4(load4(x + i), mul4(load4(dx + i), dt4))));
+    }
+#else
+    for (int i = 0; i < count; ++i)
+    {
+        x[i] = MAX(0, x[i] + dx[i] * dt);
+    }
+#endif
+}
+
+// (gravity + radial + tangential) accelerations, then move
+static void updateGravityMode(ParticleData& data, int count, const Vec2& gravity, float dt, float yCoordFlipped)
+{
+#if CC_PARTICLE_SIMD
+    float4 dt4 = splat4(dt);
+    float4 moveDt4 = splat4(dt * yCoordFlipped);
+    float4 gravityX = splat4(gravity.x);
+    float4 gravityY = splat4(gravity.y);
+    for (int i = 0; i < count; i += 4)
+    {
+        float4 x = load4(data.posx + i);
+        float4 y = load4(data.posy + i);
+        
+        // radial acceleration along the normalized position, tangential one perpendicular to it
+        float4 invLength = rsqrtOrZero4(add4(mul4(x, x), mul4(y, y)));
+        float4 normalX = mul4(x, invLength);
+        float4 normalY = mul4(y, invLength);
+        float4 radialAccel = load4(data.modeA.radialAccel + i);
+        float4 tangentialAccel = load4(data.modeA.tangentialAccel + i);
+        float4 accelX = add4(sub4(mul4(normalX, radialAccel), mul4(normalY, tangentialAccel)), gravityX);
+        float4 accelY = add4(add4(mul4(normalY, radialAccel), mul4(normalX, tangentialAccel)), gravityY);
+        
+        float4 dirX = add4(load4(data.modeA.dirX + i), mul4(accelX, dt4));
+        float4 dirY = add4(load4(data.modeA.dirY + i), mul4(accelY, dt4));
+        store4(data.modeA.dirX + i, dirX);
+        store4(data.modeA.dirY + i, dirY);
+        
+        store4(data.posx + i, add4(x, mul4(dirX, moveDt4)));
+        store4(data.posy + i, add4(y, mul4(dirY, moveDt4)));
+    }
+#else
+    for (int i = 0; i < count; ++i)
+    {
+        float x = data.posx[i];
+        float y = data.posy[i];
+        
+        // radial acceleration along the normalized position, tangential one perpendicular to it
+        float normalX = 0, normalY = 0;
+        if (x || y)
+        {
+            float invLength = 1.0f / sqrtf(x * x + y * y);
+            normalX = x * invLength;
+            normalY = y * invLength;
+        }
+        float radialAccel = data.modeA.radialAccel[i];
+        float tangentialAccel = data.modeA.tangentialAccel[i];
+        float accelX = normalX * radialAccel - normalY * tangentialAccel + gravity.x;
+        float accelY = normalY * radialAccel + normalX * tangentialAccel + gravity.y;
+        
+        data.modeA.dirX[i] += accelX * dt;
+        data.modeA.dirY[i] += accelY * dt;
+        
+        data.posx[i] = x + data.modeA.dirX[i] * dt * yCoordFlipped;
+        data.posy[i] = y + data.modeA.dirY[i] * dt * yCoordFlipped;
+    }
+#endif
+}
+
+// time step of fastForward() when the particles can't be advanced analytically
+static const float FAST_FORWARD_STEP = 1.0f / 30;
+
+// ParticleData
+
+// number of float arrays, atlasIndex excluded
+static const int PARTICLE_DATA_FLOAT_ARRAYS = 25;
+
+ParticleData::ParticleData()
+: maxCount(0)
+, _buffer(nullptr)
+{
+    memset(&modeA, 0, sizeof(modeA));
+    memset(&modeB, 0, sizeof(modeB));
+    posx = posy = startPosX = startPosY = nullptr;
+    colorR = colorG = colorB = colorA = nullptr;
+    deltaColorR = deltaColorG = deltaColorB = deltaColorA = nullptr;
+    size = deltaSize = rotation = deltaRotation = timeToLive = nullptr;
+    atlasIndex = nullptr;
+}
+
+ParticleData::~ParticleData()
+{
+    release();
+}
+
+bool ParticleData::init(int count)
+{
+    int capacity = roundUpTo4(MAX(count, 1));
+    void* buffer = calloc((PARTICLE_DATA_FLOAT_ARRAYS + 1) * capacity, sizeof(float));
+    if (!buffer)
+    {
+        return false;
+    }
+    
+    // keeps the values of the particles, as a realloc would
+    float* arrays = (float*)buffer;
+    float* oldArrays = (float*)_buffer;
+    int copied = MIN(capacity, (int)maxCount);
+    for (int i = 0; oldArrays && i < PARTICLE_DATA_FLOAT_ARRAYS; ++i)
+    {
+        memcpy(arrays + i * capacity, oldArrays + i * maxCount, copied * sizeof(float));
+    }
+    unsigned int* newAtlasIndex = (unsigned int*)(arrays + PARTICLE_DATA_FLOAT_ARRAYS * capacity);
+    if (oldArrays)
+    {
+        memcpy(newAtlasIndex, atlasIndex, copied * sizeof(unsigned int));
+    }
+    release();
+    
+    _buffer = buffer;
+    maxCount = capacity;
+    
+    float** floatArrays[PARTICLE_DATA_FLOAT_ARRAYS] = {
+        &posx, &posy, &startPosX, &startPosY,
+        &colorR, &colorG, &colorB, &colorA,
+        &deltaColorR, &deltaColorG, &deltaColorB, &deltaColorA,
+        &size, &deltaSize, &rotation, &deltaRotation, &timeToLive,
+        &modeA.dirX, &modeA.dirY, &modeA.radialAccel, &modeA.tangentialAccel,
+        &modeB.angle, &modeB.degreesPerSecond, &modeB.radius, &modeB.deltaRadius,
+    };
+    for (int i = 0; i < PARTICLE_DATA_FLOAT_ARRAYS; ++i)
+    {
+        *floatArrays[i] = arrays + i * capacity;
+    }
+    atlasIndex = newAtlasIndex;
+    
+    return true;
+}
+
+void ParticleData::release()
+{
+    CC_SAFE_FREE(_buffer);
+    maxCount = 0;
+}
+
+void ParticleData::copyParticle(int p1, int p2)
+{
+    posx[p1] = posx[p2];
+    posy[p1] = posy[p2];
+    startPosX[p1] = startPosX[p2];
+    startPosY[p1] = startPosY[p2];
+    
+    colorR[p1] = colorR[p2];
+    colorG[p1] = colorG[p2];
+    colorB[p1] = colorB[p2];
+    colorA[p1] = colorA[p2];
+    
+    deltaColorR[p1] = deltaColorR[p2];
+    deltaColorG[p1] = deltaColorG[p2];
+    deltaColorB[p1] = deltaColorB[p2];
+    deltaColorA[p1] = deltaColorA[p2];
+    
+    size[p1] = size[p2];
+    deltaSize[p1] = deltaSize[p2];
+    rotation[p1] = rotation[p2];
+    deltaRotation[p1] = deltaRotation[p2];
+    timeToLive[p1] = timeToLive[p2];
+    atlasIndex[p1] = atlasIndex[p2];
+    
+    modeA.dirX[p1] = modeA.dirX[p2];
+    modeA.dirY[p1] = modeA.dirY[p2];
+    modeA.radialAccel[p1] = modeA.radialAccel[p2];
+    modeA.tangentialAccel[p1] = modeA.tangentialAccel[p2];
+    
+    modeB.angle[p1] = modeB.angle[p2];
+    modeB.degreesPerSecond[p1] = modeB.degreesPerSecond[p2];
+    modeB.radius[p1] = modeB.radius[p2];
+    modeB.deltaRadius[p1] = modeB.deltaRadius[p2];
+}
+
 ParticleSystem::ParticleSystem()
 : _isBlendAdditive(false)
 , _isAutoRemoveOnFinish(false)
 , _plistFile("")
 , _elapsed(0)
-, _particles(nullptr)
 , _configName("")
 , _emitCounter(0)
-, _particleIdx(0)
+, _randomSeed(0)
+, _initialRandomSeed(0)
+, _isUpdateDeferred(false)
+, _deferredUpdateDt(0)
+, _isFinished(false)
 , _batchNode(nullptr)
 , _atlasIndex(0)
 , _allocatedParticles(0)
@@ -129,6 +413,7 @@ ParticleSystem::ParticleSystem()
     modeB.endRadiusVar = 0;            
     modeB.rotatePerSecond = 0;
     modeB.rotatePerSecondVar = 0;
+    memset(_quadPositionTransform, 0, sizeof(_quadPositionTransform));
 }
 
 // implementation ParticleSystem
@@ -405,11 +690,7 @@ bool ParticleSystem::initWithTotalParticles(int numberOfParticles)
 {
     _totalParticles = numberOfParticles;
 
-    CC_SAFE_FREE(_particles);
-    
-    _particles = (tParticle*)calloc(_totalParticles, sizeof(tParticle));
-
-    if( ! _particles )
+    if( ! _particleData.init(_totalParticles) )
     {
         CCLOG("Particle system: not enough memory");
         this->release();
@@ -421,9 +702,12 @@ bool ParticleSystem::initWithTotalParticles(int numberOfParticles)
     {
         for (int i = 0; i < _totalParticles; i++)
         {
-            _particles[i].atlasIndex=i;
+            _particleData.atlasIndex[i] = i;
         }
     }
+    
+    _randomSeed = (unsigned int)rand();
+    _initialRandomSeed = _randomSeed;
     // default, active
     _isActive = true;
 
@@ -442,10 +726,6 @@ bool ParticleSystem::initWithTotalParticles(int numberOfParticles)
 
     _isAutoRemoveOnFinish = false;
 
-    // Optimization: compile updateParticle method
-    //updateParticleSel = @selector(updateQuadWithParticle:newPosition:);
-    //updateParticleImp = (CC_UPDATE_PARTICLE_IMP) [self methodForSelector:updateParticleSel];
-
     return true;
 }
 
@@ -454,7 +734,7 @@ ParticleSystem::~ParticleSystem()
     // Since the scheduler retains the "target (in this case the ParticleSystem)
 	// it is not needed to call "unscheduleUpdate" here. In fact, it will be called in "cleanup"
     //unscheduleUpdate();
-    CC_SAFE_FREE(_particles);
+    _particleData.release();
     CC_SAFE_RELEASE(_texture);
 }
 
@@ -465,123 +745,159 @@ bool ParticleSystem::addParticle()
         return false;
     }
 
-    tParticle * particle = &_particles[ _particleCount ];
-    this->initParticle(particle);
-    ++_particleCount;
+    addParticles(1);
 
     return true;
 }
 
-void ParticleSystem::initParticle(tParticle* particle)
+void ParticleSystem::addParticles(int count)
 {
+    count = MIN(count, _totalParticles - _particleCount);
+    if (count <= 0)
+    {
+        return;
+    }
+    
+    int start = _particleCount;
+    int end = _particleCount + count;
+    unsigned int seed = _randomSeed;
+    
     // timeToLive
     // no negative life. prevent division by 0
-    particle->timeToLive = _life + _lifeVar * CCRANDOM_MINUS1_1();
-    particle->timeToLive = MAX(0, particle->timeToLive);
+    for (int i = start; i < end; ++i)
+    {
+        float timeToLive = _life + _lifeVar * randomMinus1To1(&seed);
+        _particleData.timeToLive[i] = MAX(0, timeToLive);
+    }
 
     // position
-    particle->pos.x = _sourcePosition.x + _posVar.x * CCRANDOM_MINUS1_1();
-
-    particle->pos.y = _sourcePosition.y + _posVar.y * CCRANDOM_MINUS1_1();
-
+    for (int i = start; i < end; ++i)
+    {
+        _particleData.posx[i] = _sourcePosition.x + _posVar.x * randomMinus1To1(&seed);
+        _particleData.posy[i] = _sourcePosition.y + _posVar.y * randomMinus1To1(&seed);
+    }
 
     // Color
-    Color4F start;
-    start.r = clampf(_startColor.r + _startColorVar.r * CCRANDOM_MINUS1_1(), 0, 1);
-    start.g = clampf(_startColor.g + _startColorVar.g * CCRANDOM_MINUS1_1(), 0, 1);
-    start.b = clampf(_startColor.b + _startColorVar.b * CCRANDOM_MINUS1_1(), 0, 1);
-    start.a = clampf(_startColor.a + _startColorVar.a * CCRANDOM_MINUS1_1(), 0, 1);
-
-    Color4F end;
-    end.r = clampf(_endColor.r + _endColorVar.r * CCRANDOM_MINUS1_1(), 0, 1);
-    end.g = clampf(_endColor.g + _endColorVar.g * CCRANDOM_MINUS1_1(), 0, 1);
-    end.b = clampf(_endColor.b + _endColorVar.b * CCRANDOM_MINUS1_1(), 0, 1);
-    end.a = clampf(_endColor.a + _endColorVar.a * CCRANDOM_MINUS1_1(), 0, 1);
-
-    particle->color = start;
-    particle->deltaColor.r = (end.r - start.r) / particle->timeToLive;
-    particle->deltaColor.g = (end.g - start.g) / particle->timeToLive;
-    particle->deltaColor.b = (end.b - start.b) / particle->timeToLive;
-    particle->deltaColor.a = (end.a - start.a) / particle->timeToLive;
-
-    // size
-    float startS = _startSize + _startSizeVar * CCRANDOM_MINUS1_1();
-    startS = MAX(0, startS); // No negative value
-
-    particle->size = startS;
-
-    if (_endSize == START_SIZE_EQUAL_TO_END_SIZE)
+    for (int i = start; i < end; ++i)
     {
-        particle->deltaSize = 0;
+        float timeToLive = _particleData.timeToLive[i];
+        
+        float startR = clampf(_startColor.r + _startColorVar.r * randomMinus1To1(&seed), 0, 1);
+        float startG = clampf(_startColor.g + _startColorVar.g * randomMinus1To1(&seed), 0, 1);
+        float startB = clampf(_startColor.b + _startColorVar.b * randomMinus1To1(&seed), 0, 1);
+        float startA = clampf(_startColor.a + _startColorVar.a * randomMinus1To1(&seed), 0, 1);
+        
+        float endR = clampf(_endColor.r + _endColorVar.r * randomMinus1To1(&seed), 0, 1);
+        float endG = clampf(_endColor.g + _endColorVar.g * randomMinus1To1(&seed), 0, 1);
+        float endB = clampf(_endColor.b + _endColorVar.b * randomMinus1To1(&seed), 0, 1);
+        float endA = clampf(_endColor.a + _endColorVar.a * randomMinus1To1(&seed), 0, 1);
+        
+        _particleData.colorR[i] = startR;
+        _particleData.colorG[i] = startG;
+        _particleData.colorB[i] = startB;
+        _particleData.colorA[i] = startA;
+        _particleData.deltaColorR[i] = (endR - startR) / timeToLive;
+        _particleData.deltaColorG[i] = (endG - startG) / timeToLive;
+        _particleData.deltaColorB[i] = (endB - startB) / timeToLive;
+        _particleData.deltaColorA[i] = (endA - startA) / timeToLive;
     }
-    else
+
+    // size
+    for (int i = start; i < end; ++i)
     {
-        float endS = _endSize + _endSizeVar * CCRANDOM_MINUS1_1();
-        endS = MAX(0, endS); // No negative values
-        particle->deltaSize = (endS - startS) / particle->timeToLive;
+        float startS = _startSize + _startSizeVar * randomMinus1To1(&seed);
+        startS = MAX(0, startS); // No negative value
+        _particleData.size[i] = startS;
+        
+        if (_endSize == START_SIZE_EQUAL_TO_END_SIZE)
+        {
+            _particleData.deltaSize[i] = 0;
+        }
+        else
+        {
+            float endS = _endSize + _endSizeVar * randomMinus1To1(&seed);
+            endS = MAX(0, endS); // No negative values
+            _particleData.deltaSize[i] = (endS - startS) / _particleData.timeToLive[i];
+        }
     }
 
     // rotation
-    float startA = _startSpin + _startSpinVar * CCRANDOM_MINUS1_1();
-    float endA = _endSpin + _endSpinVar * CCRANDOM_MINUS1_1();
-    particle->rotation = startA;
-    particle->deltaRotation = (endA - startA) / particle->timeToLive;
+    for (int i = start; i < end; ++i)
+    {
+        float startA = _startSpin + _startSpinVar * randomMinus1To1(&seed);
+        float endA = _endSpin + _endSpinVar * randomMinus1To1(&seed);
+        _particleData.rotation[i] = startA;
+        _particleData.deltaRotation[i] = (endA - startA) / _particleData.timeToLive[i];
+    }
 
     // position
+    Vec2 startPosition = Vec2::ZERO;
     if (_positionType == PositionType::FREE)
     {
-        particle->startPos = this->convertToWorldSpace(Vec2::ZERO);
+        startPosition = this->convertToWorldSpace(Vec2::ZERO);
     }
     else if (_positionType == PositionType::RELATIVE)
     {
-        particle->startPos = _position;
+        startPosition = _position;
+    }
+    for (int i = start; i < end; ++i)
+    {
+        _particleData.startPosX[i] = startPosition.x;
+        _particleData.startPosY[i] = startPosition.y;
     }
-
-    // direction
-    float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * CCRANDOM_MINUS1_1() );    
 
     // Mode Gravity: A
     if (_emitterMode == Mode::GRAVITY)
     {
-        Vec2 v(cosf( a ), sinf( a ));
-        float s = modeA.speed + modeA.speedVar * CCRANDOM_MINUS1_1();
-
-        // direction
-        particle->modeA.dir = v * s ;
-
-        // radial accel
-        particle->modeA.radialAccel = modeA.radialAccel + modeA.radialAccelVar * CCRANDOM_MINUS1_1();
- 
-
-        // tangential accel
-        particle->modeA.tangentialAccel = modeA.tangentialAccel + modeA.tangentialAccelVar * CCRANDOM_MINUS1_1();
-
-        // rotation is dir
-        if(modeA.rotationIsDir)
-            particle->rotation = -CC_RADIANS_TO_DEGREES(particle->modeA.dir.getAngle());
+        for (int i = start; i < end; ++i)
+        {
+            // direction
+            float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * randomMinus1To1(&seed) );
+            float s = modeA.speed + modeA.speedVar * randomMinus1To1(&seed);
+            _particleData.modeA.dirX[i] = cosf(a) * s;
+            _particleData.modeA.dirY[i] = sinf(a) * s;
+            
+            // radial accel
+            _particleData.modeA.radialAccel[i] = modeA.radialAccel + modeA.radialAccelVar * randomMinus1To1(&seed);
+            
+            // tangential accel
+            _particleData.modeA.tangentialAccel[i] = modeA.tangentialAccel + modeA.tangentialAccelVar * randomMinus1To1(&seed);
+            
+            // rotation is dir
+            if (modeA.rotationIsDir)
+            {
+                _particleData.rotation[i] = -CC_RADIANS_TO_DEGREES(atan2f(_particleData.modeA.dirY[i], _particleData.modeA.dirX[i]));
+            }
+        }
     }
 
     // Mode Radius: B
-    else 
+    else
     {
-        // Set the default diameter of the particle from the source position
-        float startRadius = modeB.startRadius + modeB.startRadiusVar * CCRANDOM_MINUS1_1();
-        float endRadius = modeB.endRadius + modeB.endRadiusVar * CCRANDOM_MINUS1_1();
-
-        particle->modeB.radius = startRadius;
-
-        if (modeB.endRadius == START_RADIUS_EQUAL_TO_END_RADIUS)
-        {
-            particle->modeB.deltaRadius = 0;
-        }
-        else
+        for (int i = start; i < end; ++i)
         {
-            particle->modeB.deltaRadius = (endRadius - startRadius) / particle->timeToLive;
+            // Set the default diameter of the particle from the source position
+            float startRadius = modeB.startRadius + modeB.startRadiusVar * randomMinus1To1(&seed);
+            float endRadius = modeB.endRadius + modeB.endRadiusVar * randomMinus1To1(&seed);
+            
+            _particleData.modeB.radius[i] = startRadius;
+            
+            if (modeB.endRadius == START_RADIUS_EQUAL_TO_END_RADIUS)
+            {
+                _particleData.modeB.deltaRadius[i] = 0;
+            }
+            else
+            {
+                _particleData.modeB.deltaRadius[i] = (endRadius - startRadius) / _particleData.timeToLive[i];
+            }
+            
+            _particleData.modeB.angle[i] = CC_DEGREES_TO_RADIANS( _angle + _angleVar * randomMinus1To1(&seed) );
+            _particleData.modeB.degreesPerSecond[i] = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * randomMinus1To1(&seed));
         }
-
-        particle->modeB.angle = a;
-        particle->modeB.degreesPerSecond = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * CCRANDOM_MINUS1_1());
-    }    
+    }
+    
+    _randomSeed = seed;
+    _particleCount = end;
 }
 
 void ParticleSystem::onEnter()
@@ -617,10 +933,11 @@ void ParticleSystem::resetSystem()
 {
     _isActive = true;
     _elapsed = 0;
-    for (_particleIdx = 0; _particleIdx < _particleCount; ++_particleIdx)
+    // a removal left pending by fastForward() is cancelled, the system runs again
+    _isFinished = false;
+    for (int i = 0; i < _particleCount; ++i)
     {
-        tParticle *p = &_particles[_particleIdx];
-        p->timeToLive = 0;
+        _particleData.timeToLive[i] = 0;
     }
 }
 bool ParticleSystem::isFull()
@@ -633,6 +950,38 @@ void ParticleSystem::update(float dt)
 {
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    if (_isUpdateDeferred)
+    {
+        // updated twice in the same frame: the deferred update is done first
+        simulate(_deferredUpdateDt);
+    }
+
+    updateEmitter(dt);
+    updateQuadPositionTransform();
+
+    // batched systems write to the atlas of their batch node, they are always updated here
+    auto director = Director::getInstance();
+    if (!_isUpdateDeferred && director->isParallelParticleUpdateEnabled() && !_batchNode)
+    {
+        director->deferParticleSystemUpdate(this);
+        _isUpdateDeferred = true;
+    }
+
+    if (_isUpdateDeferred)
+    {
+        _deferredUpdateDt = dt;
+    }
+    else
+    {
+        simulate(dt);
+        finishUpdate();
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+void ParticleSystem::updateEmitter(float dt)
+{
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
@@ -642,10 +991,11 @@ void ParticleSystem::update(float dt)
             _emitCounter += dt;
         }
         
-        while (_particleCount < _totalParticles && _emitCounter > rate)
+        int emitCount = MIN(_totalParticles - _particleCount, (int)(_emitCounter / rate));
+        if (emitCount > 0)
         {
-            this->addParticle();
-            _emitCounter -= rate;
+            this->addParticles(emitCount);
+            _emitCounter -= rate * emitCount;
         }
         
         _elapsed += dt;
@@ -654,162 +1004,272 @@ void ParticleSystem::update(float dt)
             this->stopSystem();
         }
     }
+}
 
-    _particleIdx = 0;
+void ParticleSystem::simulate(float dt)
+{
+    int particleCount = _particleCount;
+    updateParticles(dt);
 
-    Vec2 currentPosition = Vec2::ZERO;
-    if (_positionType == PositionType::FREE)
+    if (particleCount > 0 && _particleCount == 0 && _isAutoRemoveOnFinish)
     {
-        currentPosition = this->convertToWorldSpace(Vec2::ZERO);
+        _isFinished = true;
+        return;
     }
-    else if (_positionType == PositionType::RELATIVE)
+
+    // the quads of a batched system are drawn by the batch node, even if the system isn't visible
+    if (_visible || _batchNode)
     {
-        currentPosition = _position;
+        updateParticleQuads();
     }
+}
 
+void ParticleSystem::finishUpdate()
+{
+    if (_isFinished)
     {
-        Mat4 worldToNodeTM = getWorldToNodeTransform();
-        
-        while (_particleIdx < _particleCount)
+        _isFinished = false;
+        this->unscheduleUpdate();
+        // a deferred update may complete after the system was removed
+        if (_parent)
         {
-            tParticle *p = &_particles[_particleIdx];
-
-            // life
-            p->timeToLive -= dt;
-
-            if (p->timeToLive > 0) 
-            {
-                // Mode A: gravity, direction, tangential accel & radial accel
-                if (_emitterMode == Mode::GRAVITY)
-                {
-                    Vec2 tmp, radial, tangential;
-
-                    radial = Vec2::ZERO;
-                    // radial acceleration
-                    if (p->pos.x || p->pos.y)
-                    {
-                        radial = p->pos.getNormalized();
-                    }
-                    tangential = radial;
-                    radial = radial * p->modeA.radialAccel;
-
-                    // tangential acceleration
-                    float newy = tangential.x;
-                    tangential.x = -tangential.y;
-                    tangential.y = newy;
-                    tangential = tangential * p->modeA.tangentialAccel;
-
-                    // (gravity + radial + tangential) * dt
-                    tmp = radial + tangential + modeA.gravity;
-                    tmp = tmp * dt;
-                    p->modeA.dir = p->modeA.dir + tmp;
-                    
-                    // this is cocos2d-x v3.0
-//                    if (_configName.length()>0 && _yCoordFlipped != -1)
-
-                    // this is cocos2d-x v3.0
-                    tmp = p->modeA.dir * dt * _yCoordFlipped;
-                    p->pos = p->pos + tmp;
-                }
-
-                // Mode B: radius movement
-                else 
-                {                
-                    // Update the angle and radius of the particle.
-                    p->modeB.angle += p->modeB.degreesPerSecond * dt;
-                    p->modeB.radius += p->modeB.deltaRadius * dt;
-
-                    p->pos.x = - cosf(p->modeB.angle) * p->modeB.radius;
-                    p->pos.y = - sinf(p->modeB.angle) * p->modeB.radius;
-                    p->pos.y *= _yCoordFlipped;
-				}
-
-                // color
-                p->color.r += (p->deltaColor.r * dt);
-                p->color.g += (p->deltaColor.g * dt);
-                p->color.b += (p->deltaColor.b * dt);
-                p->color.a += (p->deltaColor.a * dt);
-
-                // size
-                p->size += (p->deltaSize * dt);
-                p->size = MAX( 0, p->size );
-
-                // angle
-                p->rotation += (p->deltaRotation * dt);
+            _parent->removeChild(this, true);
+        }
+        return;
+    }
 
-                //
-                // update values in quad
-                //
+    // only update gl buffer when visible
+    if (_visible && ! _batchNode)
+    {
+        postStep();
+    }
+}
 
-                Vec2    newPos;
+void ParticleSystem::removeDeadParticles()
+{
+    for (int i = 0; i < _particleCount; )
+    {
+        if (_particleData.timeToLive[i] > 0)
+        {
+            ++i;
+            continue;
+        }
+        
+        // life < 0
+        int currentIndex = _particleData.atlasIndex[i];
+        if (i != _particleCount - 1)
+        {
+            _particleData.copyParticle(i, _particleCount - 1);
+        }
+        if (_batchNode)
+        {
+            //disable the switched particle
+            _batchNode->disableParticle(_atlasIndex + currentIndex);
+            
+            //switch indexes
+            _particleData.atlasIndex[_particleCount - 1] = currentIndex;
+        }
+        --_particleCount;
+    }
+}
 
-                if (_positionType == PositionType::FREE)
-                {
-                    Vec3 p1(currentPosition.x,currentPosition.y,0),p2(p->startPos.x,p->startPos.y,0);
-                    worldToNodeTM.transformPoint(&p1);
-                    worldToNodeTM.transformPoint(&p2);
-                    p1 = p1 - p2;
-                    newPos = p->pos - Vec2(p1.x,p1.y);
-                }
-                else if(_positionType == PositionType::RELATIVE)
-                {
-                    Vec2 diff = currentPosition - p->startPos;
-                    newPos = p->pos - diff;
-                } 
-                else
-                {
-                    newPos = p->pos;
-                }
+void ParticleSystem::updateParticles(float dt)
+{
+    // life
+    addConstant(_particleData.timeToLive, -dt, _particleCount);
+    
+    removeDeadParticles();
+    
+    if (_particleCount == 0)
+    {
+        return;
+    }
+    
+    // Mode A: gravity, direction, tangential accel & radial accel
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        updateGravityMode(_particleData, _particleCount, modeA.gravity, dt, (float)_yCoordFlipped);
+    }
+    // Mode B: radius movement
+    else
+    {
+        // Update the angle and radius of the particle.
+        addScaled(_particleData.modeB.angle, _particleData.modeB.degreesPerSecond, dt, _particleCount);
+        addScaled(_particleData.modeB.radius, _particleData.modeB.deltaRadius, dt, _particleCount);
+        
+        for (int i = 0; i < _particleCount; ++i)
+        {
+            _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
+            _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
+        }
+    }
+    
+    // color
+    addScaled(_particleData.colorR, _particleData.deltaColorR, dt, _particleCount);
+    addScaled(_particleData.colorG, _particleData.deltaColorG, dt, _particleCount);
+    addScaled(_particleData.colorB, _particleData.deltaColorB, dt, _particleCount);
+    addScaled(_particleData.colorA, _particleData.deltaColorA, dt, _particleCount);
+    
+    // size
+    addScaledPositive(_particleData.size, _particleData.deltaSize, dt, _particleCount);
+    
+    // angle
+    addScaled(_particleData.rotation, _particleData.deltaRotation, dt, _particleCount);
+}
 
-                // translate newPos to correct position, since matrix transform isn't performed in batchnode
-                // don't update the particle with the new position information, it will interfere with the radius and tangential calculations
-                if (_batchNode)
-                {
-                    newPos.x+=_position.x;
-                    newPos.y+=_position.y;
-                }
+void ParticleSystem::updateQuadPositionTransform()
+{
+    float* transform = _quadPositionTransform;
+    if (_positionType == PositionType::FREE)
+    {
+        // the particles are moved by the move of the emitter since their start, in node space:
+        // the translation of the world to node transform cancels out
+        Vec2 currentPosition = this->convertToWorldSpace(Vec2::ZERO);
+        Mat4 worldToNodeTM = getWorldToNodeTransform();
+        transform[0] = worldToNodeTM.m[0];
+        transform[1] = worldToNodeTM.m[1];
+        transform[2] = worldToNodeTM.m[4];
+        transform[3] = worldToNodeTM.m[5];
+        _quadPositionOffset.x = -(transform[0] * currentPosition.x + transform[2] * currentPosition.y);
+        _quadPositionOffset.y = -(transform[1] * currentPosition.x + transform[3] * currentPosition.y);
+    }
+    else if (_positionType == PositionType::RELATIVE)
+    {
+        transform[0] = transform[3] = 1;
+        transform[1] = transform[2] = 0;
+        _quadPositionOffset = -_position;
+    }
+    else
+    {
+        transform[0] = transform[1] = transform[2] = transform[3] = 0;
+        _quadPositionOffset = Vec2::ZERO;
+    }
+    
+    // translate newPos to correct position, since matrix transform isn't performed in batchnode
+    if (_batchNode)
+    {
+        _quadPositionOffset += _position;
+    }
+}
 
-                updateQuadWithParticle(p, newPos);
+void ParticleSystem::prewarm(float seconds)
+{
+    resetSystem();
+    // the particles killed by resetSystem() are removed, so that they don't hold slots during the simulation
+    removeDeadParticles();
+    _randomSeed = _initialRandomSeed;
+    _emitCounter = 0;
+    fastForward(seconds);
+}
 
-                // update particle counter
-                ++_particleIdx;
-            } 
-            else 
+void ParticleSystem::fastForward(float seconds)
+{
+    if (_isUpdateDeferred)
+    {
+        // the deferred update of the frame is done first
+        simulate(_deferredUpdateDt);
+        _deferredUpdateDt = 0;
+    }
+    
+    // without radial and tangential accelerations, the trajectories of the particles have a closed form:
+    // they can be advanced by large steps, which only delay the reuse of the particles that died during a step
+    bool analytic = _emitterMode == Mode::RADIUS
+        || (modeA.radialAccel == 0 && modeA.radialAccelVar == 0 && modeA.tangentialAccel == 0 && modeA.tangentialAccelVar == 0);
+    float step = FAST_FORWARD_STEP;
+    if (analytic)
+    {
+        step = MAX(step, (_life - _lifeVar) / 4);
+    }
+    
+    while (seconds > 0)
+    {
+        float dt = MIN(step, seconds);
+        seconds -= dt;
+        
+        if (analytic)
+        {
+            advanceParticles(0, _particleCount, dt);
+            removeDeadParticles();
+            
+            // the particles emitted during the step are spread over it
+            int first = _particleCount;
+            updateEmitter(dt);
+            int emitted = _particleCount - first;
+            for (int i = 0; i < emitted; ++i)
             {
-                // life < 0
-                int currentIndex = p->atlasIndex;
-                if( _particleIdx != _particleCount-1 )
-                {
-                    _particles[_particleIdx] = _particles[_particleCount-1];
-                }
-                if (_batchNode)
-                {
-                    //disable the switched particle
-                    _batchNode->disableParticle(_atlasIndex+currentIndex);
-
-                    //switch indexes
-                    _particles[_particleCount-1].atlasIndex = currentIndex;
-                }
-
-                --_particleCount;
-
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
+                advanceParticles(first + i, first + i + 1, dt * (i + 0.5f) / emitted);
             }
-        } //while
+        }
+        else
+        {
+            updateEmitter(dt);
+            updateParticles(dt);
+        }
     }
+    removeDeadParticles();
     
-    // only update gl buffer when visible
+    // the system ended during the simulation: it is removed like in update(),
+    // or at its next update if it has no parent yet or its update of the frame is deferred
+    if (_isAutoRemoveOnFinish && !_isActive && _particleCount == 0)
+    {
+        _isFinished = true;
+        if (_parent && !_isUpdateDeferred)
+        {
+            finishUpdate();
+            return;
+        }
+    }
+    
+    // the quads are only generated for the final state
+    updateQuadPositionTransform();
+    if (_visible || _batchNode)
+    {
+        updateParticleQuads();
+    }
     if (_visible && ! _batchNode)
     {
         postStep();
     }
+}
 
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+void ParticleSystem::advanceParticles(int begin, int end, float time)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        _particleData.timeToLive[i] -= time;
+        
+        _particleData.colorR[i] += _particleData.deltaColorR[i] * time;
+        _particleData.colorG[i] += _particleData.deltaColorG[i] * time;
+        _particleData.colorB[i] += _particleData.deltaColorB[i] * time;
+        _particleData.colorA[i] += _particleData.deltaColorA[i] * time;
+        
+        _particleData.size[i] = MAX(0, _particleData.size[i] + _particleData.deltaSize[i] * time);
+        _particleData.rotation[i] += _particleData.deltaRotation[i] * time;
+    }
+    
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        // constant acceleration
+        const Vec2& gravity = modeA.gravity;
+        float halfTimeSquared = 0.5f * time * time;
+        for (int i = begin; i < end; ++i)
+        {
+            _particleData.posx[i] += (_particleData.modeA.dirX[i] * time + gravity.x * halfTimeSquared) * _yCoordFlipped;
+            _particleData.posy[i] += (_particleData.modeA.dirY[i] * time + gravity.y * halfTimeSquared) * _yCoordFlipped;
+            _particleData.modeA.dirX[i] += gravity.x * time;
+            _particleData.modeA.dirY[i] += gravity.y * time;
+        }
+    }
+    else
+    {
+        for (int i = begin; i < end; ++i)
+        {
+            _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * time;
+            _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * time;
+            _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
+            _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
+        }
+    }
 }
 
 void ParticleSystem::updateWithNoTime(void)
@@ -1106,7 +1566,7 @@ void ParticleSystem::setBatchNode(ParticleBatchNode* batchNode)
             //each particle needs a unique index
             for (int i = 0; i < _totalParticles; i++)
             {
-                _particles[i].atlasIndex=i;
+                _particleData.atlasIndex[i] = i;
             }
         }
     }
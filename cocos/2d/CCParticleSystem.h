@@ -41,43 +41,69 @@ NS_CC_BEGIN
 class ParticleBatchNode;
 
 /**
-Structure that contains the values of each particle
+Structure of arrays that contains the values of the particles.
+The arrays of a system are allocated in a single block, their capacity is rounded up to a multiple of 4
+so that the update kernels can process 4 particles at once.
+@since v4.0
 */
-typedef struct sParticle {
-    Vec2     pos;
-    Vec2     startPos;
-
-    Color4F    color;
-    Color4F    deltaColor;
-
-    float        size;
-    float        deltaSize;
-
-    float        rotation;
-    float        deltaRotation;
-
-    float        timeToLive;
-
-    unsigned int    atlasIndex;
+class CC_DLL ParticleData
+{
+public:
+    float* posx;
+    float* posy;
+    float* startPosX;
+    float* startPosY;
+
+    float* colorR;
+    float* colorG;
+    float* colorB;
+    float* colorA;
+
+    float* deltaColorR;
+    float* deltaColorG;
+    float* deltaColorB;
+    float* deltaColorA;
+
+    float* size;
+    float* deltaSize;
+    float* rotation;
+    float* deltaRotation;
+    float* timeToLive;
+    unsigned int* atlasIndex;
 
     //! Mode A: gravity, direction, radial accel, tangential accel
     struct {
-        Vec2        dir;
-        float        radialAccel;
-        float        tangentialAccel;
+        float* dirX;
+        float* dirY;
+        float* radialAccel;
+        float* tangentialAccel;
     } modeA;
 
     //! Mode B: radius mode
     struct {
-        float        angle;
-        float        degreesPerSecond;
-        float        radius;
-        float        deltaRadius;
+        float* angle;
+        float* degreesPerSecond;
+        float* radius;
+        float* deltaRadius;
     } modeB;
 
-}tParticle;
+    unsigned int maxCount;
 
-//typedef void (*CC_UPDATE_PARTICLE_IMP)(id, SEL, tParticle*, Vec2);
+    ParticleData();
+    ~ParticleData();
+    //! (re)allocates the arrays for count particles, keeping the values of the existing particles. New values are set to 0
+    bool init(int count);
+    void release();
+    unsigned int getMaxCount() const { return maxCount; }
+
+    //! copies the values of the particle p2 to the particle p1
+    void copyParticle(int p1, int p2);
+
+private:
+    void* _buffer;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(ParticleData);
+};
 
 class Texture2D;
 
@@ -179,8 +205,10 @@ public:
 
     //! Add a particle to the emitter
     bool addParticle();
-    //! Initializes a particle
-    void initParticle(tParticle* particle);
+    /** Adds and initializes count particles, without exceeding the total particles.
+     @since v4.0
+     */
+    void addParticles(int count);
     //! stop emitting particles. Running particles will continue to run until they die
     void stopSystem();
     //! Kill all living particles.
@@ -188,8 +216,25 @@ public:
     //! whether or not the system is full
     bool isFull();
 
-    //! should be overridden by subclasses
-    virtual void updateQuadWithParticle(tParticle* particle, const Vec2& newPosition) {CCASSERT(false, "override me");}
+    /** Resets the system, then simulates it for the given seconds, so that it looks like it has been running for that long.
+     Useful for effects that must appear already running, like smoke or rain.
+     The particles are removed and the random numbers start from the same seed each time, so a system is always prewarmed to the same state.
+     @see fastForward
+     @since v4.0
+     */
+    void prewarm(float seconds);
+    /** Simulates the system for the given seconds at once. The quads are only updated for the final state.
+     When the particles have no radial or tangential acceleration, or in radius mode, they are advanced analytically by large steps,
+     else they are simulated by steps of 1/30 seconds.
+     A system that is auto removed on finish is removed if it stopped and has no particle left.
+     @since v4.0
+     */
+    void fastForward(float seconds);
+
+    /** Updates the quads of all the particles at once, after their simulation. Should be overridden by subclasses.
+     @since v4.0
+     */
+    virtual void updateParticleQuads() {}
     //! should be overridden by subclasses
     virtual void postStep() {CCASSERT(false, "override me");}
 
@@ -399,8 +444,43 @@ CC_CONSTRUCTOR_ACCESS:
     virtual bool initWithTotalParticles(int numberOfParticles);
 
 protected:
+    friend class Director;
+
     virtual void updateBlendFunc();
 
+    /** Emits the particles of the elapsed dt seconds and stops the system at the end of its duration.
+     @since v4.0
+     */
+    void updateEmitter(float dt);
+    /** Kills the dead particles and moves the living ones by dt seconds, without updating their quads.
+     @since v4.0
+     */
+    void updateParticles(float dt);
+    /** Kills the particles whose time to live is over.
+     @since v4.0
+     */
+    void removeDeadParticles();
+    /** Advances the particles [begin, end) by the given time in a single step, with the closed form of their trajectories.
+     Only valid in radius mode or without radial and tangential accelerations.
+     @since v4.0
+     */
+    void advanceParticles(int begin, int end, float time);
+    /** Updates the particles, then their quads if they are drawn. It only touches the data of this system and
+     doesn't read the scene graph, so that systems can be simulated concurrently.
+     @since v4.0
+     */
+    void simulate(float dt);
+    /** Removes the system if it finished, else updates its GL buffer. Called on the cocos thread after simulate().
+     @since v4.0
+     */
+    void finishUpdate();
+    /** Samples the transform of the particle positions to the positions of their quads:
+     quad position = particle position + _quadPositionOffset + _quadPositionTransform * particle start position.
+     It depends on the position type of the system.
+     @since v4.0
+     */
+    void updateQuadPositionTransform();
+
     /** whether or not the particles are using blend additive.
      If enabled, the following blending function will be used.
      @code
@@ -457,8 +537,8 @@ protected:
         float rotatePerSecondVar;
     } modeB;
 
-    //! Array of particles
-    tParticle *_particles;
+    //! Particles, as a structure of arrays
+    ParticleData _particleData;
 
     //Emitter name
     std::string _configName;
@@ -469,12 +549,20 @@ protected:
     //! How many particles can be emitted per second
     float _emitCounter;
 
-    //!  particle idx
-    int _particleIdx;
+    //! seed of the random numbers of the new particles
+    unsigned int _randomSeed;
+    //! seed of the random numbers when the system was initialized, restored by prewarm()
+    unsigned int _initialRandomSeed;
+
+    //! transform of the particle positions to the positions of their quads, see updateQuadPositionTransform()
+    Vec2 _quadPositionOffset;
+    float _quadPositionTransform[4];
 
-    // Optimization
-    //CC_UPDATE_PARTICLE_IMP    updateParticleImp;
-    //SEL                        updateParticleSel;
+    //! whether simulate() is deferred to the parallel update of the frame, see Director::setParallelParticleUpdateEnabled()
+    bool _isUpdateDeferred;
+    float _deferredUpdateDt;
+    //! whether the last particle died and the system must be removed
+    bool _isFinished;
 
     /** weak reference to the SpriteBatchNode that renders the Sprite */
     ParticleBatchNode* _batchNode;
@@ -278,86 +278,110 @@ void ParticleSystemQuad::setupVertices(size_t count)
     CC_SAFE_RETAIN(_ibParticles);
 }
 
-void ParticleSystemQuad::updateQuadWithParticle(tParticle* particle, const Vec2& newPosition)
+void ParticleSystemQuad::updateParticleQuads()
 {
-    V3F_C4B_T2F_Quad* quad;
+    if (_particleCount <= 0)
+    {
+        return;
+    }
 
+    const Vec2& offset = _quadPositionOffset;
+    const float* transform = _quadPositionTransform;
+
+    V3F_C4B_T2F_Quad* quads;
+    const unsigned int* atlasIndex = nullptr;
     if (_batchNode)
     {
-        V3F_C4B_T2F_Quad* batchQuads = _batchNode->getTextureAtlas()->getQuads();
-        quad = &(batchQuads[_atlasIndex+particle->atlasIndex]);
+        quads = &(_batchNode->getTextureAtlas()->getQuads()[_atlasIndex]);
+        atlasIndex = _particleData.atlasIndex;
     }
     else
     {
-        auto quads = _vbParticles->getElementsOfType<V3F_C4B_T2F_Quad>();
-        quad = &(quads[_particleIdx]);
+        quads = _vbParticles->getElementsOfType<V3F_C4B_T2F_Quad>();
     }
-    Color4B color = (_opacityModifyRGB)
-        ? Color4B( particle->color.r*particle->color.a*255, particle->color.g*particle->color.a*255, particle->color.b*particle->color.a*255, particle->color.a*255)
-        : Color4B( particle->color.r*255, particle->color.g*255, particle->color.b*255, particle->color.a*255);
-
-    quad->bl.colors = color;
-    quad->br.colors = color;
-    quad->tl.colors = color;
-    quad->tr.colors = color;
-
-    // vertices
-    float size_2 = particle->size/2;
-    if (particle->rotation) 
-    {
-        float x1 = -size_2;
-        float y1 = -size_2;
-
-        float x2 = size_2;
-        float y2 = size_2;
-        float x = newPosition.x;
-        float y = newPosition.y;
-
-        float r = (float)-CC_DEGREES_TO_RADIANS(particle->rotation);
-        float cr = cosf(r);
-        float sr = sinf(r);
-        float ax = x1 * cr - y1 * sr + x;
-        float ay = x1 * sr + y1 * cr + y;
-        float bx = x2 * cr - y1 * sr + x;
-        float by = x2 * sr + y1 * cr + y;
-        float cx = x2 * cr - y2 * sr + x;
-        float cy = x2 * sr + y2 * cr + y;
-        float dx = x1 * cr - y2 * sr + x;
-        float dy = x1 * sr + y2 * cr + y;
-
-        // bottom-left
-        quad->bl.vertices.x = ax;
-        quad->bl.vertices.y = ay;
-
-        // bottom-right vertex:
-        quad->br.vertices.x = bx;
-        quad->br.vertices.y = by;
-
-        // top-left vertex:
-        quad->tl.vertices.x = dx;
-        quad->tl.vertices.y = dy;
 
-        // top-right vertex:
-        quad->tr.vertices.x = cx;
-        quad->tr.vertices.y = cy;
-    } 
-    else 
+    const float* posx = _particleData.posx;
+    const float* posy = _particleData.posy;
+    const float* startPosX = _particleData.startPosX;
+    const float* startPosY = _particleData.startPosY;
+    const float* colorR = _particleData.colorR;
+    const float* colorG = _particleData.colorG;
+    const float* colorB = _particleData.colorB;
+    const float* colorA = _particleData.colorA;
+    const float* size = _particleData.size;
+    const float* rotation = _particleData.rotation;
+
+    for (int i = 0; i < _particleCount; ++i)
     {
-        // bottom-left vertex:
-        quad->bl.vertices.x = newPosition.x - size_2;
-        quad->bl.vertices.y = newPosition.y - size_2;
+        V3F_C4B_T2F_Quad* quad = atlasIndex ? &quads[atlasIndex[i]] : &quads[i];
+
+        Color4B color = (_opacityModifyRGB)
+            ? Color4B(colorR[i] * colorA[i] * 255, colorG[i] * colorA[i] * 255, colorB[i] * colorA[i] * 255, colorA[i] * 255)
+            : Color4B(colorR[i] * 255, colorG[i] * 255, colorB[i] * 255, colorA[i] * 255);
+
+        quad->bl.colors = color;
+        quad->br.colors = color;
+        quad->tl.colors = color;
+        quad->tr.colors = color;
+
+        // vertices
+        float x = posx[i] + offset.x + transform[0] * startPosX[i] + transform[2] * startPosY[i];
+        float y = posy[i] + offset.y + transform[1] * startPosX[i] + transform[3] * startPosY[i];
+        float size_2 = size[i] / 2;
+        if (rotation[i])
+        {
+            float x1 = -size_2;
+            float y1 = -size_2;
+
+            float x2 = size_2;
+            float y2 = size_2;
+
+            float r = (float)-CC_DEGREES_TO_RADIANS(rotation[i]);
+            float cr = cosf(r);
+            float sr = sinf(r);
+            float ax = x1 * cr - y1 * sr + x;
+            float ay = x1 * sr + y1 * cr + y;
+            float bx = x2 * cr - y1 * sr + x;
+            float by = x2 * sr + y1 * cr + y;
+            float cx = x2 * cr - y2 * sr + x;
+            float cy = x2 * sr + y2 * cr + y;
+            float dx = x1 * cr - y2 * sr + x;
+            float dy = x1 * sr + y2 * cr + y;
+
+            // bottom-left
+            quad->bl.vertices.x = ax;
+            quad->bl.vertices.y = ay;
+
+            // bottom-right vertex:
+            quad->br.vertices.x = bx;
+            quad->br.vertices.y = by;
+
+            // top-left vertex:
+            quad->tl.vertices.x = dx;
+            quad->tl.vertices.y = dy;
+
+            // top-right vertex:
+            quad->tr.vertices.x = cx;
+            quad->tr.vertices.y = cy;
+        }
+        else
+        {
+            // bottom-left vertex:
+            quad->bl.vertices.x = x - size_2;
+            quad->bl.vertices.y = y - size_2;
 
-        // bottom-right vertex:
-        quad->br.vertices.x = newPosition.x + size_2;
-        quad->br.vertices.y = newPosition.y - size_2;
+            // bottom-right vertex:
+            quad->br.vertices.x = x + size_2;
+            quad->br.vertices.y = y - size_2;
 
-        // top-left vertex:
-        quad->tl.vertices.x = newPosition.x - size_2;
-        quad->tl.vertices.y = newPosition.y + size_2;
+            // top-left vertex:
+            quad->tl.vertices.x = x - size_2;
+            quad->tl.vertices.y = y + size_2;
 
-        // top-right vertex:
-        quad->tr.vertices.x = newPosition.x + size_2;
-        quad->tr.vertices.y = newPosition.y + size_2;                
+            // top-right vertex:
+            quad->tr.vertices.x = x + size_2;
+            quad->tr.vertices.y = y + size_2;
+        }
     }
 }
 
@@ -369,11 +393,10 @@ void ParticleSystemQuad::postStep()
 // overriding draw method
 void ParticleSystemQuad::draw(Renderer* renderer, const Mat4 &transform, uint32_t flags)
 {
-    CCASSERT( _particleIdx == 0 || _particleIdx == _particleCount, "Abnormal error in particle quad");
-    if(_particleIdx > 0)
+    if(_particleCount > 0)
     {
-        _vbParticles->setElementCount(4 * _particleIdx);
-        _ibParticles->setElementCount(6 * _particleIdx);
+        _vbParticles->setElementCount(4 * _particleCount);
+        _ibParticles->setElementCount(6 * _particleCount);
 
         _batchCommand.init(_globalZOrder, getGLProgram(), _blendFunc, _texture, _vdParticles, transform, flags);
         renderer->addCommand(&_batchCommand);
@@ -395,16 +418,15 @@ void ParticleSystemQuad::setTotalParticles(int tp)
             _vbParticles->addCapacityOfType<V3F_C4B_T2F_Quad>(amount, true);
         }
     
-        _particles = (tParticle*)realloc(_particles, tp * sizeof(tParticle));
+        _particleData.init(tp);
         _allocatedParticles = tp;
         _totalParticles = tp;
 
         // Init particles
         if (_batchNode)
         {
-            auto p = _particles;
-            for (int i = 0; i < _totalParticles; ++i, ++p)
-                p->atlasIndex = i;
+            for (int i = 0; i < _totalParticles; ++i)
+                _particleData.atlasIndex[i] = i;
         }
 
         // fixed http://www.cocos2d-x.org/issues/3990
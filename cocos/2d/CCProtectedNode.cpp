@@ -268,6 +268,13 @@ void ProtectedNode::reorderProtectedChild(cocos2d::Node *child, int localZOrder)
     child->setLocalZOrder(localZOrder);
 }
 
+void ProtectedNode::mergeChildrenAABB(const Mat4& transform, AABB* aabb)
+{
+    Node::mergeChildrenAABB(transform, aabb);
+    for (const auto& child : _protectedChildren)
+        child->mergeSubtreeAABB(transform, aabb);
+}
+
 void ProtectedNode::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
     // quick return if not visible. children won't be drawn.
@@ -278,6 +285,17 @@ void ProtectedNode::visit(Renderer* renderer, const Mat4 &parentTransform, uint3
     
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
     
+    if (_subtreeCullingEnabled)
+    {
+        flags |= _culledFlags;
+        if (!isSubtreeVisibleByVisitingCamera())
+        {
+            _culledFlags = flags & FLAGS_DIRTY_MASK;
+            return;
+        }
+        _culledFlags = 0;
+    }
+    
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
     // but it is deprecated and your code should not rely on it
@@ -172,11 +172,15 @@ protected:
     /// helper that reorder a child
     void insertProtectedChild(Node* child, int z);
     
+    virtual void mergeChildrenAABB(const Mat4& transform, AABB* aabb) override;
+    
     Vector<Node*> _protectedChildren;        ///< array of children nodes
     bool _reorderProtectedChildDirty;
     
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ProtectedNode);
+    
+    friend class TransformHierarchy;
 };
 
 
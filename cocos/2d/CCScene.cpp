@@ -27,7 +27,9 @@ THE SOFTWARE.
 
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
+#include "base/CCThreadPool.h"
 #include "2d/CCCamera.h"
+#include "2d/CCTransformHierarchy.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/ccUTF8.h"
@@ -40,8 +42,10 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 Scene::Scene()
+: _transformHierarchy(nullptr)
+, _transformHierarchyEnabled(false)
 #if CC_USE_PHYSICS
-: _physicsWorld(nullptr)
+, _physicsWorld(nullptr)
 #endif
 {
     _ignoreAnchorPointForPosition = true;
@@ -64,6 +68,7 @@ Scene::~Scene()
 #endif
     Director::getInstance()->getEventDispatcher()->removeEventListener(_event);
     CC_SAFE_RELEASE(_event);
+    CC_SAFE_DELETE(_transformHierarchy);
 }
 
 bool Scene::init()
@@ -137,6 +142,26 @@ void Scene::render(Renderer* renderer)
         _cameraOrderDirty = false;
     }
     
+    // the parallel update needs the flattened hierarchy, but doesn't move physics bodies from worker threads
+    bool parallelTransforms = director->isParallelTransformUpdateEnabled();
+#if CC_USE_PHYSICS
+    parallelTransforms = parallelTransforms && _physicsWorld == nullptr;
+#endif
+    if (parallelTransforms && _transformHierarchy == nullptr)
+    {
+        _transformHierarchy = new (std::nothrow) TransformHierarchy();
+    }
+    else if (!parallelTransforms && !_transformHierarchyEnabled && _transformHierarchy)
+    {
+        // the parallel update was turned off, don't keep the copy of the scene graph
+        CC_SAFE_DELETE(_transformHierarchy);
+    }
+    
+    if (_transformHierarchy)
+    {
+        _transformHierarchy->update(this, transform, 0, parallelTransforms ? ThreadPool::getInstance() : nullptr);
+    }
+    
     for (const auto& camera : _cameras)
     {
         if (!camera->isVisible())
@@ -159,6 +184,24 @@ void Scene::render(Renderer* renderer)
     }
 
     Camera::_visitingCamera = nullptr;
+    
+    if (_transformHierarchy)
+    {
+        TransformHierarchy::invalidate();
+    }
+}
+
+void Scene::setTransformHierarchyEnabled(bool enabled)
+{
+    _transformHierarchyEnabled = enabled;
+    if (enabled && _transformHierarchy == nullptr)
+    {
+        _transformHierarchy = new (std::nothrow) TransformHierarchy();
+    }
+    else if (!enabled)
+    {
+        CC_SAFE_DELETE(_transformHierarchy);
+    }
 }
 
 #if CC_USE_PHYSICS
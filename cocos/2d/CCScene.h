@@ -38,6 +38,7 @@ class BaseLight;
 class Renderer;
 class EventListenerCustom;
 class EventCustom;
+class TransformHierarchy;
 #if CC_USE_PHYSICS
 class PhysicsWorld;
 #endif
@@ -80,6 +81,16 @@ public:
     /** render the scene */
     void render(Renderer* renderer);
     
+    /**
+     * Enable/Disable updating the transforms of the scene graph with a flattened TransformHierarchy before it is visited.
+     * The transforms are then updated by a linear sweep over contiguous arrays instead of during the recursive visit.
+     * Disabled by default, it is enabled by Director::setParallelTransformUpdateEnabled() as well.
+     * @since v4.0
+     */
+    void setTransformHierarchyEnabled(bool enabled);
+    /** returns whether the transforms are updated with a flattened TransformHierarchy */
+    bool isTransformHierarchyEnabled() const { return _transformHierarchyEnabled; }
+    
 CC_CONSTRUCTOR_ACCESS:
     Scene();
     virtual ~Scene();
@@ -106,6 +117,9 @@ protected:
 
     std::vector<BaseLight *> _lights;
     
+    TransformHierarchy* _transformHierarchy; //also created by the parallel update, freed when neither uses it
+    bool                _transformHierarchyEnabled;
+    
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Scene);
     
@@ -696,7 +696,7 @@ void Sprite::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        std::sort(std::begin(_children), std::end(_children), nodeComparisonLess);
+        sortReorderedChildren();
 
         if ( _batchNode)
         {
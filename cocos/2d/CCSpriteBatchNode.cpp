@@ -243,7 +243,7 @@ void SpriteBatchNode::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        std::sort(std::begin(_children), std::end(_children), nodeComparisonLess);
+        sortReorderedChildren();
 
         //sorted now check all children
         if (!_children.empty())
@@ -267,6 +267,7 @@ void SpriteBatchNode::sortAllChildren()
     }
 }
 
+// the order of arrival is reset once the sprites are sorted, without marking them reordered again
 void SpriteBatchNode::updateAtlasIndex(Sprite* sprite, ssize_t* curIndex)
 {
     auto& array = sprite->getChildren();
@@ -278,7 +279,7 @@ void SpriteBatchNode::updateAtlasIndex(Sprite* sprite, ssize_t* curIndex)
     {
         oldIndex = sprite->getAtlasIndex();
         sprite->setAtlasIndex(*curIndex);
-        sprite->setOrderOfArrival(0);
+        sprite->_orderOfArrival = 0;
         if (oldIndex != *curIndex){
             swap(oldIndex, *curIndex);
         }
@@ -293,7 +294,7 @@ void SpriteBatchNode::updateAtlasIndex(Sprite* sprite, ssize_t* curIndex)
             //all children are in front of the parent
             oldIndex = sprite->getAtlasIndex();
             sprite->setAtlasIndex(*curIndex);
-            sprite->setOrderOfArrival(0);
+            sprite->_orderOfArrival = 0;
             if (oldIndex != *curIndex)
             {
                 swap(oldIndex, *curIndex);
@@ -309,7 +310,7 @@ void SpriteBatchNode::updateAtlasIndex(Sprite* sprite, ssize_t* curIndex)
             {
                 oldIndex = sprite->getAtlasIndex();
                 sprite->setAtlasIndex(*curIndex);
-                sprite->setOrderOfArrival(0);
+                sprite->_orderOfArrival = 0;
                 if (oldIndex != *curIndex) {
                     this->swap(oldIndex, *curIndex);
                 }
@@ -324,7 +325,7 @@ void SpriteBatchNode::updateAtlasIndex(Sprite* sprite, ssize_t* curIndex)
         {//all children have a zOrder < 0)
             oldIndex = sprite->getAtlasIndex();
             sprite->setAtlasIndex(*curIndex);
-            sprite->setOrderOfArrival(0);
+            sprite->_orderOfArrival = 0;
             if (oldIndex != *curIndex) {
                 swap(oldIndex, *curIndex);
             }
@@ -47,6 +47,89 @@ NS_CC_BEGIN
 
 static SpriteFrameCache *_sharedSpriteFrameCache = nullptr;
 
+/*
+ Binary sprite sheet index, written by tools/sprite-sheet-index/plist_to_index.py.
+ Little endian, every section is 4 bytes aligned so that the file can be used in place:
+ - SpriteSheetIndexHeader
+ - SpriteSheetIndexFrame[frameCount]
+ - SpriteSheetIndexAlias[aliasCount]
+ - the string pool: null terminated UTF-8 names, each stored once, referenced by their offset in the pool
+ */
+static const char SPRITE_SHEET_INDEX_MAGIC[4] = { 'C', 'S', 'S', 'I' };
+static const uint16_t SPRITE_SHEET_INDEX_VERSION = 1;
+static const uint32_t SPRITE_SHEET_INDEX_NO_STRING = 0xffffffff;
+static const uint32_t SPRITE_SHEET_INDEX_ROTATED = 1;
+
+struct SpriteSheetIndexHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t frameCount;
+    uint32_t aliasCount;
+    uint32_t framesOffset;
+    uint32_t aliasesOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+    uint32_t textureFileName;   // in the string pool, or SPRITE_SHEET_INDEX_NO_STRING
+};
+
+struct SpriteSheetIndexFrame
+{
+    uint32_t name;
+    uint32_t flags;
+    float x, y, width, height;  // rect in the texture, with the size of the unrotated sprite
+    float offsetX, offsetY;
+    float sourceWidth, sourceHeight;
+};
+
+struct SpriteSheetIndexAlias
+{
+    uint32_t name;
+    uint32_t frame;
+};
+
+static_assert(sizeof(SpriteSheetIndexHeader) == 36, "unexpected padding in SpriteSheetIndexHeader");
+static_assert(sizeof(SpriteSheetIndexFrame) == 40, "unexpected padding in SpriteSheetIndexFrame");
+static_assert(sizeof(SpriteSheetIndexAlias) == 8, "unexpected padding in SpriteSheetIndexAlias");
+
+static inline const SpriteSheetIndexHeader* getSpriteSheetIndexHeader(const Data& data)
+{
+    return reinterpret_cast<const SpriteSheetIndexHeader*>(data.getBytes());
+}
+
+static inline const char* getSpriteSheetIndexString(const Data& data, uint32_t offset)
+{
+    auto header = getSpriteSheetIndexHeader(data);
+    return reinterpret_cast<const char*>(data.getBytes() + header->stringsOffset + offset);
+}
+
+// builds the path of the texture of a sprite sheet from the file name in its metadata, or from the sheet's name
+static std::string getSpriteSheetTexturePath(const std::string& plist, const std::string& textureFileName)
+{
+    std::string texturePath;
+    if (!textureFileName.empty())
+    {
+        // build texture path relative to plist file
+        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(textureFileName.c_str(), plist);
+    }
+    else
+    {
+        // build texture path by replacing file extension
+        texturePath = plist;
+
+        // remove .xxx
+        size_t startPos = texturePath.find_last_of("."); 
+        texturePath = texturePath.erase(startPos);
+
+        // append .png
+        texturePath = texturePath.append(".png");
+
+        CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    }
+    return texturePath;
+}
+
 SpriteFrameCache* SpriteFrameCache::getInstance()
 {
     if (! _sharedSpriteFrameCache)
@@ -202,9 +285,16 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture
     }
     
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-
-    addSpriteFramesWithDictionary(dict, texture);
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (isSpriteSheetIndex(data))
+    {
+        addSpriteFramesWithSpriteSheetIndex(data, texture);
+    }
+    else
+    {
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromData(reinterpret_cast<const char*>(data.getBytes()), static_cast<int>(data.getSize()));
+        addSpriteFramesWithDictionary(dict, texture);
+    }
     _loadedFileNames->insert(plist);
 }
 
@@ -243,38 +333,37 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
 
     if (_loadedFileNames->find(plist) == _loadedFileNames->end())
     {
-        
-        ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-
-        string texturePath("");
-
-        if (dict.find("metadata") != dict.end())
+        Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        if (isSpriteSheetIndex(data))
         {
-            ValueMap& metadataDict = dict["metadata"].asValueMap();
-            // try to read  texture file name from meta data
-            texturePath = metadataDict["textureFileName"].asString();
-        }
+            // the binary index is used in place, without building a ValueMap
+            std::string texturePath = getSpriteSheetTexturePath(plist, getSpriteSheetIndexTextureFileName(data));
+            Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(texturePath.c_str());
 
-        if (!texturePath.empty())
-        {
-            // build texture path relative to plist file
-            texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath.c_str(), plist);
+            if (texture)
+            {
+                addSpriteFramesWithSpriteSheetIndex(data, texture);
+                _loadedFileNames->insert(plist);
+            }
+            else
+            {
+                CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+            }
+            return;
         }
-        else
-        {
-            // build texture path by replacing file extension
-            texturePath = plist;
 
-            // remove .xxx
-            size_t startPos = texturePath.find_last_of("."); 
-            texturePath = texturePath.erase(startPos);
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromData(reinterpret_cast<const char*>(data.getBytes()), static_cast<int>(data.getSize()));
 
-            // append .png
-            texturePath = texturePath.append(".png");
+        string textureFileName("");
 
-            CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+        if (dict.find("metadata") != dict.end())
+        {
+            ValueMap& metadataDict = dict["metadata"].asValueMap();
+            // try to read  texture file name from meta data
+            textureFileName = metadataDict["textureFileName"].asString();
         }
 
+        std::string texturePath = getSpriteSheetTexturePath(plist, textureFileName);
         Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(texturePath.c_str());
 
         if (texture)
@@ -353,13 +442,21 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-    if (dict.empty())
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (isSpriteSheetIndex(data))
     {
-        CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: create dict by %s fail.",plist.c_str());
-        return;
+        removeSpriteFramesFromSpriteSheetIndex(data);
+    }
+    else
+    {
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromData(reinterpret_cast<const char*>(data.getBytes()), static_cast<int>(data.getSize()));
+        if (dict.empty())
+        {
+            CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: create dict by %s fail.",plist.c_str());
+            return;
+        }
+        removeSpriteFramesFromDictionary(dict);
     }
-    removeSpriteFramesFromDictionary(dict);
 
     // remove it from the cache
     set<string>::iterator ret = _loadedFileNames->find(plist);
@@ -396,6 +493,109 @@ void SpriteFrameCache::removeSpriteFramesFromDictionary(ValueMap& dictionary)
     _spriteFrames.erase(keysToRemove);
 }
 
+bool SpriteFrameCache::isSpriteSheetIndex(const Data& data)
+{
+    ssize_t size = data.getSize();
+    if (size < (ssize_t)sizeof(SpriteSheetIndexHeader))
+        return false;
+
+    auto header = getSpriteSheetIndexHeader(data);
+    if (memcmp(header->magic, SPRITE_SHEET_INDEX_MAGIC, sizeof(SPRITE_SHEET_INDEX_MAGIC)) != 0)
+        return false;
+    if (header->version != SPRITE_SHEET_INDEX_VERSION)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: unsupported sprite sheet index version %d", (int)header->version);
+        return false;
+    }
+
+    // every offset must stay in the data, so that the loaders don't need to check them
+    uint64_t framesEnd = (uint64_t)header->framesOffset + (uint64_t)header->frameCount * sizeof(SpriteSheetIndexFrame);
+    uint64_t aliasesEnd = (uint64_t)header->aliasesOffset + (uint64_t)header->aliasCount * sizeof(SpriteSheetIndexAlias);
+    uint64_t stringsEnd = (uint64_t)header->stringsOffset + header->stringsSize;
+    if (framesEnd > (uint64_t)size || aliasesEnd > (uint64_t)size || stringsEnd > (uint64_t)size ||
+        header->framesOffset % 4 != 0 || header->aliasesOffset % 4 != 0)
+        return false;
+    if (header->stringsSize == 0 || data.getBytes()[stringsEnd - 1] != 0)
+        return false;
+
+    auto frames = reinterpret_cast<const SpriteSheetIndexFrame*>(data.getBytes() + header->framesOffset);
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        if (frames[i].name >= header->stringsSize)
+            return false;
+    }
+    auto aliases = reinterpret_cast<const SpriteSheetIndexAlias*>(data.getBytes() + header->aliasesOffset);
+    for (uint32_t i = 0; i < header->aliasCount; ++i)
+    {
+        if (aliases[i].name >= header->stringsSize || aliases[i].frame >= header->frameCount)
+            return false;
+    }
+    return header->textureFileName == SPRITE_SHEET_INDEX_NO_STRING || header->textureFileName < header->stringsSize;
+}
+
+std::string SpriteFrameCache::getSpriteSheetIndexTextureFileName(const Data& data)
+{
+    auto header = getSpriteSheetIndexHeader(data);
+    if (header->textureFileName == SPRITE_SHEET_INDEX_NO_STRING)
+        return "";
+    return getSpriteSheetIndexString(data, header->textureFileName);
+}
+
+void SpriteFrameCache::addSpriteFramesWithSpriteSheetIndex(const Data& data, Texture2D* texture)
+{
+    auto header = getSpriteSheetIndexHeader(data);
+    auto frames = reinterpret_cast<const SpriteSheetIndexFrame*>(data.getBytes() + header->framesOffset);
+    auto aliases = reinterpret_cast<const SpriteSheetIndexAlias*>(data.getBytes() + header->aliasesOffset);
+
+    _spriteFrames.reserve(_spriteFrames.size() + header->frameCount);
+    std::string spriteFrameName;
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        const auto& frame = frames[i];
+        spriteFrameName = getSpriteSheetIndexString(data, frame.name);
+        if (_spriteFrames.at(spriteFrameName))
+        {
+            continue;
+        }
+
+        auto spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                          Rect(frame.x, frame.y, frame.width, frame.height),
+                                                          (frame.flags & SPRITE_SHEET_INDEX_ROTATED) != 0,
+                                                          Vec2(frame.offsetX, frame.offsetY),
+                                                          Size(frame.sourceWidth, frame.sourceHeight));
+        _spriteFrames.insert(spriteFrameName, spriteFrame);
+    }
+
+    for (uint32_t i = 0; i < header->aliasCount; ++i)
+    {
+        std::string oneAlias = getSpriteSheetIndexString(data, aliases[i].name);
+        if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
+        {
+            CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
+        }
+
+        _spriteFramesAliases[oneAlias] = Value(getSpriteSheetIndexString(data, frames[aliases[i].frame].name));
+    }
+}
+
+void SpriteFrameCache::removeSpriteFramesFromSpriteSheetIndex(const Data& data)
+{
+    auto header = getSpriteSheetIndexHeader(data);
+    auto frames = reinterpret_cast<const SpriteSheetIndexFrame*>(data.getBytes() + header->framesOffset);
+
+    std::vector<std::string> keysToRemove;
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        std::string name = getSpriteSheetIndexString(data, frames[i].name);
+        if (_spriteFrames.at(name))
+        {
+            keysToRemove.push_back(name);
+        }
+    }
+
+    _spriteFrames.erase(keysToRemove);
+}
+
 void SpriteFrameCache::removeSpriteFramesFromTexture(Texture2D* texture)
 {
     std::vector<std::string> keysToRemove;
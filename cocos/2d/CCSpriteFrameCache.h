@@ -33,6 +33,8 @@ THE SOFTWARE.
 /*
  * To create sprite frames and texture atlas, use this tool:
  * http://zwoptex.zwopple.com/
+ * To convert the plist files to binary sprite sheet indices, faster to load, use:
+ * tools/sprite-sheet-index/plist_to_index.py
  */
 #include <set>
 #include <string>
@@ -40,6 +42,7 @@ THE SOFTWARE.
 #include "base/CCRef.h"
 #include "base/CCValue.h"
 #include "base/CCMap.h"
+#include "base/CCData.h"
 
 NS_CC_BEGIN
 
@@ -78,6 +81,8 @@ public:
     bool init();
 
     /** Adds multiple Sprite Frames from a plist file.
+     * The file can also be a binary sprite sheet index converted from a plist, which is loaded without parsing,
+     * in any of the addSpriteFramesWithFile() and removeSpriteFramesFromFile() methods.
      * A texture will be loaded automatically. The texture name will composed by replacing the .plist suffix with .png
      * If you want to use another texture, you should use the addSpriteFramesWithFile(const std::string& plist, const std::string& textureFileName) method.
      * @js addSpriteFrames
@@ -169,6 +174,15 @@ protected:
     */
     void removeSpriteFramesFromDictionary(ValueMap& dictionary);
 
+    /** Returns whether the data is a binary sprite sheet index, with consistent offsets and sizes. */
+    static bool isSpriteSheetIndex(const Data& data);
+    /** Returns the texture file name stored in a binary sprite sheet index, or an empty string. */
+    static std::string getSpriteSheetIndexTextureFileName(const Data& data);
+    /** Adds the Sprite Frames of a binary sprite sheet index, read in place. */
+    void addSpriteFramesWithSpriteSheetIndex(const Data& data, Texture2D *texture);
+    /** Removes the Sprite Frames of a binary sprite sheet index. */
+    void removeSpriteFramesFromSpriteSheetIndex(const Data& data);
+
 
     Map<std::string, SpriteFrame*> _spriteFrames;
     ValueMap _spriteFramesAliases;
@@ -29,6 +29,12 @@ THE SOFTWARE.
 #include "2d/CCTMXLayer.h"
 #include "2d/CCSprite.h"
 #include "base/ccUTF8.h"
+#include "base/CCDirector.h"
+#include "base/CCAsyncTaskPool.h"
+#include "renderer/CCTextureCache.h"
+#include "platform/CCFileUtils.h"
+
+#include <set>
 
 NS_CC_BEGIN
 
@@ -58,6 +64,60 @@ TMXTiledMap* TMXTiledMap::createWithXML(const std::string& tmxString, const std:
     return nullptr;
 }
 
+void TMXTiledMap::createAsync(const std::string& tmxFile, const std::function<void(TMXTiledMap*)>& callback)
+{
+    CCASSERT(tmxFile.size()>0, "TMXTiledMap: tmx file should not be empty");
+
+    // the worker thread only reads absolute paths, the caches of FileUtils are used on the cocos thread
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(tmxFile);
+    TMXMapInfo *mapInfo = new (std::nothrow) TMXMapInfo();
+    auto parsed = std::make_shared<bool>(false);
+
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [mapInfo, parsed, callback](void*) {
+        if (!*parsed || mapInfo->getTilesets().empty())
+        {
+            CCLOG("cocos2d: TMXTiledMap: can't load the map asynchronously");
+            mapInfo->release();
+            callback(nullptr);
+            return;
+        }
+
+        auto build = [mapInfo, callback]() {
+            TMXTiledMap *ret = new (std::nothrow) TMXTiledMap();
+            ret->setContentSize(Size::ZERO);
+            ret->buildWithMapInfo(mapInfo);
+            ret->autorelease();
+            mapInfo->release();
+            callback(ret);
+        };
+
+        // the layers find their textures in the cache
+        std::set<std::string> images;
+        for (const auto& tileset : mapInfo->getTilesets())
+        {
+            if (!tileset->_sourceImage.empty())
+                images.insert(tileset->_sourceImage);
+        }
+        if (images.empty())
+        {
+            build();
+            return;
+        }
+
+        auto remaining = std::make_shared<size_t>(images.size());
+        auto textureCache = Director::getInstance()->getTextureCache();
+        for (const auto& image : images)
+        {
+            textureCache->addImageAsync(image, [remaining, build](Texture2D*) {
+                if (--(*remaining) == 0)
+                    build();
+            });
+        }
+    }, nullptr, [mapInfo, fullPath, parsed]() {
+        *parsed = !fullPath.empty() && mapInfo->initWithTMXFile(fullPath);
+    });
+}
+
 bool TMXTiledMap::initWithTMXFile(const std::string& tmxFile)
 {
     CCASSERT(tmxFile.size()>0, "TMXTiledMap: tmx file should not be empty");
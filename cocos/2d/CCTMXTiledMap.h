@@ -119,6 +119,13 @@ public:
     /** initializes a TMX Tiled Map with a TMX formatted XML string and a path to TMX resources */
     static TMXTiledMap* createWithXML(const std::string& tmxString, const std::string& resourcePath);
 
+    /** creates a TMX Tiled Map with a TMX file, without blocking the cocos thread.
+     The file is parsed on a worker thread and the tileset textures are loaded with TextureCache::addImageAsync(),
+     then the map is built and passed to the callback on the cocos thread, or nullptr if the file can't be loaded.
+     @since v4.0
+     */
+    static void createAsync(const std::string& tmxFile, const std::function<void(TMXTiledMap*)>& callback);
+
     /** return the TMXLayer for the specific layer */
     TMXLayer* getLayer(const std::string& layerName) const;
     /**
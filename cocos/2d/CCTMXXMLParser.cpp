@@ -199,7 +199,8 @@ bool TMXMapInfo::parseXMLFile(const std::string& xmlFilename)
     
     parser.setDelegator(this);
 
-    return parser.parse(FileUtils::getInstance()->fullPathForFilename(xmlFilename).c_str());
+    // the file is parsed while it is read, the layers data can be large
+    return parser.parseStream(FileUtils::getInstance()->fullPathForFilename(xmlFilename).c_str());
 }
 
 
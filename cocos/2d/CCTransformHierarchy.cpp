@@ -0,0 +1,258 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCTransformHierarchy.h"
+#include "2d/CCNode.h"
+#include "2d/CCProtectedNode.h"
+#include "base/CCThreadPool.h"
+
+#include <algorithm>
+
+NS_CC_BEGIN
+
+unsigned int TransformHierarchy::s_structureVersion = 1;
+unsigned int TransformHierarchy::s_currentPass = 1;
+
+// below this many nodes the update is not worth splitting
+static const int PARALLEL_MIN_NODES = 4096;
+// smallest job, and number of jobs per thread aimed for so that work stealing can balance them
+static const int PARALLEL_MIN_JOB_NODES = 256;
+static const int PARALLEL_JOBS_PER_THREAD = 4;
+
+TransformHierarchy::TransformHierarchy()
+: _jobsThreadCount(0)
+, _root(nullptr)
+, _rootParentTransform(nullptr)
+, _rootParentFlags(0)
+, _structureVersion(0)
+{
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+}
+
+void TransformHierarchy::rebuild(Node* root)
+{
+    _nodes.clear();
+    _parents.clear();
+    _subtreeEnds.clear();
+    
+    appendSubtree(root, -1);
+    
+    _flags.resize(_nodes.size());
+    _localTransforms.resize(_nodes.size());
+    _modelViewTransforms.resize(_nodes.size());
+    _passes.assign(_nodes.size(), 0);
+    _jobsThreadCount = 0;
+    _root = root;
+    _structureVersion = s_structureVersion;
+    
+    readTransforms();
+}
+
+void TransformHierarchy::readTransforms()
+{
+    const int count = (int)_nodes.size();
+    for (int i = 0; i < count; ++i)
+    {
+        _localTransforms[i] = _nodes[i]->getNodeToParentTransform();
+        _modelViewTransforms[i] = _nodes[i]->_modelViewTransform;
+        _nodes[i]->_transformHierarchyStale = false;
+    }
+}
+
+void TransformHierarchy::appendSubtree(Node* node, int parentIndex)
+{
+    int index = (int)_nodes.size();
+    _nodes.push_back(node);
+    _parents.push_back(parentIndex);
+    _subtreeEnds.push_back(index + 1);
+    
+    for (const auto& child : node->_children)
+    {
+        appendSubtree(child, index);
+    }
+    
+    // protected children are visited with the model view transform of their parent as well
+    auto protectedNode = dynamic_cast<ProtectedNode*>(node);
+    if (protectedNode)
+    {
+        for (const auto& child : protectedNode->_protectedChildren)
+        {
+            appendSubtree(child, index);
+        }
+    }
+    
+    _subtreeEnds[index] = (int)_nodes.size();
+}
+
+void TransformHierarchy::planJobs(int threadCount)
+{
+    _splitNodes.clear();
+    _jobBegins.clear();
+    _jobEnds.clear();
+    
+    const int count = (int)_nodes.size();
+    const int maxJobSize = std::max(PARALLEL_MIN_JOB_NODES, count / ((threadCount + 1) * PARALLEL_JOBS_PER_THREAD));
+    splitSubtree(0, maxJobSize);
+    
+    _jobsThreadCount = threadCount;
+}
+
+void TransformHierarchy::splitSubtree(int index, int maxJobSize)
+{
+    const int end = _subtreeEnds[index];
+    if (end - index > maxJobSize && end > index + 1)
+    {
+        // too large: update the node first, then split its children
+        _splitNodes.push_back(index);
+        for (int child = index + 1; child < end; child = _subtreeEnds[child])
+        {
+            splitSubtree(child, maxJobSize);
+        }
+        return;
+    }
+    
+    // sibling subtrees are contiguous, so small ones are merged in a single job
+    if (!_jobEnds.empty() && _jobEnds.back() == index && end - _jobBegins.back() <= maxJobSize)
+    {
+        _jobEnds.back() = end;
+    }
+    else
+    {
+        _jobBegins.push_back(index);
+        _jobEnds.push_back(end);
+    }
+}
+
+void TransformHierarchy::sweep(int begin, int end)
+{
+    int i = begin;
+    while (i < end)
+    {
+        Node* node = _nodes[i];
+        const int parent = _parents[i];
+        // invisible nodes are not visited, nor are their children
+        if (!node->_visible || (parent >= 0 && _passes[parent] != s_currentPass))
+        {
+            i = _subtreeEnds[i];
+            continue;
+        }
+        
+        const Mat4& parentTransform = parent < 0 ? *_rootParentTransform : _modelViewTransforms[parent];
+        const uint32_t parentFlags = parent < 0 ? _rootParentFlags : _flags[parent];
+        
+        bool regularUpdate = node->_usingNormalizedPosition;
+#if CC_USE_PHYSICS
+        regularUpdate = regularUpdate || (node->_physicsBody && node->_updateTransformFromPhysics);
+#endif
+        uint32_t flags;
+        if (regularUpdate)
+        {
+            // these depend on the parent's content size or on the physics world.
+            // the arrays are updated below, the node doesn't need to invalidate them
+            node->_transformHierarchyPass = 0;
+            flags = node->processParentFlags(parentTransform, parentFlags);
+            if ((flags & Node::FLAGS_DIRTY_MASK) || node->_transformHierarchyStale)
+            {
+                _localTransforms[i] = node->getNodeToParentTransform();
+                _modelViewTransforms[i] = node->_modelViewTransform;
+                node->_transformHierarchyStale = false;
+            }
+        }
+        else
+        {
+            // updated by Node::processParentFlags() since the last update, the arrays are outdated
+            if (node->_transformHierarchyStale)
+            {
+                _localTransforms[i] = node->getNodeToParentTransform();
+                _modelViewTransforms[i] = node->_modelViewTransform;
+                node->_transformHierarchyStale = false;
+            }
+            
+            flags = parentFlags;
+            if (node->_transformUpdated || node->_contentSizeDirty)
+            {
+                flags |= (node->_transformUpdated ? Node::FLAGS_TRANSFORM_DIRTY : 0);
+                flags |= (node->_contentSizeDirty ? Node::FLAGS_CONTENT_SIZE_DIRTY : 0);
+                _localTransforms[i] = node->getNodeToParentTransform();
+                node->_transformUpdated = false;
+                node->_contentSizeDirty = false;
+            }
+            
+            if (flags & Node::FLAGS_DIRTY_MASK)
+            {
+                Mat4::multiply(parentTransform, _localTransforms[i], &_modelViewTransforms[i]);
+                node->_modelViewTransform = _modelViewTransforms[i];
+            }
+        }
+        
+        _flags[i] = flags;
+        _passes[i] = s_currentPass;
+        
+        node->_transformHierarchyFlags = flags;
+        node->_transformHierarchyPass = s_currentPass;
+        ++i;
+    }
+}
+
+void TransformHierarchy::update(Node* root, const Mat4& parentTransform, uint32_t parentFlags, ThreadPool* threadPool)
+{
+    if (root != _root || _structureVersion != s_structureVersion)
+    {
+        rebuild(root);
+    }
+    
+    // results of the previous update must not be used by processParentFlags() while sweeping
+    ++s_currentPass;
+    
+    _rootParentTransform = &parentTransform;
+    _rootParentFlags = parentFlags;
+    
+    const int count = (int)_nodes.size();
+    const int threadCount = threadPool ? threadPool->getThreadCount() : 0;
+    if (threadCount == 0 || count < PARALLEL_MIN_NODES)
+    {
+        sweep(0, count);
+        return;
+    }
+    
+    if (_jobsThreadCount != threadCount)
+    {
+        planJobs(threadCount);
+    }
+    
+    // the split nodes are in parent-before-child order and are the parents of the job ranges
+    for (const auto& index : _splitNodes)
+    {
+        sweep(index, index + 1);
+    }
+    
+    threadPool->parallelFor((int)_jobBegins.size(), [this](int job) {
+        sweep(_jobBegins[job], _jobEnds[job]);
+    });
+}
+
+NS_CC_END
@@ -0,0 +1,128 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCTRANSFORMHIERARCHY_H__
+#define __CCTRANSFORMHIERARCHY_H__
+
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "math/CCMath.h"
+
+NS_CC_BEGIN
+
+class Node;
+class ThreadPool;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @brief TransformHierarchy is a flattened copy of a scene graph used to update the transforms of its nodes.
+ 
+ The nodes are stored in parent-before-child order, together with the index of their parent,
+ the end of their subtree, their dirty flags, their local transform and their model view transform, in contiguous arrays.
+ Updating the transforms is then a linear sweep over these arrays instead of a recursive walk: the model view transform
+ of a node is the one of its parent, read from the arrays, multiplied by its local transform. Only the local transforms of
+ the nodes which moved are read back from the nodes.
+ 
+ The result of the sweep is stored in each Node, and Node::visit() uses it instead of updating its own transform.
+ Nodes positioned by physics or with a normalized position still go through Node::processParentFlags().
+ Nodes whose transform changes between the sweep and their visit (e.g. layouts updated in visit()), or which
+ are visited with another parent transform, fall back to the regular update, and only their entries are read
+ back by the next update.
+ The arrays are rebuilt only when a node is added to or removed from any parent.
+ 
+ @see Scene::setTransformHierarchyEnabled()
+ @since v4.0
+ */
+class CC_DLL TransformHierarchy
+{
+public:
+    TransformHierarchy();
+    ~TransformHierarchy();
+    
+    /**
+     * Updates the transforms of root and its descendants, root being visited with parentTransform and parentFlags.
+     * When threadPool is not null, large independent subtrees are updated in parallel on it.
+     */
+    void update(Node* root, const Mat4& parentTransform, uint32_t parentFlags, ThreadPool* threadPool = nullptr);
+    
+    /** Discards the results of the last update(), to be called once every node has been visited */
+    static void invalidate() { ++s_currentPass; }
+    
+    /** Tells every TransformHierarchy that the scene graph changed. Called when a node changes its parent */
+    static void markStructureDirty() { ++s_structureVersion; }
+    
+    /** Returns the id of the current update, nodes updated by it are tagged with this id */
+    static unsigned int getCurrentPass() { return s_currentPass; }
+    
+    /** Returns the number of nodes flattened in the arrays */
+    ssize_t getNodeCount() const { return (ssize_t)_nodes.size(); }
+    
+protected:
+    void rebuild(Node* root);
+    void appendSubtree(Node* node, int parentIndex);
+    //reads the local and model view transforms of the nodes in the arrays
+    void readTransforms();
+    
+    //updates the nodes in [begin, end), their parents outside of the range must have been updated already
+    void sweep(int begin, int end);
+    
+    //splits the arrays in ranges of independent subtrees for threadCount threads
+    void planJobs(int threadCount);
+    void splitSubtree(int index, int maxJobSize);
+    
+    //nodes in parent-before-child order, the subtree of _nodes[i] is [i, _subtreeEnds[i])
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;
+    std::vector<int> _subtreeEnds;
+    std::vector<uint32_t> _flags;
+    std::vector<Mat4> _localTransforms;
+    std::vector<Mat4> _modelViewTransforms;
+    //id of the update that last updated the node, skipped nodes keep an older one
+    std::vector<unsigned int> _passes;
+    
+    //parallel update: nodes updated first on the calling thread, then ranges of subtrees updated by the jobs
+    std::vector<int> _splitNodes;
+    std::vector<int> _jobBegins;
+    std::vector<int> _jobEnds;
+    int _jobsThreadCount;
+    
+    Node* _root;
+    const Mat4* _rootParentTransform;
+    uint32_t _rootParentFlags;
+    unsigned int _structureVersion;
+    
+    static unsigned int s_structureVersion;
+    static unsigned int s_currentPass;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCTRANSFORMHIERARCHY_H__
@@ -824,6 +824,16 @@ const AABB& Sprite3D::getAABB() const
     return _aabb;
 }
 
+AABB Sprite3D::getContentAABB() const
+{
+    AABB aabb;
+    for (const auto& it : _meshes) {
+        if (it->isVisible())
+            aabb.merge(it->getAABB());
+    }
+    return aabb;
+}
+
 Action* Sprite3D::runAction(Action *action)
 {
     setForceDepthWrite(true);
@@ -147,6 +147,9 @@ public:
      * Note: the bouding-box is just get from the AABB which as Z=0, so that is not very accurate.
      */
     virtual Rect getBoundingBox() const override;
+    
+    /** Returns the AABB of the visible meshes in the sprite's coordinate system. */
+    virtual AABB getContentAABB() const override;
 
     // set which face is going to cull, GL_BACK, GL_FRONT, GL_FRONT_AND_BACK, default GL_BACK
     void setCullFace(GLenum cullFace);
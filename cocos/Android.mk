@@ -82,6 +82,7 @@ cocos2d.cpp \
 2d/CCFastTMXTiledMap.cpp \
 2d/CCTMXXMLParser.cpp \
 2d/CCTextFieldTTF.cpp \
+2d/CCTransformHierarchy.cpp \
 2d/CCTileMapAtlas.cpp \
 2d/CCTransition.cpp \
 2d/CCTransitionPageTurn.cpp \
@@ -92,6 +93,7 @@ cocos2d.cpp \
 platform/CCGLView.cpp \
 platform/CCFileUtils.cpp \
 platform/CCSAXParser.cpp \
+platform/CCFilePack.cpp \
 platform/CCThread.cpp \
 platform/CCImage.cpp \
 math/CCAffineTransform.cpp \
@@ -105,6 +107,8 @@ math/Vec2.cpp \
 math/Vec3.cpp \
 math/Vec4.cpp \
 base/CCAsyncTaskPool.cpp \
+base/CCThreadPool.cpp \
+base/CCFunctionQueue.cpp \
 base/CCAutoreleasePool.cpp \
 base/CCConfiguration.cpp \
 base/CCConsole.cpp \
@@ -171,6 +175,7 @@ renderer/CCRenderer.cpp \
 renderer/CCTexture2D.cpp \
 renderer/CCTextureAtlas.cpp \
 renderer/CCTextureCache.cpp \
+renderer/CCTextureTranscoder.cpp \
 renderer/ccGLStateCache.cpp \
 renderer/ccShaders.cpp \
 renderer/CCVertexIndexBuffer.cpp \
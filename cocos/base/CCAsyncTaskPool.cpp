@@ -46,10 +46,119 @@ void AsyncTaskPool::destoryInstance()
 
 AsyncTaskPool::AsyncTaskPool()
 {
+    for (auto& serialQueue : _serialQueues)
+    {
+        serialQueue = nullptr;
+    }
 }
 
 AsyncTaskPool::~AsyncTaskPool()
 {
+    for (auto& token : _tokens)
+    {
+        token.cancel();
+    }
+    for (auto& serialQueue : _serialQueues)
+    {
+        CC_SAFE_DELETE(serialQueue);
+    }
+}
+
+void AsyncTaskPool::enqueueTask(TaskType type, Task&& task)
+{
+    SerialQueue* serialQueue = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        task.token = _tokens[(int)type];
+        if (isBlocking(type))
+        {
+            if (_serialQueues[(int)type] == nullptr)
+            {
+                _serialQueues[(int)type] = new (std::nothrow) SerialQueue();
+            }
+            serialQueue = _serialQueues[(int)type];
+        }
+    }
+    
+    if (serialQueue)
+    {
+        serialQueue->enqueue(std::move(task));
+    }
+    else
+    {
+        // the task is cancelled through its own token, the ThreadPool can drop it
+        auto queued = std::make_shared<Task>(std::move(task));
+        ThreadPool::getInstance()->enqueue([queued]{ runTask(*queued); }, queued->priority);
+    }
+}
+
+void AsyncTaskPool::runTask(Task& task)
+{
+    if (task.token.isCancelled())
+        return;
+    
+    task.work();
+    
+    if (task.callback)
+    {
+        auto callback = std::move(task.callback);
+        auto callbackParam = task.callbackParam;
+        auto token = task.token;
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([callback, callbackParam, token]{
+            if (!token.isCancelled())
+                callback(callbackParam);
+        });
+    }
+}
+
+AsyncTaskPool::SerialQueue::SerialQueue()
+: _stop(false)
+{
+    _thread = std::thread(&SerialQueue::threadLoop, this);
+}
+
+AsyncTaskPool::SerialQueue::~SerialQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        _tasks.clear();
+    }
+    _condition.notify_all();
+    _thread.join();
+}
+
+void AsyncTaskPool::SerialQueue::enqueue(Task&& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+    }
+    _condition.notify_one();
+}
+
+void AsyncTaskPool::SerialQueue::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tasks.clear();
+}
+
+void AsyncTaskPool::SerialQueue::threadLoop()
+{
+    for (;;)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]{ return _stop || !_tasks.empty(); });
+            if (_stop)
+                return;
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        
+        runTask(task);
+    }
 }
 
 NS_CC_END
@@ -29,8 +29,9 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 #include <vector>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -42,6 +43,11 @@ THE SOFTWARE.
 NS_CC_BEGIN
 /////////////////////////////////////////////////////////////////////////////
 
+/** @brief AsyncTaskPool runs tasks in the background and calls their callbacks in the cocos thread.
+ IO and network tasks may block, so they don't use the workers of the ThreadPool, which also run the parallel updates of the frame:
+ each of these types has its own thread, started on its first task, and its tasks run one after the other in the order they were enqueued.
+ The other tasks run on the ThreadPool, concurrently and in any order.
+ */
 class CC_DLL AsyncTaskPool
 {
 public:
@@ -64,141 +70,95 @@ public:
     static void destoryInstance();
     
     /**
-     * stop tasks
+     * stop tasks, the tasks of this type that didn't start are dropped, and the callbacks of the running ones won't be called
      * @param type task type you want to stop
      */
     void stopTasks(TaskType type);
     
     /**
      * enqueue a asynchronous task
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others, it can be stopped by type.
+     *        IO and network tasks run one at a time on the thread of their type, the others on the ThreadPool.
      * @param callback callback when the task is finished. The callback is called in the main thread instead of task thread
      * @param callbackParam parameter used by the callback
      * @param f task can be lambda function
-     * @param args task parameters
+     * @param priority the priority of the task among the tasks of the ThreadPool, ignored for IO and network tasks
      */
     template<class F>
-    inline void enqueue(TaskType type, const TaskCallBack& callback, void* callbackParam, F&& f);
+    inline void enqueue(TaskType type, const TaskCallBack& callback, void* callbackParam, F&& f,
+                        ThreadPool::TaskPriority priority = ThreadPool::TaskPriority::NORMAL);
     
 CC_CONSTRUCTOR_ACCESS:
     AsyncTaskPool();
     ~AsyncTaskPool();
     
 protected:
+    struct Task
+    {
+        std::function<void()> work;
+        TaskCallBack callback;
+        void* callbackParam;
+        ThreadPool::TaskPriority priority;
+        ThreadPool::CancellationToken token;
+    };
     
-    // thread tasks internally used
-    class ThreadTasks {
-        struct AsyncTaskCallBack
-        {
-            TaskCallBack          callback;
-            void*                 callbackParam;
-        };
+    // a thread running the tasks of a blocking type one after the other
+    class SerialQueue
+    {
     public:
-        ThreadTasks()
-        : _stop(false)
-        {
-            _thread = std::thread(
-                                  [this]
-                                  {
-                                      for(;;)
-                                      {
-                                          std::function<void()> task;
-                                          AsyncTaskCallBack callback;
-                                          {
-                                              std::unique_lock<std::mutex> lock(this->_queueMutex);
-                                              this->_condition.wait(lock,
-                                                                    [this]{ return this->_stop || !this->_tasks.empty(); });
-                                              if(this->_stop && this->_tasks.empty())
-                                                  return;
-                                              task = std::move(this->_tasks.front());
-                                              callback = std::move(this->_taskCallBacks.front());
-                                              this->_tasks.pop();
-                                              this->_taskCallBacks.pop();
-                                          }
-                                          
-                                          task();
-                                          Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, callback]{ callback.callback(callback.callbackParam); });
-                                      }
-                                  }
-                                  );
-        }
-        ~ThreadTasks()
-        {
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                _stop = true;
-                
-                while(_tasks.size())
-                    _tasks.pop();
-                while (_taskCallBacks.size())
-                    _taskCallBacks.pop();
-            }
-            _condition.notify_all();
-            _thread.join();
-        }
-        void clear()
-        {
-            std::unique_lock<std::mutex> lock(_queueMutex);
-            while(_tasks.size())
-                _tasks.pop();
-            while (_taskCallBacks.size())
-                _taskCallBacks.pop();
-        }
-        template<class F>
-        void enqueue(const TaskCallBack& callback, void* callbackParam, F&& f)
-        {
-            auto task = f;//std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-            
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                
-                // don't allow enqueueing after stopping the pool
-                if(_stop)
-                {
-                    CC_ASSERT(0 && "already stop");
-                    return;
-                }
-                
-                AsyncTaskCallBack taskCallBack;
-                taskCallBack.callback = callback;
-                taskCallBack.callbackParam = callbackParam;
-                _tasks.emplace([task](){ task(); });
-                _taskCallBacks.emplace(taskCallBack);
-            }
-            _condition.notify_one();
-        }
+        SerialQueue();
+        // the running task completes, the others are dropped
+        ~SerialQueue();
+        
+        void enqueue(Task&& task);
+        void clear();
+        
     private:
+        void threadLoop();
         
-        // need to keep track of thread so we can join them
         std::thread _thread;
-        // the task queue
-        std::queue< std::function<void()> > _tasks;
-        std::queue<AsyncTaskCallBack>            _taskCallBacks;
-        
-        // synchronization
-        std::mutex _queueMutex;
+        std::deque<Task> _tasks;
+        std::mutex _mutex;
         std::condition_variable _condition;
         bool _stop;
     };
     
-    //tasks
-    ThreadTasks _threadTasks[int(TaskType::TASK_MAX_TYPE)];
+    static bool isBlocking(TaskType type) { return type == TaskType::TASK_IO || type == TaskType::TASK_NETWORK; }
+    
+    void enqueueTask(TaskType type, Task&& task);
+    // runs the work of a task then queues its callback, unless the task was cancelled
+    static void runTask(Task& task);
+    
+    // cancels the tasks of a type when it is stopped, then replaced by a new token
+    ThreadPool::CancellationToken _tokens[int(TaskType::TASK_MAX_TYPE)];
+    // the threads of the blocking types, nullptr until their first task
+    SerialQueue* _serialQueues[int(TaskType::TASK_MAX_TYPE)];
+    std::mutex _mutex;
     
     static AsyncTaskPool* s_asyncTaskPool;
 };
 
 inline void AsyncTaskPool::stopTasks(TaskType type)
 {
-    auto& threadTask = _threadTasks[(int)type];
-    threadTask.clear();
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_serialQueues[(int)type])
+    {
+        _serialQueues[(int)type]->clear();
+    }
+    _tokens[(int)type].cancel();
+    _tokens[(int)type] = ThreadPool::CancellationToken();
 }
 
 template<class F>
-inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, const TaskCallBack& callback, void* callbackParam, F&& f)
+inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, const TaskCallBack& callback, void* callbackParam, F&& f,
+                                   ThreadPool::TaskPriority priority)
 {
-    auto& threadTask = _threadTasks[(int)type];
-    
-    threadTask.enqueue(callback, callbackParam, f);
+    Task task;
+    task.work = std::forward<F>(f);
+    task.callback = callback;
+    task.callbackParam = callbackParam;
+    task.priority = priority;
+    enqueueTask(type, std::move(task));
 }
 
 NS_CC_END
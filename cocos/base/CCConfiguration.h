@@ -110,6 +110,12 @@ public:
      @since v2.0.0
      */
 	bool supportsShareableVAO() const;
+
+    /** Whether or not glMapBufferRange with unsynchronized writes can be used.
+     Only queried on the platforms using GLEW (Windows and Linux).
+     @since v4.0
+     */
+    bool supportsMapBufferRange() const;
     
     /** Max support directional light in shader, for Sprite3D
      @since v3.3
@@ -162,6 +168,7 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsMapBufferRange;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
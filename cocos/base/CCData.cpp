@@ -49,7 +49,16 @@ _bytes(nullptr),
 _size(0)
 {
     CCLOGINFO("In the copy constructor of Data.");
-    copy(other._bytes, other._size);
+    if (other._sharedBuffer)
+    {
+        _bytes = other._bytes;
+        _size = other._size;
+        _sharedBuffer = other._sharedBuffer;
+    }
+    else
+    {
+        copy(other._bytes, other._size);
+    }
 }
 
 Data::~Data()
@@ -61,14 +70,31 @@ Data::~Data()
 Data& Data::operator= (const Data& other)
 {
     CCLOGINFO("In the copy assignment of Data.");
-    copy(other._bytes, other._size);
+    if (this == &other)
+        return *this;
+
+    if (other._sharedBuffer)
+    {
+        clear();
+        _bytes = other._bytes;
+        _size = other._size;
+        _sharedBuffer = other._sharedBuffer;
+    }
+    else
+    {
+        copy(other._bytes, other._size);
+    }
     return *this;
 }
 
 Data& Data::operator= (Data&& other)
 {
     CCLOGINFO("In the move assignment of Data.");
-    move(other);
+    if (this != &other)
+    {
+        clear();
+        move(other);
+    }
     return *this;
 }
 
@@ -76,9 +102,11 @@ void Data::move(Data& other)
 {
     _bytes = other._bytes;
     _size = other._size;
+    _sharedBuffer = std::move(other._sharedBuffer);
     
     other._bytes = nullptr;
     other._size = 0;
+    other._sharedBuffer.reset();
 }
 
 bool Data::isNull() const
@@ -110,13 +138,84 @@ void Data::copy(const unsigned char* bytes, const ssize_t size)
 
 void Data::fastSet(unsigned char* bytes, const ssize_t size)
 {
+    _sharedBuffer.reset();
     _bytes = bytes;
     _size = size;
 }
 
+void Data::setSharedBuffer(unsigned char* bytes, const ssize_t size, const Deleter& deleter)
+{
+    clear();
+
+    if (bytes)
+    {
+        if (deleter)
+            _sharedBuffer = std::shared_ptr<unsigned char>(bytes, deleter);
+        else
+            _sharedBuffer = std::shared_ptr<unsigned char>(bytes, [](unsigned char*) {});
+        _bytes = bytes;
+        _size = size;
+    }
+}
+
+void Data::share()
+{
+    if (_bytes && !_sharedBuffer)
+    {
+        _sharedBuffer = std::shared_ptr<unsigned char>(_bytes, free);
+    }
+}
+
+Data Data::slice(ssize_t offset, ssize_t size) const
+{
+    Data ret;
+    if (_bytes == nullptr || offset < 0 || size <= 0 || offset > _size || size > _size - offset)
+        return ret;
+
+    // a const Data is never modified, so that it can be sliced from several threads
+    if (!_sharedBuffer)
+    {
+        ret.copy(_bytes + offset, size);
+        return ret;
+    }
+    ret._bytes = _bytes + offset;
+    ret._size = size;
+    ret._sharedBuffer = _sharedBuffer;
+    return ret;
+}
+
+unsigned char* Data::takeBuffer(ssize_t* size)
+{
+    unsigned char* buffer = nullptr;
+    *size = 0;
+    if (_bytes == nullptr)
+        return buffer;
+
+    if (_sharedBuffer)
+    {
+        buffer = (unsigned char*)malloc(sizeof(unsigned char) * _size);
+        if (buffer == nullptr)
+            return buffer;
+        memcpy(buffer, _bytes, _size);
+        *size = _size;
+        clear();
+    }
+    else
+    {
+        buffer = _bytes;
+        *size = _size;
+        _bytes = nullptr;
+        _size = 0;
+    }
+    return buffer;
+}
+
 void Data::clear()
 {
-    free(_bytes);
+    if (_sharedBuffer)
+        _sharedBuffer.reset();
+    else
+        free(_bytes);
     _bytes = nullptr;
     _size = 0;
 }
@@ -30,13 +30,29 @@
 #include <stdint.h> // for ssize_t on android
 #include <string>   // for ssize_t on linux
 #include "platform/CCStdC.h" // for ssize_t on window
+#include <memory>
+#include <functional>
 
 NS_CC_BEGIN
 
+/**
+ * A buffer of bytes.
+ *
+ * By default a Data owns a buffer allocated by 'malloc', which is copied along with the Data.
+ * A Data can also reference a shared buffer (a memory-mapped file, a network buffer...):
+ * the buffer is released by its deleter when the last Data referencing it is destroyed,
+ * and copies and slices of the Data reference the same bytes instead of copying them.
+ * The bytes of a shared buffer must not be modified.
+ */
 class CC_DLL Data
 {
 public:
     static const Data Null;
+
+    /** Releases a shared buffer, it receives the pointer passed to setSharedBuffer().
+     *  @since v4.0
+     */
+    typedef std::function<void(unsigned char* bytes)> Deleter;
     
     Data();
     Data(const Data& other);
@@ -70,9 +86,46 @@ public:
      *         since in the destructor of Data, the buffer will be deleted by 'free'.
      *  @note 1. This method will move the ownship of 'bytes'pointer to Data,
      *        2. The pointer should not be used outside after it was passed to this method.
+     *        3. The previous buffer isn't freed, but the reference to a shared buffer is released.
      *  @see Data::copy
      */
     void fastSet(unsigned char* bytes, const ssize_t size);
+
+    /** Sets a shared buffer without copying it.
+     *  @param bytes The bytes of the buffer, which must not be modified.
+     *  @param size The size of the buffer.
+     *  @param deleter Called with 'bytes' when the last Data referencing the buffer is destroyed or cleared,
+     *                 it can be nullptr if the bytes outlive all the Data referencing them.
+     *  @since v4.0
+     */
+    void setSharedBuffer(unsigned char* bytes, const ssize_t size, const Deleter& deleter);
+
+    /** Makes an owned buffer shared, without copying it: this Data and its copies and slices reference it from now on.
+     *  @since v4.0
+     */
+    void share();
+
+    /** Returns a Data referencing a range of this one, without copying it if the buffer is shared.
+     *  The range of an owned buffer is copied, call share() first to reference it instead.
+     *  @param offset The offset of the range.
+     *  @param size The size of the range.
+     *  @return The slice, or Data::Null if the range is out of the buffer.
+     *  @since v4.0
+     */
+    Data slice(ssize_t offset, ssize_t size) const;
+
+    /** Checks whether the data references a shared buffer.
+     *  @since v4.0
+     */
+    bool isShared() const { return _sharedBuffer != nullptr; }
+
+    /** Takes the bytes as a buffer allocated by 'malloc', which must be freed by the caller.
+     *  The bytes of a shared buffer are copied. The data is empty afterwards.
+     *  @param size Set to the size of the buffer.
+     *  @return The buffer, or nullptr if the data is empty.
+     *  @since v4.0
+     */
+    unsigned char* takeBuffer(ssize_t* size);
     
     /** Clears data, free buffer and reset data size */
     void clear();
@@ -86,6 +139,8 @@ private:
 private:
     unsigned char* _bytes;
     ssize_t _size;
+    // owner of _bytes if they are shared
+    std::shared_ptr<unsigned char> _sharedBuffer;
 };
 
 NS_CC_END
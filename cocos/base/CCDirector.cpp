@@ -45,9 +45,11 @@ THE SOFTWARE.
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramStateCache.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCTextureTranscoder.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
 #include "2d/CCCamera.h"
+#include "2d/CCParticleSystem.h"
 #include "base/CCUserDefault.h"
 #include "base/ccFPSImages.h"
 #include "base/CCScheduler.h"
@@ -58,6 +60,7 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCThreadPool.h"
 #include "platform/CCApplication.h"
 //#include "platform/CCGLViewImpl.h"
 
@@ -107,7 +110,9 @@ Director* Director::getInstance()
 }
 
 Director::Director()
-: _isStatusLabelUpdated(true)
+: _isParallelTransformUpdateEnabled(false)
+, _isParallelParticleUpdateEnabled(false)
+, _isStatusLabelUpdated(true)
 {
 }
 
@@ -126,7 +131,7 @@ bool Director::init(void)
     // FPS
     _accumDt = 0.0f;
     _frameRate = 0.0f;
-    _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = nullptr;
+    _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = _uploadedBytesLabel = nullptr;
     _totalFrames = 0;
     _lastUpdate = new struct timeval;
     _secondsPerFrame = 1.0f;
@@ -181,6 +186,7 @@ Director::~Director(void)
     CC_SAFE_RELEASE(_FPSLabel);
     CC_SAFE_RELEASE(_drawnVerticesLabel);
     CC_SAFE_RELEASE(_drawnBatchesLabel);
+    CC_SAFE_RELEASE(_uploadedBytesLabel);
 
     CC_SAFE_RELEASE(_runningScene);
     CC_SAFE_RELEASE(_notificationNode);
@@ -255,6 +261,46 @@ void Director::setGLDefaultValues()
     setProjection(_projection);
 }
 
+void Director::deferParticleSystemUpdate(ParticleSystem* system)
+{
+    system->retain();
+    _deferredParticleSystems.push_back(system);
+}
+
+void Director::updateDeferredParticleSystems()
+{
+    if (_deferredParticleSystems.empty())
+    {
+        return;
+    }
+    
+    // the systems only touch their own particles and buffers while they are simulated
+    auto& systems = _deferredParticleSystems;
+    ThreadPool::getInstance()->parallelFor((int)systems.size(), [&systems](int index) {
+        auto system = systems[index];
+        system->simulate(system->_deferredUpdateDt);
+    });
+    
+    // the finished systems are removed on the cocos thread
+    for (auto system : systems)
+    {
+        system->_isUpdateDeferred = false;
+        system->finishUpdate();
+        system->release();
+    }
+    systems.clear();
+}
+
+void Director::clearDeferredParticleSystems()
+{
+    for (auto system : _deferredParticleSystems)
+    {
+        system->_isUpdateDeferred = false;
+        system->release();
+    }
+    _deferredParticleSystems.clear();
+}
+
 // Draw the Scene
 void Director::drawScene()
 {
@@ -270,6 +316,7 @@ void Director::drawScene()
     if (! _paused)
     {
         _scheduler->update(_deltaTime);
+        updateDeferredParticleSystems();
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
 
@@ -917,6 +964,7 @@ void Director::reset()
 {
     // cleanup scheduler
     getScheduler()->unscheduleAll();
+    clearDeferredParticleSystems();
     
     // Remove all events
     if (_eventDispatcher)
@@ -943,6 +991,7 @@ void Director::reset()
     CC_SAFE_RELEASE_NULL(_FPSLabel);
     CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+    CC_SAFE_RELEASE_NULL(_uploadedBytesLabel);
     
     // purge bitmap cache
     FontFNT::purgeCachedData();
@@ -955,12 +1004,17 @@ void Director::reset()
     SpriteFrameCache::destroyInstance();
     GLProgramCache::destroyInstance();
     GLProgramStateCache::destroyInstance();
-    FileUtils::destroyInstance();
-    AsyncTaskPool::destoryInstance();
     
     // cocos2d-x specific data structures
+    // before the ThreadPool, which may be writing its file
     UserDefault::destroyInstance();
     
+    FileUtils::destroyInstance();
+    AsyncTaskPool::destoryInstance();
+    ThreadPool::destroyInstance();
+    // after the ThreadPool, which may be loading textures with it
+    TextureTranscoder::destroyInstance();
+    
     GL::invalidateStateCache();
     
     destroyTextureCache();
@@ -1080,14 +1134,17 @@ void Director::showStats()
     }
     static unsigned long prevCalls = 0;
     static unsigned long prevVerts = 0;
+    static unsigned long prevUploadedBytes = 0;
+    static unsigned long prevWraps = 0;
+    static unsigned long prevStalls = 0;
     static float prevDeltaTime  = 0.016f; // 60FPS
     static const float FPS_FILTER = 0.10f;
 
     _accumDt += _deltaTime;
     
-    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel)
+    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel && _uploadedBytesLabel)
     {
-        char buffer[30];
+        char buffer[40];
 
         float dt = _deltaTime * FPS_FILTER + (1-FPS_FILTER) * prevDeltaTime;
         prevDeltaTime = dt;
@@ -1117,7 +1174,20 @@ void Director::showStats()
             prevVerts = currentVerts;
         }
 
+        // vertex and index bytes streamed to the GPU, wraps of the streaming buffers and uploads that stalled
+        auto currentUploadedBytes = (unsigned long)_renderer->getUploadedBytes();
+        auto currentWraps = (unsigned long)_renderer->getStreamingBufferWraps();
+        auto currentStalls = (unsigned long)_renderer->getStalledUploads();
+        if( currentUploadedBytes != prevUploadedBytes || currentWraps != prevWraps || currentStalls != prevStalls ) {
+            sprintf(buffer, "GL upload:%5luK w:%lu s:%lu", currentUploadedBytes / 1024, currentWraps, currentStalls);
+            _uploadedBytesLabel->setString(buffer);
+            prevUploadedBytes = currentUploadedBytes;
+            prevWraps = currentWraps;
+            prevStalls = currentStalls;
+        }
+
         const Mat4& identity = Mat4::IDENTITY;
+        _uploadedBytesLabel->visit(_renderer, identity, 0);
         _drawnVerticesLabel->visit(_renderer, identity, 0);
         _drawnBatchesLabel->visit(_renderer, identity, 0);
         _FPSLabel->visit(_renderer, identity, 0);
@@ -1152,15 +1222,18 @@ void Director::createStatsLabel()
     std::string fpsString = "00.0";
     std::string drawBatchString = "000";
     std::string drawVerticesString = "00000";
+    std::string uploadedBytesString = "00000";
     if (_FPSLabel)
     {
         fpsString = _FPSLabel->getString();
         drawBatchString = _drawnBatchesLabel->getString();
         drawVerticesString = _drawnVerticesLabel->getString();
+        uploadedBytesString = _uploadedBytesLabel->getString();
         
         CC_SAFE_RELEASE_NULL(_FPSLabel);
         CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
         CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+        CC_SAFE_RELEASE_NULL(_uploadedBytesLabel);
         _textureCache->removeTextureForKey("/cc_fps_images");
         FileUtils::getInstance()->purgeCachedEntries();
     }
@@ -1209,10 +1282,16 @@ void Director::createStatsLabel()
     _drawnVerticesLabel->initWithString(drawVerticesString, texture, 12, 32, '.');
     _drawnVerticesLabel->setScale(scaleFactor);
 
+    _uploadedBytesLabel = LabelAtlas::create();
+    _uploadedBytesLabel->retain();
+    _uploadedBytesLabel->setIgnoreContentScaleFactor(true);
+    _uploadedBytesLabel->initWithString(uploadedBytesString, texture, 12, 32, '.');
+    _uploadedBytesLabel->setScale(scaleFactor);
 
     Texture2D::setDefaultAlphaPixelFormat(currentFormat);
 
     const int height_spacing = 22 / CC_CONTENT_SCALE_FACTOR();
+    _uploadedBytesLabel->setPosition(Vec2(0, height_spacing*3) + CC_DIRECTOR_STATS_POSITION);
     _drawnVerticesLabel->setPosition(Vec2(0, height_spacing*2) + CC_DIRECTOR_STATS_POSITION);
     _drawnBatchesLabel->setPosition(Vec2(0, height_spacing*1) + CC_DIRECTOR_STATS_POSITION);
     _FPSLabel->setPosition(Vec2(0, height_spacing*0)+CC_DIRECTOR_STATS_POSITION);
@@ -60,6 +60,7 @@ class Renderer;
 class Camera;
 
 class Console;
+class ParticleSystem;
 
 /**
 @brief Class that creates and handles the main Window and manages how
@@ -332,6 +333,35 @@ public:
 
     /** enables/disables OpenGL depth test */
     void setDepthTest(bool on);
+    
+    /**
+     * Enable/Disable computing the transforms of the running scene on the ThreadPool before it is visited.
+     * The scene graph is flattened in a TransformHierarchy and its large independent subtrees are updated in parallel.
+     * Overrides of Node::getNodeToParentTransform() must then be safe to call concurrently for nodes of different subtrees.
+     * Not used for scenes with a physics world. Disabled by default.
+     * @since v4.0
+     */
+    void setParallelTransformUpdateEnabled(bool enabled) { _isParallelTransformUpdateEnabled = enabled; }
+    /** returns whether the transforms of the running scene are computed on the ThreadPool */
+    bool isParallelTransformUpdateEnabled() const { return _isParallelTransformUpdateEnabled; }
+    
+    /**
+     * Enable/Disable simulating the particle systems on the ThreadPool.
+     * The scheduled updates of the particle systems only emit their new particles and sample their transforms,
+     * then the systems updated during the frame are simulated in parallel once the scheduler is done.
+     * Systems in a ParticleBatchNode are still simulated in their update. Disabled by default.
+     * @since v4.0
+     */
+    void setParallelParticleUpdateEnabled(bool enabled) { _isParallelParticleUpdateEnabled = enabled; }
+    /** returns whether the particle systems are simulated on the ThreadPool */
+    bool isParallelParticleUpdateEnabled() const { return _isParallelParticleUpdateEnabled; }
+    
+    /**
+     * Defers the simulation of a particle system to the parallel update of the frame. Called by ParticleSystem::update().
+     * @js NA
+     * @lua NA
+     */
+    void deferParticleSystemUpdate(ParticleSystem* system);
 
     virtual void mainLoop() = 0;
 
@@ -418,6 +448,11 @@ protected:
     /** calculates delta time since last time it was called */    
     void calculateDeltaTime();
 
+    /** simulates the particle systems deferred during the scheduler update, in parallel */
+    void updateDeferredParticleSystems();
+    /** releases the deferred particle systems without simulating them */
+    void clearDeferredParticleSystems();
+
     //textureCache creation or release
     void initTextureCache();
     void destroyTextureCache();
@@ -461,6 +496,10 @@ protected:
     bool _landscape;
     
     bool _displayStats;
+    bool _isParallelTransformUpdateEnabled;
+    bool _isParallelParticleUpdateEnabled;
+    /* particle systems to simulate in parallel after the scheduler update */
+    std::vector<ParticleSystem*> _deferredParticleSystems;
     float _accumDt;
     float _frameRate;
     
@@ -468,6 +507,7 @@ protected:
     LabelAtlas *_FPSLabel;
     LabelAtlas *_drawnBatchesLabel;
     LabelAtlas *_drawnVerticesLabel;
+    LabelAtlas *_uploadedBytesLabel;
     
     /** Whether or not the Director is paused */
     bool _paused;
@@ -0,0 +1,272 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "base/CCFunctionQueue.h"
+
+#include <algorithm>
+
+NS_CC_BEGIN
+
+static inline uint64_t makeFreeNodes(uint32_t index, uint32_t counter)
+{
+    return ((uint64_t)counter << 32) | index;
+}
+
+static inline uint32_t freeNodesIndex(uint64_t freeNodes)
+{
+    return (uint32_t)(freeNodes & 0xffffffff);
+}
+
+static inline uint32_t freeNodesCounter(uint64_t freeNodes)
+{
+    return (uint32_t)(freeNodes >> 32);
+}
+
+FunctionQueue::FunctionQueue()
+: _head(&_stub)
+, _performedCount(0)
+, _maxLatency(0)
+, _averageLatency(0)
+{
+    _stub.next = nullptr;
+    _stub.index = INVALID_INDEX;
+    _stub.invoke = nullptr;
+    _tail = &_stub;
+    _size = 0;
+
+    _freeNodes = makeFreeNodes(INVALID_INDEX, 0);
+    for (uint32_t i = 0; i < MAX_CHUNK_COUNT; ++i)
+    {
+        _chunks[i] = nullptr;
+    }
+    _chunkCount = 0;
+}
+
+FunctionQueue::~FunctionQueue()
+{
+    while (Node* node = pop())
+    {
+        node->invoke(node, false);
+        freeNode(node);
+    }
+    // a node still being pushed can't be popped, it is lost with its function
+
+    uint32_t chunkCount = _chunkCount.load();
+    if (chunkCount > MAX_CHUNK_COUNT)
+    {
+        chunkCount = MAX_CHUNK_COUNT;
+    }
+    for (uint32_t i = 0; i < chunkCount; ++i)
+    {
+        delete [] _chunks[i].load();
+    }
+}
+
+ssize_t FunctionQueue::getSize() const
+{
+    return _size.load(std::memory_order_relaxed);
+}
+
+FunctionQueue::Node* FunctionQueue::allocateNode()
+{
+    uint64_t freeNodes = _freeNodes.load(std::memory_order_acquire);
+    while (freeNodesIndex(freeNodes) != INVALID_INDEX)
+    {
+        uint32_t index = freeNodesIndex(freeNodes);
+        Node* node = _chunks[index / CHUNK_SIZE].load(std::memory_order_acquire) + index % CHUNK_SIZE;
+        // the node may be taken by another thread meanwhile, the compare and swap fails then
+        uint32_t next = node->nextFree.load(std::memory_order_relaxed);
+        if (_freeNodes.compare_exchange_weak(freeNodes, makeFreeNodes(next, freeNodesCounter(freeNodes) + 1),
+                                             std::memory_order_acquire, std::memory_order_acquire))
+        {
+            return node;
+        }
+    }
+    return allocateChunk();
+}
+
+FunctionQueue::Node* FunctionQueue::allocateChunk()
+{
+    uint32_t chunk = _chunkCount.fetch_add(1);
+    if (chunk >= MAX_CHUNK_COUNT)
+    {
+        // the pool is full, the node is deleted once performed
+        Node* node = new Node;
+        node->index = INVALID_INDEX;
+        return node;
+    }
+
+    Node* nodes = new Node[CHUNK_SIZE];
+    for (uint32_t i = 0; i < CHUNK_SIZE; ++i)
+    {
+        nodes[i].index = chunk * CHUNK_SIZE + i;
+        nodes[i].nextFree.store(nodes[i].index + 1, std::memory_order_relaxed);
+    }
+    _chunks[chunk].store(nodes, std::memory_order_release);
+
+    // the first node is used right away, the others go to the free list
+    pushFreeNodes(&nodes[1], &nodes[CHUNK_SIZE - 1]);
+    return &nodes[0];
+}
+
+void FunctionQueue::freeNode(Node* node)
+{
+    if (node->index == INVALID_INDEX)
+    {
+        delete node;
+    }
+    else
+    {
+        pushFreeNodes(node, node);
+    }
+}
+
+void FunctionQueue::pushFreeNodes(Node* first, Node* last)
+{
+    uint64_t freeNodes = _freeNodes.load(std::memory_order_relaxed);
+    do
+    {
+        last->nextFree.store(freeNodesIndex(freeNodes), std::memory_order_relaxed);
+    } while (!_freeNodes.compare_exchange_weak(freeNodes, makeFreeNodes(first->index, freeNodesCounter(freeNodes) + 1),
+                                               std::memory_order_release, std::memory_order_relaxed));
+}
+
+void FunctionQueue::enqueue(Node* node)
+{
+    if (node != &_stub)
+    {
+        node->pushTime = Clock::now();
+        // counted before being linked, so that perform() never waits for more nodes than are pushed
+        _size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = _tail.exchange(node, std::memory_order_acq_rel);
+    // between the exchange and this store the queue is cut at previous, pop() stops there until it is linked
+    previous->next.store(node, std::memory_order_release);
+}
+
+FunctionQueue::Node* FunctionQueue::pop()
+{
+    Node* head = _head;
+    Node* next = head->next.load(std::memory_order_acquire);
+    if (head == &_stub)
+    {
+        if (next == nullptr)
+            return nullptr;
+        _head = next;
+        head = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr)
+    {
+        _head = next;
+        return head;
+    }
+
+    if (head != _tail.load(std::memory_order_acquire))
+    {
+        // another node is being pushed after head
+        return nullptr;
+    }
+
+    // head is the last node: put the stub behind it so that it can be taken out
+    enqueue(&_stub);
+    next = head->next.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+        _head = next;
+        return head;
+    }
+    return nullptr;
+}
+
+int FunctionQueue::perform(float timeBudget)
+{
+    auto start = Clock::now();
+    auto budget = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(timeBudget));
+
+    // the functions pushed by the performed ones are not counted
+    ssize_t count = _size.load(std::memory_order_relaxed);
+    int performed = 0;
+    Clock::duration maxLatency = Clock::duration::zero();
+    Clock::duration totalLatency = Clock::duration::zero();
+    // the performed nodes go back to the pool all at once
+    Node* firstFree = nullptr;
+    Node* lastFree = nullptr;
+
+    while (performed < count)
+    {
+        // reading the clock costs about as much as queueing a small function, it is only done to check the budget
+        if (timeBudget > 0 && performed > 0 && Clock::now() - start >= budget)
+            break;
+
+        Node* node = pop();
+        if (node == nullptr)
+            break;
+
+        // nodes pushed since start have no latency
+        if (node->pushTime < start)
+        {
+            auto latency = start - node->pushTime;
+            maxLatency = std::max(maxLatency, latency);
+            totalLatency += latency;
+        }
+
+        node->invoke(node, true);
+        ++performed;
+
+        if (node->index == INVALID_INDEX)
+        {
+            delete node;
+        }
+        else
+        {
+            if (lastFree == nullptr)
+            {
+                lastFree = node;
+            }
+            else
+            {
+                node->nextFree.store(firstFree->index, std::memory_order_relaxed);
+            }
+            firstFree = node;
+        }
+    }
+
+    if (firstFree != nullptr)
+    {
+        pushFreeNodes(firstFree, lastFree);
+    }
+    _size.fetch_sub(performed, std::memory_order_relaxed);
+
+    _performedCount = performed;
+    _maxLatency = std::chrono::duration<float>(maxLatency).count();
+    _averageLatency = performed > 0 ? std::chrono::duration<float>(totalLatency).count() / performed : 0;
+    return performed;
+}
+
+NS_CC_END
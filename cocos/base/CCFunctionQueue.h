@@ -0,0 +1,190 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CCFUNCTION_QUEUE_H_
+#define __CCFUNCTION_QUEUE_H_
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCStdC.h"
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+/** @brief FunctionQueue is a lock-free queue of functions pushed from any thread and performed on a single thread.
+
+ Pushing never takes a lock: a function is stored in a node taken from a pool, and the node is linked
+ at the tail of the queue with one atomic exchange. The nodes are recycled once their function is performed,
+ and functions whose captures fit in INLINE_STORAGE_SIZE bytes are stored in the node itself,
+ so pushing doesn't allocate memory once the pool is warm.
+
+ @since v4.0
+ */
+class CC_DLL FunctionQueue
+{
+public:
+    /** functions up to this size are stored in the queue nodes, larger ones are moved to the heap */
+    static const size_t INLINE_STORAGE_SIZE = 64;
+
+    FunctionQueue();
+    /** destroys the functions that were not performed, without calling them */
+    ~FunctionQueue();
+
+    /**
+     * Queues a function, or any callable object taking no argument. It is moved or copied in the queue.
+     * This method is thread safe.
+     */
+    template <typename F>
+    void push(F&& function)
+    {
+        typedef typename std::decay<F>::type Function;
+
+        Node* node = allocateNode();
+        storeFunction<Function>(node, std::forward<F>(function),
+                                std::integral_constant<bool, sizeof(Function) <= INLINE_STORAGE_SIZE
+                                                             && std::alignment_of<Function>::value <= std::alignment_of<Storage>::value>());
+        enqueue(node);
+    }
+
+    /**
+     * Performs the queued functions in the order they were pushed, and returns how many were performed.
+     * Functions pushed by the performed ones wait for the next call.
+     * It must always be called from the same thread.
+     *
+     * @param timeBudget if greater than 0, no function is started once this many seconds have passed,
+     * except the first one so that the queue always makes progress. The others stay queued.
+     */
+    int perform(float timeBudget = 0);
+
+    /** returns the number of functions waiting to be performed */
+    ssize_t getSize() const;
+    /** returns the number of functions performed in the last call to perform() */
+    int getPerformedCount() const { return _performedCount; }
+    /** returns the longest time, in seconds, that a function performed in the last call to perform() waited before that call started */
+    float getMaxLatency() const { return _maxLatency; }
+    /** returns the average time, in seconds, that the functions performed in the last call to perform() waited before that call started */
+    float getAverageLatency() const { return _averageLatency; }
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+    typedef std::aligned_storage<INLINE_STORAGE_SIZE>::type Storage;
+
+    struct Node
+    {
+        // link in the queue
+        std::atomic<Node*> next;
+        // index of the next node in the free list
+        std::atomic<uint32_t> nextFree;
+        // index in the pool, or INVALID_INDEX for the nodes allocated once the pool is full
+        uint32_t index;
+        // calls the function if asked to, then destroys it
+        void (*invoke)(Node* node, bool call);
+        Clock::time_point pushTime;
+        Storage storage;
+    };
+
+    static const uint32_t INVALID_INDEX = 0xffffffff;
+    // the pool grows by chunks of nodes, which are freed with the queue
+    static const uint32_t CHUNK_SIZE = 256;
+    static const uint32_t MAX_CHUNK_COUNT = 256;
+
+    template <typename Function>
+    static void invokeInline(Node* node, bool call)
+    {
+        Function* function = reinterpret_cast<Function*>(&node->storage);
+        if (call)
+        {
+            (*function)();
+        }
+        function->~Function();
+    }
+
+    template <typename Function>
+    static void invokeHeap(Node* node, bool call)
+    {
+        Function* function = *reinterpret_cast<Function**>(&node->storage);
+        if (call)
+        {
+            (*function)();
+        }
+        delete function;
+    }
+
+    template <typename Function, typename F>
+    static void storeFunction(Node* node, F&& function, std::true_type /*fitsInline*/)
+    {
+        new (&node->storage) Function(std::forward<F>(function));
+        node->invoke = &invokeInline<Function>;
+    }
+
+    template <typename Function, typename F>
+    static void storeFunction(Node* node, F&& function, std::false_type /*fitsInline*/)
+    {
+        *reinterpret_cast<Function**>(&node->storage) = new Function(std::forward<F>(function));
+        node->invoke = &invokeHeap<Function>;
+    }
+
+    Node* allocateNode();
+    Node* allocateChunk();
+    void freeNode(Node* node);
+    // pushes the nodes first to last, already linked by nextFree, on the free list
+    void pushFreeNodes(Node* first, Node* last);
+
+    void enqueue(Node* node);
+    // pops the oldest node, or returns nullptr if the queue is empty or the oldest node is still being pushed
+    Node* pop();
+
+    // consumer end of the queue, only used by the thread calling perform()
+    Node* _head;
+    std::atomic<Node*> _tail;
+    // placeholder keeping the queue non-empty, it is never performed nor freed
+    Node _stub;
+    std::atomic<ssize_t> _size;
+
+    // free list of the pool: index of the first node in the low 32 bits, and a counter in the high 32 bits
+    // bumped on each change, so that a node popped and pushed back meanwhile fails the compare and swap (ABA)
+    std::atomic<uint64_t> _freeNodes;
+    std::atomic<Node*> _chunks[MAX_CHUNK_COUNT];
+    std::atomic<uint32_t> _chunkCount;
+
+    int _performedCount;
+    float _maxLatency;
+    float _averageLatency;
+};
+
+// end of base group
+/// @}
+
+NS_CC_END
+
+#endif //__CCFUNCTION_QUEUE_H_
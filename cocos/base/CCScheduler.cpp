@@ -61,9 +61,6 @@ typedef struct _hashSelectorEntry
 {
     ccArray             *timers;
     void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
-    bool                currentTimerSalvaged;
     bool                paused;
     UT_hash_handle      hh;
 } tHashTimerEntry;
@@ -79,9 +76,24 @@ Timer::Timer()
 , _repeat(0)
 , _delay(0.0f)
 , _interval(0.0f)
+, _startTime(0)
+, _nextTime(0)
+, _sequence(0)
+, _heapIndex(-1)
+, _isDue(false)
 {
 }
 
+void Timer::setInterval(float interval)
+{
+    _interval = interval;
+    
+    if (_scheduler)
+    {
+        _scheduler->rescheduleTimer(this);
+    }
+}
+
 void Timer::setupTimerWithInterval(float seconds, unsigned int repeat, float delay)
 {
 	_elapsed = -1;
@@ -90,6 +102,38 @@ void Timer::setupTimerWithInterval(float seconds, unsigned int repeat, float del
 	_useDelay = (_delay > 0.0f) ? true : false;
 	_repeat = repeat;
 	_runForever = (_repeat == CC_REPEAT_FOREVER) ? true : false;
+    
+    if (_scheduler)
+    {
+        _scheduler->rescheduleTimer(this);
+    }
+}
+
+void Timer::fire(double time)
+{
+    // same steps as update(), with the elapsed time given by the scheduler time
+    _elapsed = (float)(time - _startTime);
+    if (_useDelay)
+    {
+        _startTime += _delay;
+        _timesExecuted += 1;
+        _useDelay = false;
+    }
+    else
+    {
+        _startTime = time;
+        if (!_runForever)
+        {
+            _timesExecuted += 1;
+        }
+    }
+    
+    trigger();
+    
+    if (!_runForever && _timesExecuted > _repeat)
+    {    //unschedule timer
+        cancel();
+    }
 }
 
 void Timer::update(float dt)
@@ -252,15 +296,14 @@ Scheduler::Scheduler(void)
 , _updatesPosList(nullptr)
 , _hashForUpdates(nullptr)
 , _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
+, _timerTime(0)
+, _timerSequence(0)
 , _updateHashLocked(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _performFunctionsTimeBudget(0)
 {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
 }
 
 Scheduler::~Scheduler(void)
@@ -275,6 +318,144 @@ void Scheduler::removeHashElement(_hashSelectorEntry *element)
     free(element);
 }
 
+// timer heap
+
+bool Scheduler::isTimerBefore(const Timer *a, const Timer *b)
+{
+    // timers due at the same time fire in the order they were added
+    return a->_nextTime < b->_nextTime || (a->_nextTime == b->_nextTime && (int)(a->_sequence - b->_sequence) < 0);
+}
+
+void Scheduler::siftTimerUp(int index)
+{
+    Timer *timer = _timerHeap[index];
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+        if (! isTimerBefore(timer, _timerHeap[parent]))
+        {
+            break;
+        }
+        _timerHeap[index] = _timerHeap[parent];
+        _timerHeap[index]->_heapIndex = index;
+        index = parent;
+    }
+    _timerHeap[index] = timer;
+    timer->_heapIndex = index;
+}
+
+void Scheduler::siftTimerDown(int index)
+{
+    int count = (int)_timerHeap.size();
+    Timer *timer = _timerHeap[index];
+    while (true)
+    {
+        int child = index * 2 + 1;
+        if (child >= count)
+        {
+            break;
+        }
+        if (child + 1 < count && isTimerBefore(_timerHeap[child + 1], _timerHeap[child]))
+        {
+            ++child;
+        }
+        if (! isTimerBefore(_timerHeap[child], timer))
+        {
+            break;
+        }
+        _timerHeap[index] = _timerHeap[child];
+        _timerHeap[index]->_heapIndex = index;
+        index = child;
+    }
+    _timerHeap[index] = timer;
+    timer->_heapIndex = index;
+}
+
+void Scheduler::addTimerToHeap(Timer *timer)
+{
+    if (timer->_elapsed == -1)
+    {
+        // not started yet, it starts in the next update like in Timer::update()
+        timer->_nextTime = _timerTime;
+    }
+    else
+    {
+        timer->_nextTime = timer->_startTime + (timer->_useDelay ? timer->_delay : timer->_interval);
+    }
+    timer->_sequence = _timerSequence++;
+    
+    _timerHeap.push_back(timer);
+    siftTimerUp((int)_timerHeap.size() - 1);
+}
+
+void Scheduler::removeTimerFromHeap(Timer *timer)
+{
+    int index = timer->_heapIndex;
+    timer->_heapIndex = -1;
+    
+    Timer *last = _timerHeap.back();
+    _timerHeap.pop_back();
+    if (last != timer)
+    {
+        _timerHeap[index] = last;
+        last->_heapIndex = index;
+        siftTimerUp(index);
+        siftTimerDown(last->_heapIndex);
+    }
+}
+
+void Scheduler::rescheduleTimer(Timer *timer)
+{
+    if (timer->_heapIndex >= 0)
+    {
+        removeTimerFromHeap(timer);
+        addTimerToHeap(timer);
+    }
+}
+
+void Scheduler::detachTimer(Timer *timer)
+{
+    if (timer->_heapIndex >= 0)
+    {
+        removeTimerFromHeap(timer);
+    }
+    timer->_isDue = false;
+}
+
+void Scheduler::pauseTimers(_hashSelectorEntry *element)
+{
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+        if (timer->_heapIndex >= 0 || timer->_isDue)
+        {
+            detachTimer(timer);
+            
+            // the elapsed time is frozen while the target is paused
+            if (timer->_elapsed != -1)
+            {
+                timer->_elapsed = (float)(_timerTime - timer->_startTime);
+            }
+        }
+    }
+}
+
+void Scheduler::resumeTimers(_hashSelectorEntry *element)
+{
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+        if (timer->_heapIndex < 0 && ! timer->_isDue)
+        {
+            if (timer->_elapsed != -1)
+            {
+                timer->_startTime = _timerTime - timer->_elapsed;
+            }
+            addTimerToHeap(timer);
+        }
+    }
+}
+
 void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
 {
     this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
@@ -327,6 +508,11 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
     ccArrayAppendObject(element->timers, timer);
     timer->release();
+    
+    if (! element->paused)
+    {
+        addTimerToHeap(timer);
+    }
 }
 
 void Scheduler::unschedule(const std::string &key, void *target)
@@ -351,30 +537,13 @@ void Scheduler::unschedule(const std::string &key, void *target)
 
             if (key == timer->getKey())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-
+                // a timer firing in the current update is retained by _dueTimers
+                detachTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
                 if (element->timers->num == 0)
                 {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
+                    removeHashElement(element);
                 }
 
                 return;
@@ -647,22 +816,12 @@ void Scheduler::unscheduleAllForTarget(void *target)
 
     if (element)
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimerSalvaged))
-        {
-            element->currentTimer->retain();
-            element->currentTimerSalvaged = true;
-        }
-        ccArrayRemoveAllObjects(element->timers);
-
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
+        // the timers firing in the current update are retained by _dueTimers
+        for (int i = 0; i < element->timers->num; ++i)
         {
-            removeHashElement(element);
+            detachTimer(static_cast<Timer*>(element->timers->arr[i]));
         }
+        removeHashElement(element);
     }
 
     // update selector
@@ -699,9 +858,10 @@ void Scheduler::resumeTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && element->paused)
     {
         element->paused = false;
+        resumeTimers(element);
     }
 
     // update selector
@@ -721,9 +881,10 @@ void Scheduler::pauseTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && ! element->paused)
     {
         element->paused = true;
+        pauseTimers(element);
     }
 
     // update selector
@@ -772,7 +933,11 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        if (! element->paused)
+        {
+            element->paused = true;
+            pauseTimers(element);
+        }
         idsWithSelectors.insert(element->target);
     }
 
@@ -820,11 +985,7 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(const std::function<void ()> &function)
 {
-    _performMutex.lock();
-
-    _functionsToPerform.push_back(function);
-
-    _performMutex.unlock();
+    _functionsToPerform.push(function);
 }
 
 // main loop
@@ -871,44 +1032,48 @@ void Scheduler::update(float dt)
         }
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
+    // Custom selectors: only the due timers are taken out of the heap.
+    // They all are taken out before any fires, so that a timer fires at most once per update
+    _timerTime += dt;
+    while (! _timerHeap.empty() && _timerHeap[0]->_nextTime <= _timerTime)
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+        Timer *timer = _timerHeap[0];
+        removeTimerFromHeap(timer);
+        timer->_isDue = true;
+        // the timer may be unscheduled by the ones firing before it
+        timer->retain();
+        _dueTimers.push_back(timer);
+    }
 
-        if (! _currentTarget->paused)
+    for (size_t i = 0; i < _dueTimers.size(); ++i)
+    {
+        Timer *timer = _dueTimers[i];
+        
+        // not due anymore if it was unscheduled or paused in the meantime
+        if (timer->_isDue)
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
+            if (timer->_elapsed == -1)
             {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
-
-                elt->currentTimer = nullptr;
+                // first update, like in Timer::update()
+                timer->_elapsed = 0;
+                timer->_timesExecuted = 0;
+                timer->_startTime = _timerTime;
+            }
+            else
+            {
+                timer->fire(_timerTime);
+            }
+            
+            if (timer->_isDue)
+            {
+                timer->_isDue = false;
+                addTimerToHeap(timer);
             }
         }
-
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
-        {
-            removeHashElement(_currentTarget);
-        }
+        
+        timer->release();
     }
+    _dueTimers.clear();
 
     // delete all updates that are marked for deletion
     // updates with priority < 0
@@ -939,7 +1104,6 @@ void Scheduler::update(float dt)
     }
 
     _updateHashLocked = false;
-    _currentTarget = nullptr;
 
 #if CC_ENABLE_SCRIPT_BINDING
     //
@@ -967,19 +1131,9 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = _functionsToPerform;
-        _functionsToPerform.clear();
-        _performMutex.unlock();
-        for( const auto &function : temp ) {
-            function();
-        }
-        
-    }
+    // fixed #4123: the functions queued by the performed ones wait for the next update,
+    // so a function queueing itself can't keep this loop running
+    _functionsToPerform.perform(_performFunctionsTimeBudget);
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, unsigned int repeat, float delay, bool paused)
@@ -1028,6 +1182,11 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
     ccArrayAppendObject(element->timers, timer);
     timer->release();
+    
+    if (! element->paused)
+    {
+        addTimerToHeap(timer);
+    }
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, bool paused)
@@ -1092,30 +1251,13 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
             
             if (selector == timer->getSelector())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-                
+                // a timer firing in the current update is retained by _dueTimers
+                detachTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
                 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
                 if (element->timers->num == 0)
                 {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
+                    removeHashElement(element);
                 }
                 
                 return;
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include <set>
 
 #include "base/CCRef.h"
+#include "base/CCFunctionQueue.h"
 #include "base/CCVector.h"
 #include "base/uthash.h"
 
@@ -59,7 +60,7 @@ public:
     /** get interval in seconds */
     inline float getInterval() const { return _interval; };
     /** set interval in seconds */
-    inline void setInterval(float interval) { _interval = interval; };
+    void setInterval(float interval);
     
     void setupTimerWithInterval(float seconds, unsigned int repeat, float delay);
     
@@ -70,6 +71,10 @@ public:
     void update(float dt);
     
 protected:
+    friend class Scheduler;
+    
+    /** triggers the timer once it is due, at the given time of its scheduler */
+    void fire(double time);
     
     Scheduler* _scheduler; // weak ref
     float _elapsed;
@@ -79,6 +84,13 @@ protected:
     unsigned int _repeat; //0 = once, 1 is 2 x executed
     float _delay;
     float _interval;
+    
+    // scheduling in the timer heap of the scheduler
+    double _startTime; // time of the scheduler _elapsed is counted from
+    double _nextTime; // time of the scheduler the timer fires at
+    unsigned int _sequence; // orders the timers firing at the same time
+    int _heapIndex; // index in the heap, -1 if it isn't in it
+    bool _isDue; // taken out of the heap to fire in the current update
 };
 
 
@@ -162,10 +174,13 @@ There are 2 different types of callbacks (selectors):
 - custom selector: A custom selector will be called every frame, or with a custom interval of time
 
 The 'custom selectors' should be avoided when possible. It is faster, and consumes less memory to use the 'update selector'.
+The custom selectors are kept in a binary heap ordered by the time they are due, so an update only touches the ones that are due.
 
 */
 class CC_DLL Scheduler : public Ref
 {
+    friend class Timer;
+    
 public:
     // Priority level reserved for system services.
     static const int PRIORITY_SYSTEM;
@@ -364,6 +379,45 @@ public:
      */
     void performFunctionInCocosThread( const std::function<void()> &function);
     
+    /** calls a function, or any callable object taking no argument, on the cocos2d thread.
+     Unlike the std::function version, it doesn't allocate memory when its captures fit in FunctionQueue::INLINE_STORAGE_SIZE bytes.
+     This function is thread safe and doesn't take a lock.
+     @since v4.0
+     */
+    template <typename F>
+    void performFunctionInCocosThread(F&& function)
+    {
+        _functionsToPerform.push(std::forward<F>(function));
+    }
+    
+    /** Sets how long, in seconds, update() may spend calling the functions queued by performFunctionInCocosThread().
+     Once it is spent, the remaining functions wait for the next frames. At least one function is called per frame.
+     0, the default, calls all the functions queued before the update.
+     @since v4.0
+     */
+    void setPerformFunctionsTimeBudget(float seconds) { _performFunctionsTimeBudget = seconds; }
+    /** returns how long update() may spend calling the functions queued by performFunctionInCocosThread(), 0 if unlimited
+     @since v4.0
+     */
+    float getPerformFunctionsTimeBudget() const { return _performFunctionsTimeBudget; }
+    
+    /** returns the number of functions queued by performFunctionInCocosThread() and not called yet
+     @since v4.0
+     */
+    ssize_t getPerformFunctionsQueueSize() const { return _functionsToPerform.getSize(); }
+    /** returns the number of functions queued by performFunctionInCocosThread() that the last update() called
+     @since v4.0
+     */
+    int getPerformedFunctionsCount() const { return _functionsToPerform.getPerformedCount(); }
+    /** returns the longest time, in seconds, that a function called in the last update() waited before that update started calling them
+     @since v4.0
+     */
+    float getPerformFunctionsMaxLatency() const { return _functionsToPerform.getMaxLatency(); }
+    /** returns the average time, in seconds, that the functions called in the last update() waited before that update started calling them
+     @since v4.0
+     */
+    float getPerformFunctionsAverageLatency() const { return _functionsToPerform.getAverageLatency(); }
+    
     /////////////////////////////////////
     
     // Deprecated methods:
@@ -436,6 +490,20 @@ protected:
     void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
 
+    // timers specific
+
+    void addTimerToHeap(Timer *timer);
+    void removeTimerFromHeap(Timer *timer);
+    // updates the position of a timer in the heap after its interval changed
+    void rescheduleTimer(Timer *timer);
+    // takes a timer out of the heap, and out of the due timers of the current update
+    void detachTimer(Timer *timer);
+    void pauseTimers(struct _hashSelectorEntry *element);
+    void resumeTimers(struct _hashSelectorEntry *element);
+    static bool isTimerBefore(const Timer *a, const Timer *b);
+    void siftTimerUp(int index);
+    void siftTimerDown(int index);
+
 
     float _timeScale;
 
@@ -449,8 +517,13 @@ protected:
 
     // Used for "selectors with interval"
     struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
+    // min-heap of the timers of the targets that aren't paused, by time they are due
+    std::vector<Timer*> _timerHeap;
+    // timers firing in the current update, retained
+    std::vector<Timer*> _dueTimers;
+    // sum of the scaled dt of the updates
+    double _timerTime;
+    unsigned int _timerSequence;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
     
@@ -459,8 +532,8 @@ protected:
 #endif
     
     // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    FunctionQueue _functionsToPerform;
+    float _performFunctionsTimeBudget;
 };
 
 // end of global group
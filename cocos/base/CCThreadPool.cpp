@@ -0,0 +1,326 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "base/CCThreadPool.h"
+
+#include <algorithm>
+
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+
+NS_CC_BEGIN
+
+static inline uint64_t makeRange(uint32_t begin, uint32_t end)
+{
+    return ((uint64_t)end << 32) | begin;
+}
+
+static inline uint32_t rangeBegin(uint64_t range)
+{
+    return (uint32_t)(range & 0xffffffff);
+}
+
+static inline uint32_t rangeEnd(uint64_t range)
+{
+    return (uint32_t)(range >> 32);
+}
+
+ThreadPool* ThreadPool::s_threadPool = nullptr;
+
+ThreadPool* ThreadPool::getInstance()
+{
+    if (s_threadPool == nullptr)
+    {
+        // the background tasks need a worker thread even on a single core
+        int threadCount = (int)std::thread::hardware_concurrency() - 1;
+        s_threadPool = new (std::nothrow) ThreadPool(std::max(threadCount, 1));
+    }
+    return s_threadPool;
+}
+
+void ThreadPool::destroyInstance()
+{
+    CC_SAFE_DELETE(s_threadPool);
+}
+
+ThreadPool::ThreadPool(int threadCount)
+: _ranges(nullptr)
+, _participantCount(threadCount + 1)
+, _job(nullptr)
+, _activeThreads(0)
+, _generation(0)
+, _stop(false)
+, _taskQueues(nullptr)
+{
+    _pendingJobs = 0;
+    _queuedTasks = 0;
+    _nextTaskQueue = 0;
+    _taskQueues = new TaskQueue[std::max(threadCount, 1)];
+    _ranges = new JobRange[_participantCount];
+    for (int i = 0; i < _participantCount; ++i)
+    {
+        _ranges[i].range = 0;
+    }
+    for (int i = 0; i < threadCount; ++i)
+    {
+        _threads.push_back(std::thread(&ThreadPool::threadLoop, this, i + 1));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wakeCondition.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+    CC_SAFE_DELETE_ARRAY(_ranges);
+    // tasks that didn't start are dropped with their callbacks
+    CC_SAFE_DELETE_ARRAY(_taskQueues);
+}
+
+void ThreadPool::parallelFor(int jobCount, const std::function<void(int)>& job)
+{
+    if (jobCount <= 0)
+        return;
+    
+    if (_threads.empty() || jobCount == 1)
+    {
+        for (int i = 0; i < jobCount; ++i)
+        {
+            job(i);
+        }
+        return;
+    }
+    
+    std::lock_guard<std::mutex> runLock(_runMutex);
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        // threads still leaving the previous run may be reading the job state
+        _doneCondition.wait(lock, [this]{ return _activeThreads == 0; });
+        
+        _job = &job;
+        _pendingJobs = jobCount;
+        for (int i = 0; i < _participantCount; ++i)
+        {
+            uint32_t begin = (uint32_t)((int64_t)jobCount * i / _participantCount);
+            uint32_t end = (uint32_t)((int64_t)jobCount * (i + 1) / _participantCount);
+            _ranges[i].range = makeRange(begin, end);
+        }
+        ++_generation;
+    }
+    _wakeCondition.notify_all();
+    
+    runJobs(0);
+    
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCondition.wait(lock, [this]{ return _pendingJobs == 0; });
+    _job = nullptr;
+}
+
+void ThreadPool::enqueue(const std::function<void()>& task, TaskPriority priority,
+                         const std::function<void()>& callback, const CancellationToken* token)
+{
+    CCASSERT(task, "task must not be null");
+    
+    if (_threads.empty())
+    {
+        // no thread can run it, e.g. if the pool was created without workers
+        Task inlineTask = { task, callback, token ? token->_cancelled : nullptr };
+        runTask(inlineTask);
+        return;
+    }
+    
+    auto& queue = _taskQueues[_nextTaskQueue++ % _threads.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        Task queued = { task, callback, token ? token->_cancelled : nullptr };
+        queue.tasks[(int)priority].push_back(std::move(queued));
+        ++_queuedTasks;
+    }
+    {
+        // lock so that a worker checking _queuedTasks can't miss the notification
+        std::lock_guard<std::mutex> lock(_mutex);
+    }
+    _wakeCondition.notify_one();
+}
+
+bool ThreadPool::popTask(int worker, Task* task)
+{
+    int queueCount = (int)_threads.size();
+    for (int priority = 0; priority < TASK_PRIORITY_COUNT; ++priority)
+    {
+        for (int offset = 0; offset < queueCount; ++offset)
+        {
+            auto& queue = _taskQueues[(worker + offset) % queueCount];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto& tasks = queue.tasks[priority];
+            if (tasks.empty())
+                continue;
+            
+            // the worker takes its oldest task, thieves take the newest one
+            if (offset == 0)
+            {
+                *task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            else
+            {
+                *task = std::move(tasks.back());
+                tasks.pop_back();
+            }
+            --_queuedTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTask(Task& task)
+{
+    auto cancelled = task.cancelled;
+    if (cancelled && *cancelled)
+        return;
+    
+    task.work();
+    
+    if (task.callback)
+    {
+        auto callback = std::move(task.callback);
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([callback, cancelled]{
+            if (!cancelled || !*cancelled)
+                callback();
+        });
+    }
+}
+
+void ThreadPool::threadLoop(int participant)
+{
+    unsigned int generation = 0;
+    for (;;)
+    {
+        bool runParallelJobs = false;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeCondition.wait(lock, [this, generation]{ return _stop || _generation != generation || _queuedTasks > 0; });
+            if (_stop)
+                return;
+            // jobs of parallelFor() go first, a thread is waiting on them
+            if (_generation != generation)
+            {
+                generation = _generation;
+                ++_activeThreads;
+                runParallelJobs = true;
+            }
+        }
+        
+        if (runParallelJobs)
+        {
+            runJobs(participant);
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                --_activeThreads;
+            }
+            _doneCondition.notify_all();
+        }
+        else
+        {
+            Task task;
+            if (popTask(participant - 1, &task))
+            {
+                runTask(task);
+            }
+        }
+    }
+}
+
+void ThreadPool::runJobs(int participant)
+{
+    int done = 0;
+    int index;
+    do
+    {
+        while (popJob(participant, &index))
+        {
+            (*_job)(index);
+            ++done;
+        }
+    } while (stealJobs(participant));
+    
+    if (done > 0 && _pendingJobs.fetch_sub(done) == done)
+    {
+        // lock so that the wait in parallelFor() can't miss the notification
+        std::lock_guard<std::mutex> lock(_mutex);
+        _doneCondition.notify_all();
+    }
+}
+
+bool ThreadPool::popJob(int participant, int* index)
+{
+    auto& owned = _ranges[participant].range;
+    uint64_t range = owned.load();
+    for (;;)
+    {
+        uint32_t begin = rangeBegin(range);
+        uint32_t end = rangeEnd(range);
+        if (begin >= end)
+            return false;
+        if (owned.compare_exchange_weak(range, makeRange(begin + 1, end)))
+        {
+            *index = (int)begin;
+            return true;
+        }
+    }
+}
+
+bool ThreadPool::stealJobs(int participant)
+{
+    for (int offset = 1; offset < _participantCount; ++offset)
+    {
+        auto& victim = _ranges[(participant + offset) % _participantCount].range;
+        uint64_t range = victim.load();
+        for (;;)
+        {
+            uint32_t begin = rangeBegin(range);
+            uint32_t end = rangeEnd(range);
+            if (begin >= end)
+                break;
+            // take the upper half, the victim keeps popping from the front of its range
+            uint32_t middle = end - (end - begin + 1) / 2;
+            if (victim.compare_exchange_weak(range, makeRange(begin, middle)))
+            {
+                _ranges[participant].range = makeRange(middle, end);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+NS_CC_END
@@ -0,0 +1,186 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CCTHREAD_POOL_H_
+#define __CCTHREAD_POOL_H_
+
+#include "platform/CCPlatformMacros.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+/** @brief ThreadPool owns a set of worker threads shared by the engine systems that split their work in jobs,
+ or that run work in the background, like loading assets.
+ 
+ Work is distributed with work stealing: for parallelFor(), each thread starts with its own contiguous range of jobs and,
+ once it runs out, steals half of the remaining range of another thread. This keeps the threads busy
+ when the jobs don't have the same cost, without a shared queue to contend on.
+ Background tasks are spread over per-thread queues, a thread with nothing left to do steals from the others.
+ 
+ @since v4.0
+ */
+class CC_DLL ThreadPool
+{
+public:
+    /** Background tasks of a higher priority are started before the tasks of lower priorities. */
+    enum class TaskPriority
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+    };
+    /** number of TaskPriority values */
+    static const int TASK_PRIORITY_COUNT = 3;
+    
+    /** @brief Cancels the background tasks it was passed to.
+     
+     Copies share the same state, so a copy can be kept to cancel the tasks later.
+     Tasks that didn't start yet are skipped, and the completion callbacks of the tasks that didn't complete yet are not called.
+     */
+    class CC_DLL CancellationToken
+    {
+    public:
+        CancellationToken() : _cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+        
+        /** cancels the tasks using this token */
+        void cancel() { *_cancelled = true; }
+        /** returns whether cancel() was called */
+        bool isCancelled() const { return *_cancelled; }
+        
+    private:
+        std::shared_ptr<std::atomic<bool>> _cancelled;
+        
+        friend class ThreadPool;
+    };
+    
+    /** returns the shared ThreadPool, using one worker thread less than the number of hardware threads, and at least one */
+    static ThreadPool* getInstance();
+    
+    /** destroys the shared ThreadPool, joining its threads */
+    static void destroyInstance();
+    
+    /** returns the number of worker threads, not counting the threads calling parallelFor() */
+    int getThreadCount() const { return (int)_threads.size(); }
+    
+    /**
+     * Runs job(0) to job(jobCount - 1) on the worker threads and the calling thread, and returns once all of them are done.
+     * Jobs may run in any order and concurrently, so they must only write to data no other job touches.
+     * Calls from different threads are serialized. It must not be called from inside a job.
+     */
+    void parallelFor(int jobCount, const std::function<void(int)>& job);
+    
+    /**
+     * Runs a task in the background on one of the worker threads.
+     * Tasks may run concurrently and in any order, except that a task is never started before a queued task of higher priority.
+     * Tasks waiting on I/O keep their thread busy, they should not be used to wait on each other.
+     *
+     * @param task the work to do on the worker thread
+     * @param priority the priority of the task
+     * @param callback if not null, called on the cocos thread once the task completed
+     * @param token if not null, can cancel the task and its callback. It is copied.
+     */
+    void enqueue(const std::function<void()>& task, TaskPriority priority = TaskPriority::NORMAL,
+                 const std::function<void()>& callback = nullptr, const CancellationToken* token = nullptr);
+    
+    /** returns the number of background tasks waiting for a thread, cancelled ones included */
+    int getQueuedTaskCount() const { return _queuedTasks; }
+    
+CC_CONSTRUCTOR_ACCESS:
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+    
+protected:
+    // range of jobs owned by a thread, begin in the low 32 bits and end in the high 32 bits.
+    // padded to a cache line so that threads popping their own range don't share it
+    struct JobRange
+    {
+        std::atomic<uint64_t> range;
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+    };
+    
+    struct Task
+    {
+        std::function<void()> work;
+        std::function<void()> callback;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+    
+    // background tasks queued on a worker thread, one deque per priority
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks[TASK_PRIORITY_COUNT];
+    };
+    
+    void threadLoop(int participant);
+    void runJobs(int participant);
+    bool popJob(int participant, int* index);
+    bool stealJobs(int participant);
+    // pops the task of highest priority, from the queue of the worker first, then from the others
+    bool popTask(int worker, Task* task);
+    void runTask(Task& task);
+    
+    std::vector<std::thread> _threads;
+    // one range per worker thread, plus one for the calling thread (index 0)
+    JobRange* _ranges;
+    int _participantCount;
+    
+    const std::function<void(int)>* _job;
+    std::atomic<int> _pendingJobs;
+    
+    std::mutex _runMutex;
+    std::mutex _mutex;
+    std::condition_variable _wakeCondition;
+    std::condition_variable _doneCondition;
+    int _activeThreads;
+    unsigned int _generation;
+    bool _stop;
+    
+    // one queue per worker thread
+    TaskQueue* _taskQueues;
+    std::atomic<int> _queuedTasks;
+    std::atomic<unsigned int> _nextTaskQueue;
+    
+    static ThreadPool* s_threadPool;
+};
+
+// end of base group
+/// @}
+
+NS_CC_END
+
+#endif //__CCTHREAD_POOL_H_
@@ -143,6 +143,7 @@ UserDefault::~UserDefault()
 }
 
 UserDefault::UserDefault()
+: _isDirty(false)
 {
 }
 
@@ -529,6 +530,10 @@ void UserDefault::flush()
 {
 }
 
+void UserDefault::flushAsync()
+{
+}
+
 NS_CC_END
 
 #endif // (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
@@ -143,6 +143,7 @@ UserDefault::~UserDefault()
 }
 
 UserDefault::UserDefault()
+: _isDirty(false)
 {
 }
 
@@ -552,6 +553,12 @@ void UserDefault::flush()
     [[NSUserDefaults standardUserDefaults] synchronize];
 }
 
+void UserDefault::flushAsync()
+{
+    // NSUserDefaults already saves on its own thread, synchronize only waits for it
+    flush();
+}
+
 
 NS_CC_END
 
@@ -28,6 +28,16 @@ THE SOFTWARE.
 #include "tinyxml2/tinyxml2.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
+#include "base/CCThreadPool.h"
+#include <mutex>
+#include <condition_variable>
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+#include <vector>
+#include <io.h>
+#include "platform/CCStdC.h"
+#else
+#include <unistd.h>
+#endif
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
@@ -42,99 +52,79 @@ NS_CC_BEGIN
 
 /**
  * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * export the file writing helpers in "CCUserDefault.h"
  */
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+// serializes the writes of flush() and flushAsync(), and drops the contents older than the last written one
+static std::mutex s_writeMutex;
+static unsigned int s_contentVersion = 0;
+static unsigned int s_writtenVersion = 0;
+// the number of flushAsync() writes not done yet
+static int s_pendingWrites = 0;
+static std::condition_variable s_writeCondition;
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+static std::wstring utf8ToWideChar(const std::string& str)
 {
-    tinyxml2::XMLElement* curNode = nullptr;
+    int length = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
+    std::vector<WCHAR> wideStr(length > 0 ? length : 1, 0);
+    MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, wideStr.data(), length);
+    return wideStr.data();
+}
+#endif
 
-    // check the key value
-    if (! pKey)
+static bool writeFileAtomically(const std::string& path, const std::string& content, unsigned int version)
+{
+    std::lock_guard<std::mutex> lock(s_writeMutex);
+    if (version <= s_writtenVersion)
     {
-        return nullptr;
+        return true;
     }
 
-    do 
+    std::string tmpPath = path + ".tmp";
+    FILE* fp = fopen(tmpPath.c_str(), "wb");
+    if (!fp)
     {
- 		tinyxml2::XMLDocument* xmlDoc = new tinyxml2::XMLDocument();
-		*doc = xmlDoc;
-
-        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getInstance()->getXMLFilePath());
-
-		if (xmlBuffer.empty())
-		{
-			CCLOG("can not read xml file");
-			break;
-		}
-		xmlDoc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
-
-		// get root node
-		*rootNode = xmlDoc->RootElement();
-		if (nullptr == *rootNode)
-		{
-			CCLOG("read root node error");
-			break;
-		}
-		// find the node
-		curNode = (*rootNode)->FirstChildElement();
-		while (nullptr != curNode)
-		{
-			const char* nodeName = curNode->Value();
-			if (!strcmp(nodeName, pKey))
-			{
-				break;
-			}
-
-			curNode = curNode->NextSiblingElement();
-		}
-	} while (0);
-
-	return curNode;
-}
-
-static void setValueForKey(const char* pKey, const char* pValue)
-{
- 	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	// check the params
-	if (! pKey || ! pValue)
-	{
-		return;
-	}
-	// find the node
-	node = getXMLNodeForKey(pKey, &rootNode, &doc);
-	// if node exist, change the content
-	if (node)
-	{
-        if (node->FirstChild())
-        {
-            node->FirstChild()->SetValue(pValue);
-        }
-        else
-        {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
-        }
-	}
-	else
-	{
-		if (rootNode)
-		{
-			tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-			rootNode->LinkEndChild(tmpNode);
-			tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-			tmpNode->LinkEndChild(content);
-		}	
-	}
+        CCLOG("can not open %s for writing", tmpPath.c_str());
+        return false;
+    }
+    bool ret = fwrite(content.c_str(), 1, content.size(), fp) == content.size();
+    ret = (fflush(fp) == 0) && ret;
+    // the content must be on the disk before the rename, or a crash could leave an empty file behind it
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    ret = ret && _commit(_fileno(fp)) == 0;
+#else
+    ret = ret && fsync(fileno(fp)) == 0;
+#endif
+    fclose(fp);
+
+    if (ret)
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+        std::wstring tmpPathW = utf8ToWideChar(tmpPath);
+        std::wstring pathW = utf8ToWideChar(path);
+        ret = MoveFileExW(tmpPathW.c_str(), pathW.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        ret = rename(tmpPath.c_str(), path.c_str()) == 0;
+#endif
+    }
 
-    // save file and free doc
-	if (doc)
-	{
-		doc->SaveFile(UserDefault::getInstance()->getXMLFilePath().c_str());
-		delete doc;
-	}
+    if (ret)
+    {
+        s_writtenVersion = version;
+    }
+    else
+    {
+        CCLOG("can not write %s", path.c_str());
+        remove(tmpPath.c_str());
+    }
+    return ret;
+}
+
+static void waitForPendingWrites()
+{
+    std::unique_lock<std::mutex> lock(s_writeMutex);
+    s_writeCondition.wait(lock, []{ return s_pendingWrites == 0; });
 }
 
 /**
@@ -147,74 +137,126 @@ bool UserDefault::_isFilePathInitialized = false;
 
 UserDefault::~UserDefault()
 {
+    flush();
+    waitForPendingWrites();
 }
 
 UserDefault::UserDefault()
+: _isDirty(false)
 {
+    loadXMLFile();
 }
 
-bool UserDefault::getBoolForKey(const char* pKey)
+void UserDefault::loadXMLFile()
 {
- return getBoolForKey(pKey, false);
-}
+    _values.clear();
+    _keys.clear();
 
-bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
-{
-    const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
+    // the file may be written by a previous instance
+    waitForPendingWrites();
 
-	bool ret = defaultValue;
+    std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(getXMLFilePath());
+    if (xmlBuffer.empty())
+    {
+        CCLOG("can not read xml file");
+        return;
+    }
 
-	if (value)
-	{
-		ret = (! strcmp(value, "true"));
-	}
+    tinyxml2::XMLDocument doc;
+    doc.Parse(xmlBuffer.c_str(), xmlBuffer.size());
 
-    if (doc) delete doc;
+    // get root node
+    tinyxml2::XMLElement* rootNode = doc.RootElement();
+    if (nullptr == rootNode)
+    {
+        CCLOG("read root node error");
+        return;
+    }
 
-	return ret;
+    for (tinyxml2::XMLElement* node = rootNode->FirstChildElement(); node; node = node->NextSiblingElement())
+    {
+        const char* value = node->FirstChild() ? node->FirstChild()->Value() : "";
+        // like the lookup in the file, the first node of a key wins
+        if (_values.emplace(node->Value(), value).second)
+        {
+            _keys.push_back(node->Value());
+        }
+    }
 }
 
-int UserDefault::getIntegerForKey(const char* pKey)
+std::string UserDefault::getXMLContent() const
 {
-    return getIntegerForKey(pKey, 0);
+    tinyxml2::XMLDocument doc;
+    doc.LinkEndChild(doc.NewDeclaration(nullptr));
+    tinyxml2::XMLElement* rootNode = doc.NewElement(USERDEFAULT_ROOT_NAME);
+    doc.LinkEndChild(rootNode);
+
+    for (const auto& key : _keys)
+    {
+        tinyxml2::XMLElement* node = doc.NewElement(key.c_str());
+        rootNode->LinkEndChild(node);
+        node->LinkEndChild(doc.NewText(_values.at(key).c_str()));
+    }
+
+    tinyxml2::XMLPrinter printer;
+    doc.Print(&printer);
+    return std::string(printer.CStr(), printer.CStrSize() - 1);
 }
 
-int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
+const std::string* UserDefault::getValueForKey(const char* pKey) const
 {
-	const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
+    // check the key value
+    if (! pKey)
+    {
+        return nullptr;
+    }
 
-	int ret = defaultValue;
+    auto iter = _values.find(pKey);
+    return iter != _values.end() ? &iter->second : nullptr;
+}
 
-	if (value)
-	{
-		ret = atoi(value);
-	}
+void UserDefault::setValueForKey(const char* pKey, const char* pValue)
+{
+    // check the params
+    if (! pKey || ! pValue)
+    {
+        return;
+    }
 
-	if(doc)
-	{
-		delete doc;
-	}
+    auto iter = _values.find(pKey);
+    if (iter == _values.end())
+    {
+        _values.emplace(pKey, pValue);
+        _keys.push_back(pKey);
+        _isDirty = true;
+    }
+    else if (iter->second != pValue)
+    {
+        iter->second = pValue;
+        _isDirty = true;
+    }
+}
 
+bool UserDefault::getBoolForKey(const char* pKey)
+{
+ return getBoolForKey(pKey, false);
+}
 
-	return ret;
+bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
+{
+    const std::string* value = getValueForKey(pKey);
+    return value ? (*value == "true") : defaultValue;
+}
+
+int UserDefault::getIntegerForKey(const char* pKey)
+{
+    return getIntegerForKey(pKey, 0);
+}
+
+int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
+{
+    const std::string* value = getValueForKey(pKey);
+    return value ? atoi(value->c_str()) : defaultValue;
 }
 
 float UserDefault::getFloatForKey(const char* pKey)
@@ -236,27 +278,8 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-	const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
-	double ret = defaultValue;
-
-	if (value)
-	{
-		ret = utils::atof(value);
-	}
-
-    if (doc) delete doc;
-
-	return ret;
+    const std::string* value = getValueForKey(pKey);
+    return value ? utils::atof(value->c_str()) : defaultValue;
 }
 
 std::string UserDefault::getStringForKey(const char* pKey)
@@ -266,27 +289,8 @@ std::string UserDefault::getStringForKey(const char* pKey)
 
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
-	string ret = defaultValue;
-
-	if (value)
-	{
-		ret = string(value);
-	}
-
-    if (doc) delete doc;
-
-	return ret;
+    const std::string* value = getValueForKey(pKey);
+    return value ? *value : defaultValue;
 }
 
 Data UserDefault::getDataForKey(const char* pKey)
@@ -296,31 +300,20 @@ Data UserDefault::getDataForKey(const char* pKey)
 
 Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
 {
-    const char* encodedData = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        encodedData = (const char*)(node->FirstChild()->Value());
-	}
+    const std::string* encodedData = getValueForKey(pKey);
     
 	Data ret = defaultValue;
     
 	if (encodedData)
 	{
         unsigned char * decodedData = nullptr;
-        int decodedDataLen = base64Decode((unsigned char*)encodedData, (unsigned int)strlen(encodedData), &decodedData);
+        int decodedDataLen = base64Decode((unsigned char*)encodedData->c_str(), (unsigned int)encodedData->size(), &decodedData);
         
         if (decodedData) {
             ret.fastSet(decodedData, decodedDataLen);
         }
 	}
     
-    if (doc) delete doc;
-    
 	return ret;    
 }
 
@@ -501,6 +494,40 @@ const string& UserDefault::getXMLFilePath()
 
 void UserDefault::flush()
 {
+    if (! _isDirty)
+    {
+        return;
+    }
+    _isDirty = false;
+
+    unsigned int version = ++s_contentVersion;
+    writeFileAtomically(_filePath, getXMLContent(), version);
+}
+
+void UserDefault::flushAsync()
+{
+    if (! _isDirty)
+    {
+        return;
+    }
+    _isDirty = false;
+
+    // the content is made here, the worker thread only writes it
+    unsigned int version = ++s_contentVersion;
+    std::string path = _filePath;
+    auto content = std::make_shared<std::string>(getXMLContent());
+    {
+        std::lock_guard<std::mutex> lock(s_writeMutex);
+        ++s_pendingWrites;
+    }
+    // not an AsyncTaskPool task, stopping the io tasks mustn't drop it
+    ThreadPool::getInstance()->enqueue([path, content, version]() {
+        writeFileAtomically(path, *content, version);
+
+        std::lock_guard<std::mutex> lock(s_writeMutex);
+        --s_pendingWrites;
+        s_writeCondition.notify_all();
+    }, ThreadPool::TaskPriority::LOW);
 }
 
 NS_CC_END
@@ -27,6 +27,8 @@ THE SOFTWARE.
 
 #include "platform/CCPlatformMacros.h"
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "base/CCData.h"
 
 NS_CC_BEGIN
@@ -43,6 +45,10 @@ NS_CC_BEGIN
  * 
  * It supports the following base types:
  * bool, int, float, double, string
+ *
+ * On the platforms that store it in an xml file, the file is loaded once and the values are
+ * kept in memory. Set methods only update the memory, the file is written by flush(), flushAsync()
+ * or when the instance is destroyed.
  */
 class CC_DLL UserDefault
 {
@@ -146,10 +152,19 @@ public:
      */
     void    setDataForKey(const char* pKey, const Data& value);
     /**
-     @brief Save content to xml file
+     @brief Save content to xml file.
+     The file is written to a temporary file first, then renamed, so it is never left half written.
+     It does nothing if no value changed since the last flush.
      * @js NA
      */
     void    flush();
+    /**
+     @brief Save content to xml file on a worker thread.
+     The values are copied, so they can be changed while the file is being written.
+     * @since v4.0
+     * @js NA
+     */
+    void    flushAsync();
 
     /** returns the singleton 
      * @js NA
@@ -185,6 +200,20 @@ private:
     
     static bool createXMLFile();
     static void initXMLFilePath();
+
+    // reads all the values of the xml file into memory
+    void loadXMLFile();
+    // returns the xml file content of the values
+    std::string getXMLContent() const;
+    // returns nullptr if the key doesn't exist
+    const std::string* getValueForKey(const char* pKey) const;
+    void setValueForKey(const char* pKey, const char* pValue);
+    
+    // the values, and the keys in the order of the xml file
+    std::unordered_map<std::string, std::string> _values;
+    std::vector<std::string> _keys;
+    // whether the values changed since the last flush
+    bool _isDirty;
     
     static UserDefault* _userDefault;
     static std::string _filePath;
@@ -369,6 +369,8 @@ bool ZipUtils::isGZipBuffer(const unsigned char *buffer, ssize_t len)
 int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char **out)
 {
     struct CCZHeader *header = (struct CCZHeader*) buffer;
+    // an encrypted file is decrypted in a copy, the buffer may be shared with other readers or mapped read-only
+    unsigned char* decrypted = nullptr;
 
     // verify header
     if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == '!' )
@@ -408,8 +410,18 @@ int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, u
             return -1;
         }
 
+        decrypted = (unsigned char*)malloc(bufferLen);
+        if (!decrypted)
+        {
+            CCLOG("cocos2d: CCZ: Failed to allocate memory for decryption");
+            return -1;
+        }
+        memcpy(decrypted, buffer, bufferLen);
+        buffer = decrypted;
+        header = (struct CCZHeader*) decrypted;
+
         // decrypt
-        unsigned int* ints = (unsigned int*)(buffer+12);
+        unsigned int* ints = (unsigned int*)(decrypted+12);
         ssize_t enclen = (bufferLen-12)/4;
 
         decodeEncodedPvr(ints, enclen);
@@ -422,6 +434,7 @@ int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, u
         if(calculated != required)
         {
             CCLOG("cocos2d: Can't decrypt image file. Is the decryption key valid?");
+            free(decrypted);
             return -1;
         }
 #endif
@@ -438,12 +451,14 @@ int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, u
     if(! *out )
     {
         CCLOG("cocos2d: CCZ: Failed to allocate memory for texture");
+        free(decrypted);
         return -1;
     }
 
     unsigned long destlen = len;
     size_t source = (size_t) buffer + sizeof(*header);
     int ret = uncompress(*out, &destlen, (Bytef*)source, bufferLen - sizeof(*header) );
+    free(decrypted);
 
     if( ret != Z_OK )
     {
@@ -508,6 +523,9 @@ class ZipFilePrivate
 {
 public:
     unzFile zipFile;
+
+    // the bytes of a zip file opened by createWithData(), shared with the caller
+    Data buffer;
     
     // std::unordered_map is faster if available on the platform
     typedef std::unordered_map<std::string, struct ZipEntryInfo> FileListContainer;
@@ -525,6 +543,22 @@ ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
     }
 }
 
+ZipFile *ZipFile::createWithData(const Data& data)
+{
+    ZipFile *zip = new (std::nothrow) ZipFile();
+    if (zip)
+    {
+        // the slice keeps a shared buffer alive for as long as the zip file is open, an owned one is copied
+        zip->_data->buffer = data.slice(0, data.getSize());
+        if (zip->initWithBuffer(zip->_data->buffer.getBytes(), zip->_data->buffer.getSize()))
+        {
+            return zip;
+        }
+        delete zip;
+    }
+    return nullptr;
+}
+
 ZipFile::ZipFile()
 : _data(new ZipFilePrivate)
 {
@@ -643,6 +677,18 @@ unsigned char *ZipFile::getFileData(const std::string &fileName, ssize_t *size)
     return buffer;
 }
 
+Data ZipFile::getDataFromFile(const std::string &fileName)
+{
+    Data data;
+    ssize_t size = 0;
+    unsigned char *buffer = getFileData(fileName, &size);
+    if (buffer)
+    {
+        data.fastSet(buffer, size);
+    }
+    return data;
+}
+
 std::string ZipFile::getFirstFilename()
 {
     if (unzGoToFirstFile(_data->zipFile) != UNZ_OK) return emptyFilename;
@@ -218,6 +218,7 @@ namespace cocos2d
     };
 
     // forward declaration
+    class Data;
     class ZipFilePrivate;
     struct unz_file_info_s;
 
@@ -276,10 +277,30 @@ namespace cocos2d
         */
         unsigned char *getFileData(const std::string &fileName, ssize_t *size);
 
+        /**
+        * Get resource file data from a zip file.
+        * @param fileName File name
+        * @return Upon success, a Data which owns the uncompressed bytes, otherwise a null Data.
+        *
+        * @since v4.0
+        */
+        Data getDataFromFile(const std::string &fileName);
+
         std::string getFirstFilename();
         std::string getNextFilename();
         
         static ZipFile *createWithBuffer(const void* buffer, unsigned long size);
+
+        /**
+        * Open a zip file held in memory, without copying it.
+        * The zip file shares the buffer of data, so it stays valid even if data is released.
+        *
+        * @param data The bytes of the zip file.
+        * @return The zip file, or nullptr if it can't be opened.
+        *
+        * @since v4.0
+        */
+        static ZipFile *createWithData(const Data& data);
         
     private:
         /* Only used internal for createWithBuffer() */
@@ -113,7 +113,7 @@ static void s3tc_decode_block(uint8_t **blockData,
         {
             for (int x = 0; x < 4; ++x)
             {
-                decodeBlockData[x] = (alphaArray[alpha & 5] << 24) + colors[pixelsIndex & 3];
+                decodeBlockData[x] = (alphaArray[alpha & 7] << 24) + colors[pixelsIndex & 3];
                 pixelsIndex >>= 2;
                 alpha >>= 3;
             }
@@ -180,3 +180,224 @@ void s3tc_decode(uint8_t *encodeData,             //in_data
 }
 
 
+
+//Expand a r5g6b5 color to r8g8b8, the same way as s3tc_decode_block
+static void s3tc_expand_color(unsigned int color, int rgb[3])
+{
+    int r = (color >> 11) & 0x1f;
+    int g = (color >> 5) & 0x3f;
+    int b = color & 0x1f;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+static unsigned int s3tc_pack_color(const int rgb[3])
+{
+    return ((rgb[0] * 31 + 127) / 255) << 11 | ((rgb[1] * 63 + 127) / 255) << 5 | ((rgb[2] * 31 + 127) / 255);
+}
+
+//Encode the colors of 4x4 RGBA32 pixels to a 8 bytes block, in the 4 colors mode
+static void s3tc_encode_color_block(const uint8_t *pixels, uint8_t *blockData)
+{
+    int minColor[3] = {255, 255, 255}, maxColor[3] = {0, 0, 0}, mean[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            int value = pixels[i * 4 + c];
+            minColor[c] = value < minColor[c] ? value : minColor[c];
+            maxColor[c] = value > maxColor[c] ? value : maxColor[c];
+            mean[c] += value;
+        }
+    }
+    
+    /* pick the diagonal of the bounding box following the colors: flip the channels
+       which vary against the channel with the widest range */
+    int widest = 0;
+    for (int c = 1; c < 3; ++c)
+    {
+        if (maxColor[c] - minColor[c] > maxColor[widest] - minColor[widest])
+            widest = c;
+    }
+    for (int c = 0; c < 3; ++c)
+    {
+        if (c == widest)
+            continue;
+        int covariance = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            covariance += (pixels[i * 4 + widest] * 16 - mean[widest]) * (pixels[i * 4 + c] * 16 - mean[c]) / 256;
+        }
+        if (covariance < 0)
+        {
+            int tmp = minColor[c];
+            minColor[c] = maxColor[c];
+            maxColor[c] = tmp;
+        }
+    }
+    
+    /* inset the end points, the extremes are usually outliers */
+    for (int c = 0; c < 3; ++c)
+    {
+        int inset = (maxColor[c] - minColor[c]) / 16;
+        maxColor[c] -= inset;
+        minColor[c] += inset;
+    }
+    
+    unsigned int colorValue0 = s3tc_pack_color(maxColor);
+    unsigned int colorValue1 = s3tc_pack_color(minColor);
+    if (colorValue0 < colorValue1)
+    {
+        unsigned int tmp = colorValue0;
+        colorValue0 = colorValue1;
+        colorValue1 = tmp;
+    }
+    
+    int colors[4][3];
+    s3tc_expand_color(colorValue0, colors[0]);
+    s3tc_expand_color(colorValue1, colors[1]);
+    for (int c = 0; c < 3; ++c)
+    {
+        colors[2][c] = (2 * colors[0][c] + colors[1][c]) / 3;
+        colors[3][c] = (colors[0][c] + 2 * colors[1][c]) / 3;
+    }
+    
+    uint32_t pixelsIndex = 0;
+    if (colorValue0 != colorValue1)
+    {
+        for (int i = 15; i >= 0; --i)
+        {
+            int best = 0, bestDistance = 0x7fffffff;
+            for (int j = 0; j < 4; ++j)
+            {
+                int dr = pixels[i * 4] - colors[j][0];
+                int dg = pixels[i * 4 + 1] - colors[j][1];
+                int db = pixels[i * 4 + 2] - colors[j][2];
+                int distance = dr * dr + dg * dg + db * db;
+                if (distance < bestDistance)
+                {
+                    best = j;
+                    bestDistance = distance;
+                }
+            }
+            pixelsIndex = (pixelsIndex << 2) | best;
+        }
+    }
+    
+    blockData[0] = colorValue0 & 0xff;
+    blockData[1] = colorValue0 >> 8;
+    blockData[2] = colorValue1 & 0xff;
+    blockData[3] = colorValue1 >> 8;
+    for (int i = 0; i < 4; ++i)
+    {
+        blockData[4 + i] = (pixelsIndex >> (i * 8)) & 0xff;
+    }
+}
+
+//Encode the alphas of 4x4 RGBA32 pixels to a 8 bytes explicit alpha block (DXT3)
+static void s3tc_encode_explicit_alpha_block(const uint8_t *pixels, uint8_t *blockData)
+{
+    uint64_t alpha = 0;
+    for (int i = 15; i >= 0; --i)
+    {
+        alpha = (alpha << 4) | ((pixels[i * 4 + 3] * 15 + 127) / 255);
+    }
+    for (int i = 0; i < 8; ++i)
+    {
+        blockData[i] = (alpha >> (i * 8)) & 0xff;
+    }
+}
+
+//Encode the alphas of 4x4 RGBA32 pixels to a 8 bytes interpolated alpha block (DXT5), in the 8 alphas mode
+static void s3tc_encode_interpolated_alpha_block(const uint8_t *pixels, uint8_t *blockData)
+{
+    unsigned int alpha0 = 0, alpha1 = 255;
+    for (int i = 0; i < 16; ++i)
+    {
+        unsigned int value = pixels[i * 4 + 3];
+        alpha0 = value > alpha0 ? value : alpha0;
+        alpha1 = value < alpha1 ? value : alpha1;
+    }
+    
+    unsigned int alphaArray[8];
+    alphaArray[0] = alpha0;
+    alphaArray[1] = alpha1;
+    for (int i = 1; i < 7; ++i)
+    {
+        alphaArray[i + 1] = (alphaArray[0] * (7 - i) + alphaArray[1] * i) / 7;
+    }
+    
+    uint64_t alpha = 0;
+    if (alpha0 != alpha1)
+    {
+        for (int i = 15; i >= 0; --i)
+        {
+            int best = 0, bestDistance = 256;
+            for (int j = 0; j < 8; ++j)
+            {
+                int distance = abs((int)pixels[i * 4 + 3] - (int)alphaArray[j]);
+                if (distance < bestDistance)
+                {
+                    best = j;
+                    bestDistance = distance;
+                }
+            }
+            alpha = (alpha << 3) | best;
+        }
+    }
+    alpha = (alpha << 16) | (alpha1 << 8) | alpha0;
+    
+    for (int i = 0; i < 8; ++i)
+    {
+        blockData[i] = (alpha >> (i * 8)) & 0xff;
+    }
+}
+
+int s3tc_get_encoded_data_size(const int pixelsWidth, const int pixelsHeight, S3TCDecodeFlag encodeFlag)
+{
+    int blockSize = (S3TCDecodeFlag::DXT1 == encodeFlag) ? 8 : 16;
+    return ((pixelsWidth + 3) / 4) * ((pixelsHeight + 3) / 4) * blockSize;
+}
+
+//Encode RGB32 data to S3TC
+void s3tc_encode(const uint8_t *decodeData,       //in_data
+                 uint8_t *encodeData,             //out_data
+                 const int pixelsWidth,
+                 const int pixelsHeight,
+                 S3TCDecodeFlag encodeFlag)
+{
+    uint8_t pixels[16 * 4];
+    for (int block_y = 0; block_y < pixelsHeight; block_y += 4)
+    {
+        for (int block_x = 0; block_x < pixelsWidth; block_x += 4)
+        {
+            /* gather the 4x4 pixels, repeating the last row and column on the edges */
+            for (int y = 0; y < 4; ++y)
+            {
+                int py = block_y + y < pixelsHeight ? block_y + y : pixelsHeight - 1;
+                for (int x = 0; x < 4; ++x)
+                {
+                    int px = block_x + x < pixelsWidth ? block_x + x : pixelsWidth - 1;
+                    memcpy(pixels + (y * 4 + x) * 4, decodeData + (py * pixelsWidth + px) * 4, 4);
+                }
+            }
+            
+            switch (encodeFlag)
+            {
+                case S3TCDecodeFlag::DXT3:
+                    s3tc_encode_explicit_alpha_block(pixels, encodeData);
+                    encodeData += 8;
+                    break;
+                case S3TCDecodeFlag::DXT5:
+                    s3tc_encode_interpolated_alpha_block(pixels, encodeData);
+                    encodeData += 8;
+                    break;
+                default:
+                    break;
+            }
+            s3tc_encode_color_block(pixels, encodeData);
+            encodeData += 8;
+        }
+    }
+}
@@ -43,6 +43,17 @@ enum class S3TCDecodeFlag
                  S3TCDecodeFlag decodeFlag
                  );
 
+//Encode RGBA32 pixels to S3TC (DXT1, DXT3 or DXT5) data, ((w+3)/4)*((h+3)/4) blocks of 8 (DXT1) or 16 bytes
+void s3tc_encode(const uint8_t *decode_data,
+                 uint8_t *encode_data,
+                 const int pixelsWidth,
+                 const int pixelsHeight,
+                 S3TCDecodeFlag encodeFlag
+                 );
+
+//Returns the size in bytes of the S3TC encoded data of the image
+int s3tc_get_encoded_data_size(const int pixelsWidth, const int pixelsHeight, S3TCDecodeFlag encodeFlag);
+
 
 #endif /* defined(COCOS2DX_PLATFORM_THIRDPARTY_S3TC_) */
 
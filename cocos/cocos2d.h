@@ -118,6 +118,7 @@ THE SOFTWARE.
 #include "2d/CCFontFNT.h"
 #include "2d/CCLayer.h"
 #include "2d/CCScene.h"
+#include "2d/CCTransformHierarchy.h"
 #include "2d/CCTransition.h"
 #include "2d/CCTransitionPageTurn.h"
 #include "2d/CCTransitionProgress.h"
@@ -158,6 +159,7 @@ THE SOFTWARE.
 #include "renderer/ccShaders.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCTextureTranscoder.h"
 #include "renderer/CCVertexIndexBuffer.h"
 #include "renderer/CCVertexIndexData.h"
 #include "renderer/CCTrianglesCommand.h"
@@ -173,6 +175,7 @@ THE SOFTWARE.
 #include "platform/CCDevice.h"
 #include "platform/CCCommon.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCFilePack.h"
 #include "platform/CCImage.h"
 #include "platform/CCSAXParser.h"
 #include "platform/CCThread.h"
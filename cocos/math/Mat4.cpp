@@ -893,6 +893,16 @@ void Mat4::subtract(const Mat4& m1, const Mat4& m2, Mat4* dst)
 #endif
 }
 
+void Mat4::transformPoints(const Vec3* src, Vec3* dst, size_t stride, size_t count) const
+{
+    GP_ASSERT(count == 0 || (src && dst));
+#ifdef __SSE__
+    MathUtil::transformPoints(col, (const float*)src, (float*)dst, stride, count);
+#else
+    MathUtil::transformPoints(m, (const float*)src, (float*)dst, stride, count);
+#endif
+}
+
 void Mat4::transformVector(Vec3* vector) const
 {
     GP_ASSERT(vector);
@@ -774,6 +774,21 @@ public:
      */
     inline void transformPoint(const Vec3& point, Vec3* dst) const { GP_ASSERT(dst); transformVector(point.x, point.y, point.z, 1.0f, dst); }
 
+    /**
+     * Transforms an array of points by this matrix, and stores
+     * the results in dst.
+     *
+     * Points are stride bytes apart in both src and dst, which allows the
+     * positions of an interleaved vertex array (eg: V3F_C4B_T2F) to be
+     * transformed without repacking them. src and dst may be the same array.
+     *
+     * @param src The first point to transform.
+     * @param dst The first point to store the transformed points in.
+     * @param stride The distance in bytes between two consecutive points.
+     * @param count The number of points to transform.
+     */
+    void transformPoints(const Vec3* src, Vec3* dst, size_t stride, size_t count) const;
+
     /**
      * Transforms the specified vector by this matrix by
      * treating the fourth (w) coordinate as zero.
@@ -256,6 +256,20 @@ void MathUtil::transformVec4(const float* m, const float* v, float* dst)
 #endif
 }
 
+void MathUtil::transformPoints(const float* m, const float* src, float* dst, size_t stride, size_t count)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformPoints(m, src, dst, stride, count);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformPoints(m, src, dst, stride, count);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformPoints(m, src, dst, stride, count);
+    else MathUtilC::transformPoints(m, src, dst, stride, count);
+#else
+    MathUtilC::transformPoints(m, src, dst, stride, count);
+#endif
+}
+
 void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 {
 #ifdef USE_NEON32
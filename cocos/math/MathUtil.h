@@ -90,6 +90,8 @@ private:
     static void transposeMatrix(const __m128 m[4], __m128 dst[4]);
         
     static void transformVec4(const __m128 m[4], const __m128& v, __m128& dst);
+
+    static void transformPoints(const __m128 m[4], const float* src, float* dst, size_t stride, size_t count);
 #endif
     static void addMatrix(const float* m, float scalar, float* dst);
 
@@ -109,6 +111,8 @@ private:
 
     static void transformVec4(const float* m, const float* v, float* dst);
 
+    static void transformPoints(const float* m, const float* src, float* dst, size_t stride, size_t count);
+
     static void crossVec3(const float* v1, const float* v2, float* dst);
 
 };
@@ -41,6 +41,8 @@ public:
     
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
+    inline static void transformPoints(const float* m, const float* src, float* dst, size_t stride, size_t count);
+    
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
 };
 
@@ -204,6 +206,24 @@ inline void MathUtilC::transformVec4(const float* m, const float* v, float* dst)
     dst[3] = w;
 }
 
+inline void MathUtilC::transformPoints(const float* m, const float* src, float* dst, size_t stride, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        // Handle case where src == dst.
+        float x = src[0] * m[0] + src[1] * m[4] + src[2] * m[8] + m[12];
+        float y = src[0] * m[1] + src[1] * m[5] + src[2] * m[9] + m[13];
+        float z = src[0] * m[2] + src[1] * m[6] + src[2] * m[10] + m[14];
+        
+        dst[0] = x;
+        dst[1] = y;
+        dst[2] = z;
+        
+        src = (const float*)((const char*)src + stride);
+        dst = (float*)((char*)dst + stride);
+    }
+}
+
 inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
 {
     float x = (v1[1] * v2[2]) - (v1[2] * v2[1]);
@@ -41,6 +41,8 @@ public:
     
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
+    inline static void transformPoints(const float* m, const float* src, float* dst, size_t stride, size_t count);
+    
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
 };
 
@@ -223,6 +225,39 @@ inline void MathUtilNeon64::transformVec4(const float* m, const float* v, float*
     );
 }
 
+inline void MathUtilNeon64::transformPoints(const float* m, const float* src, float* dst, size_t stride, size_t count)
+{
+    if (count == 0)
+        return;
+
+    float* dstZ = dst + 2;
+    asm volatile
+    (
+        "ld1    {v9.4s, v10.4s, v11.4s, v12.4s}, [%4] \n\t"   // M[m0-m7] M[m8-m15]
+
+        "1:                                 \n\t"
+        "ld1    {v0.2s}, [%1]               \n\t"   // V[x, y]
+        "ldr    s1, [%1, #8]                \n\t"   // V[z]
+        "add    %1, %1, %5                  \n\t"   // next source point
+
+        "mov    v13.16b, v12.16b            \n\t"   // DST->V = M[m12-m15]
+        "fmla   v13.4s, v9.4s, v0.s[0]      \n\t"   // DST->V += M[m0-m3] * V[x]
+        "fmla   v13.4s, v10.4s, v0.s[1]     \n\t"   // DST->V += M[m4-m7] * V[y]
+        "fmla   v13.4s, v11.4s, v1.s[0]     \n\t"   // DST->V += M[m8-m11] * V[z]
+
+        "st1    {v13.2s}, [%0]              \n\t"   // DST->V[x, y]
+        "st1    {v13.s}[2], [%2]            \n\t"   // DST->V[z]
+        "add    %0, %0, %5                  \n\t"   // next destination point
+        "add    %2, %2, %5                  \n\t"
+
+        "subs   %3, %3, #1                  \n\t"
+        "b.ne   1b                          \n\t"
+        : "+r"(dst), "+r"(src), "+r"(dstZ), "+r"(count)
+        : "r"(m), "r"(stride)
+        : "v0", "v1", "v9", "v10","v11", "v12", "v13", "cc", "memory"
+    );
+}
+
 inline void MathUtilNeon64::crossVec3(const float* v1, const float* v2, float* dst)
 {
         asm volatile(
@@ -151,6 +151,29 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+void MathUtil::transformPoints(const __m128 m[4], const float* src, float* dst, size_t stride, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        // Only x, y and z are loaded: the fourth float may belong to the next attribute or be out of bounds.
+        __m128 xy = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)src);
+        __m128 x = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 y = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z = _mm_load1_ps(src + 2);
+        
+        __m128 r = _mm_add_ps(
+                              _mm_add_ps(_mm_mul_ps(m[0], x), _mm_mul_ps(m[1], y)),
+                              _mm_add_ps(_mm_mul_ps(m[2], z), m[3])
+                              );
+        
+        _mm_storel_pi((__m64*)dst, r);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(r, r));
+        
+        src = (const float*)((const char*)src + stride);
+        dst = (float*)((char*)dst + stride);
+    }
+}
+
 #endif
 
 
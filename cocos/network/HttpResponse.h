@@ -27,6 +27,7 @@
 #define __HTTP_RESPONSE__
 
 #include "network/HttpRequest.h"
+#include "base/CCData.h"
 
 NS_CC_BEGIN
 
@@ -101,6 +102,27 @@ public:
         return &_responseData;
     }
     
+    /** Move the http response raw data into a Data, without copying it.
+     *  The response data is empty afterwards.
+     *  @since v4.0
+     */
+    inline Data takeResponseData()
+    {
+        Data data;
+        if (!_responseData.empty())
+        {
+            auto buffer = new (std::nothrow) std::vector<char>(std::move(_responseData));
+            if (buffer)
+            {
+                data.setSharedBuffer(reinterpret_cast<unsigned char*>(buffer->data()), buffer->size(), [buffer](unsigned char*) {
+                    delete buffer;
+                });
+            }
+            _responseData.clear();
+        }
+        return data;
+    }
+    
     /** get the Rawheader **/
     inline std::vector<char>* getResponseHeader()
     {
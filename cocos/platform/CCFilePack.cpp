@@ -0,0 +1,358 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "platform/CCFilePack.h"
+
+#include <zlib.h>
+
+#include "platform/CCFileUtils.h"
+#include "base/ccMacros.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <vector>
+#include "platform/CCStdC.h"
+#elif (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define CC_FILEPACK_USE_MMAP 1
+#endif
+
+NS_CC_BEGIN
+
+// Pack format, all the values are little endian and all the sections are 4 bytes aligned:
+//   Header
+//   uint32_t buckets[bucketCount]  index of an entry or NO_ENTRY, open addressing with linear probing
+//   Entry entries[entryCount]
+//   strings                        names of the entries, '\0' terminated
+//   data of the entries
+
+static const char PACK_MAGIC[4] = {'C', 'C', 'P', 'K'};
+static const uint16_t PACK_VERSION = 1;
+static const uint32_t NO_ENTRY = 0xffffffff;
+
+struct FilePack::Header
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t entryCount;
+    uint32_t bucketCount;
+    uint32_t bucketsOffset;
+    uint32_t entriesOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+};
+
+struct FilePack::Entry
+{
+    uint32_t hash;
+    uint32_t nameOffset;
+    uint16_t nameLength;
+    uint16_t compression;
+    uint32_t dataOffset;
+    uint32_t size;
+    uint32_t storedSize;
+};
+
+// 32 bits FNV-1a, the hash used by build_pack.py
+static uint32_t hashName(const char* name, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool isInRange(uint64_t offset, uint64_t length, uint64_t size)
+{
+    return offset <= size && length <= size - offset;
+}
+
+FilePack* FilePack::create(const std::string& fullPath)
+{
+    auto ret = new (std::nothrow) FilePack();
+    if (ret && ret->initWithFile(fullPath))
+    {
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+FilePack::FilePack()
+: _bytes(nullptr)
+, _size(0)
+, _entryCount(0)
+, _bucketMask(0)
+, _buckets(nullptr)
+, _entries(nullptr)
+, _strings(nullptr)
+{
+}
+
+FilePack::~FilePack()
+{
+    close();
+}
+
+bool FilePack::initWithFile(const std::string& fullPath)
+{
+    _path = fullPath;
+
+    if (!map(fullPath))
+    {
+        // not on the file system (Android assets) or no mmap, read it once
+        _data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        // shared now, so that the entries are sliced without copying them nor modifying _data
+        _data.share();
+    }
+    _bytes = _data.getBytes();
+    _size = _data.getSize();
+
+    if (_bytes == nullptr || !validate())
+    {
+        CCLOG("cocos2d: FilePack: %s isn't a valid pack", fullPath.c_str());
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool FilePack::map(const std::string& fullPath)
+{
+#if defined(CC_FILEPACK_USE_MMAP)
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    void* bytes = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        bytes = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    // the mapping stays valid after the file is closed
+    ::close(fd);
+    if (bytes == MAP_FAILED)
+        return false;
+
+    size_t size = (size_t)info.st_size;
+    _data.setSharedBuffer((unsigned char*)bytes, size, [size](unsigned char* mapped) {
+        munmap(mapped, size);
+    });
+    return true;
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    int length = MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, nullptr, 0);
+    if (length <= 0)
+        return false;
+    std::vector<WCHAR> wideFullPath(length);
+    MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, wideFullPath.data(), length);
+
+    HANDLE fileHandle = ::CreateFileW(wideFullPath.data(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    DWORD size = ::GetFileSize(fileHandle, nullptr);
+    HANDLE mappingHandle = nullptr;
+    if (size != INVALID_FILE_SIZE && size > 0)
+    {
+        mappingHandle = ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    ::CloseHandle(fileHandle);
+    if (mappingHandle == nullptr)
+        return false;
+
+    void* bytes = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (bytes == nullptr)
+    {
+        ::CloseHandle(mappingHandle);
+        return false;
+    }
+
+    _data.setSharedBuffer((unsigned char*)bytes, size, [mappingHandle](unsigned char* mapped) {
+        ::UnmapViewOfFile(mapped);
+        ::CloseHandle(mappingHandle);
+    });
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FilePack::close()
+{
+    // the mapping is released once the Data of the stored entries are released too
+    _data.clear();
+    _bytes = nullptr;
+    _size = 0;
+    _entryCount = 0;
+    _buckets = nullptr;
+    _entries = nullptr;
+    _strings = nullptr;
+}
+
+bool FilePack::validate()
+{
+    static_assert(sizeof(Header) == 32, "the pack header must be 32 bytes");
+    static_assert(sizeof(Entry) == 24, "the pack entries must be 24 bytes");
+
+    if (_size < sizeof(Header))
+        return false;
+
+    const Header* header = (const Header*)_bytes;
+    if (memcmp(header->magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || header->version != PACK_VERSION)
+        return false;
+
+    // the bucket count is a power of two larger than the entry count, so a probe always ends on an empty bucket
+    uint32_t bucketCount = header->bucketCount;
+    if (bucketCount == 0 || (bucketCount & (bucketCount - 1)) != 0 || header->entryCount >= bucketCount)
+        return false;
+
+    if ((header->bucketsOffset | header->entriesOffset) % 4 != 0
+        || !isInRange(header->bucketsOffset, (uint64_t)bucketCount * sizeof(uint32_t), _size)
+        || !isInRange(header->entriesOffset, (uint64_t)header->entryCount * sizeof(Entry), _size)
+        || !isInRange(header->stringsOffset, header->stringsSize, _size))
+        return false;
+
+    _buckets = (const uint32_t*)(_bytes + header->bucketsOffset);
+    _entries = (const Entry*)(_bytes + header->entriesOffset);
+    _strings = (const char*)(_bytes + header->stringsOffset);
+    _entryCount = header->entryCount;
+    _bucketMask = bucketCount - 1;
+
+    for (uint32_t i = 0; i < bucketCount; ++i)
+    {
+        if (_buckets[i] != NO_ENTRY && _buckets[i] >= _entryCount)
+            return false;
+    }
+
+    for (uint32_t i = 0; i < _entryCount; ++i)
+    {
+        const Entry& entry = _entries[i];
+        if (!isInRange(entry.nameOffset, entry.nameLength, header->stringsSize)
+            || !isInRange(entry.dataOffset, entry.storedSize, _size))
+            return false;
+
+        if (entry.compression == (uint16_t)Compression::NONE)
+        {
+            if (entry.storedSize != entry.size)
+                return false;
+        }
+        else if (entry.compression != (uint16_t)Compression::ZLIB)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const FilePack::Entry* FilePack::findEntry(const std::string& name) const
+{
+    if (_entryCount == 0)
+        return nullptr;
+
+    uint32_t hash = hashName(name.c_str(), name.length());
+    for (uint32_t bucket = hash & _bucketMask; _buckets[bucket] != NO_ENTRY; bucket = (bucket + 1) & _bucketMask)
+    {
+        const Entry* entry = _entries + _buckets[bucket];
+        if (entry->hash == hash
+            && entry->nameLength == name.length()
+            && memcmp(_strings + entry->nameOffset, name.c_str(), name.length()) == 0)
+        {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+bool FilePack::hasEntry(const std::string& name) const
+{
+    return findEntry(name) != nullptr;
+}
+
+ssize_t FilePack::getEntrySize(const std::string& name) const
+{
+    const Entry* entry = findEntry(name);
+    return entry ? (ssize_t)entry->size : -1;
+}
+
+const unsigned char* FilePack::getEntryBytes(const std::string& name, ssize_t* size) const
+{
+    const Entry* entry = findEntry(name);
+    if (entry == nullptr || entry->compression != (uint16_t)Compression::NONE)
+    {
+        *size = 0;
+        return nullptr;
+    }
+    *size = entry->size;
+    return _bytes + entry->dataOffset;
+}
+
+Data FilePack::getEntryData(const std::string& name, bool forString) const
+{
+    Data ret;
+    const Entry* entry = findEntry(name);
+    if (entry == nullptr || entry->size == 0)
+        return ret;
+
+    if (entry->compression == (uint16_t)Compression::NONE && !forString)
+    {
+        return _data.slice(entry->dataOffset, entry->size);
+    }
+
+    unsigned char* buffer = (unsigned char*)malloc(entry->size + (forString ? 1 : 0));
+    if (buffer == nullptr)
+        return ret;
+
+    if (entry->compression == (uint16_t)Compression::NONE)
+    {
+        memcpy(buffer, _bytes + entry->dataOffset, entry->size);
+    }
+    else
+    {
+        uLongf size = entry->size;
+        int err = uncompress(buffer, &size, _bytes + entry->dataOffset, entry->storedSize);
+        if (err != Z_OK || size != entry->size)
+        {
+            CCLOG("cocos2d: FilePack: failed to inflate %s in %s, error %d", name.c_str(), _path.c_str(), err);
+            free(buffer);
+            return ret;
+        }
+    }
+
+    if (forString)
+    {
+        buffer[entry->size] = '\0';
+    }
+    ret.fastSet(buffer, entry->size);
+    return ret;
+}
+
+NS_CC_END
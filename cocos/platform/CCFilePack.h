@@ -0,0 +1,152 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_FILEPACK_H__
+#define __CC_FILEPACK_H__
+
+#include <stdint.h>
+#include <string>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/**
+ * A read-only pack of files, built by tools/file-pack/build_pack.py.
+ *
+ * The pack holds a hashed directory of its entries, so looking up a file is a hash probe
+ * instead of a stat() call. The pack file is memory-mapped when it is on the file system:
+ * the entries that are stored uncompressed are returned as shared Data referencing the mapping,
+ * the other ones are inflated with zlib when they are read. The mapping is released when the pack
+ * and all these Data are destroyed. Packs in the Android assets, or on WinRT, are read in memory
+ * once when they are opened.
+ *
+ * FilePack objects are usually not used directly: mount them as search paths with FileUtils::addSearchPack().
+ *
+ * @since v4.0
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL FilePack
+{
+public:
+    /** How an entry is stored in the pack. */
+    enum class Compression
+    {
+        NONE = 0,
+        ZLIB = 1,
+    };
+
+    /**
+     * Opens a pack.
+     *
+     * @param fullPath The full path of the pack file.
+     * @return The pack, or nullptr if the file is missing or isn't a valid pack.
+     */
+    static FilePack* create(const std::string& fullPath);
+
+    ~FilePack();
+
+    /** Returns the full path of the pack file. */
+    const std::string& getPath() const { return _path; }
+
+    /** Returns the number of entries in the pack. */
+    int getEntryCount() const { return static_cast<int>(_entryCount); }
+
+    /**
+     * Checks whether the pack contains an entry.
+     *
+     * @param name The name of the entry, relative to the root of the pack, e.g. "Images/grossini.png".
+     */
+    bool hasEntry(const std::string& name) const;
+
+    /**
+     * Returns the uncompressed size of an entry, or -1 if the pack doesn't contain it.
+     */
+    ssize_t getEntrySize(const std::string& name) const;
+
+    /**
+     * Returns the bytes of an entry stored uncompressed, without copying them.
+     * They stay valid while the pack is open.
+     *
+     * @param name The name of the entry.
+     * @param size Set to the size of the entry.
+     * @return The bytes of the entry, or nullptr if the pack doesn't contain it or if it is compressed.
+     */
+    const unsigned char* getEntryBytes(const std::string& name, ssize_t* size) const;
+
+    /**
+     * Reads an entry, inflating it if it is compressed.
+     *
+     * @param name The name of the entry.
+     * @param forString Whether to add a '\0' after the bytes, which isn't counted in the size of the data.
+     * @return The content of the entry, or Data::Null if the pack doesn't contain it or if it is corrupted.
+     *         The entries stored uncompressed are shared slices of the pack, unless forString is true.
+     * @note It can be called from several threads at the same time.
+     */
+    Data getEntryData(const std::string& name, bool forString = false) const;
+
+protected:
+    struct Header;
+    struct Entry;
+
+    FilePack();
+    bool initWithFile(const std::string& fullPath);
+    //maps the file in _data, returns false if it couldn't
+    bool map(const std::string& fullPath);
+    void close();
+    //checks the header, the directory and the ranges of all the entries
+    bool validate();
+    const Entry* findEntry(const std::string& name) const;
+
+    std::string _path;
+
+    //bytes of the pack, either mapped or read in memory, shared with the Data of the stored entries
+    Data _data;
+    const unsigned char* _bytes;
+    size_t _size;
+
+    uint32_t _entryCount;
+    uint32_t _bucketMask;
+    const uint32_t* _buckets;
+    const Entry* _entries;
+    const char* _strings;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(FilePack);
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_FILEPACK_H__
@@ -26,12 +26,15 @@ THE SOFTWARE.
 #include "CCFileUtils.h"
 
 #include <stack>
+#include <algorithm>
 
 #include "base/CCData.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "platform/CCSAXParser.h"
+#include "platform/CCFilePack.h"
 #include "base/ccUtils.h"
+#include "base/CCAsyncTaskPool.h"
 
 #include "tinyxml2/tinyxml2.h"
 extern "C"{
@@ -116,7 +119,7 @@ public:
         CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
         parser.setDelegator(this);
 
-        parser.parse(fileName);
+        parser.parseStream(fileName);
 		return _rootDict;
     }
 
@@ -140,7 +143,7 @@ public:
         CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
         parser.setDelegator(this);
 
-        parser.parse(fileName);
+        parser.parseStream(fileName);
 		return _rootArray;
     }
 
@@ -373,6 +376,7 @@ static tinyxml2::XMLElement* generateElementForDict(const ValueMap& dict, tinyxm
  */
 bool FileUtils::writeToFile(ValueMap& dict, const std::string &fullPath)
 {
+    invalidateDirectoryIndex(fullPath);
     //CCLOG("tinyxml2 Dictionary %d writeToFile %s", dict->_ID, fullPath.c_str());
     tinyxml2::XMLDocument *doc = new tinyxml2::XMLDocument();
     if (nullptr == doc)
@@ -525,12 +529,17 @@ void FileUtils::setDelegate(FileUtils *delegate)
 }
 
 FileUtils::FileUtils()
-    : _writablePath("")
+    : _directoryIndexEnabled(false)
+    , _writablePath("")
 {
 }
 
 FileUtils::~FileUtils()
 {
+    for (auto& iter : _searchPacks)
+    {
+        delete iter.second;
+    }
 }
 
 
@@ -545,6 +554,8 @@ bool FileUtils::init()
 void FileUtils::purgeCachedEntries()
 {
     _fullPathCache.clear();
+    _notFoundCache.clear();
+    _directoryIndices.clear();
 }
 
 static Data getData(const std::string& filename, bool forString)
@@ -610,7 +621,9 @@ static Data getData(const std::string& filename, bool forString)
 
 std::string FileUtils::getStringFromFile(const std::string& filename)
 {
-    Data data = getData(filename, true);
+    Data data;
+    if (!getDataFromSearchPack(filename, true, &data))
+        data = getData(filename, true);
     if (data.isNull())
     	return "";
     
@@ -620,14 +633,82 @@ std::string FileUtils::getStringFromFile(const std::string& filename)
 
 Data FileUtils::getDataFromFile(const std::string& filename)
 {
+    Data data;
+    if (getDataFromSearchPack(filename, false, &data))
+        return data;
     return getData(filename, false);
 }
 
+bool FileUtils::readFileInChunks(const std::string& filename, const std::function<bool(const char* chunk, size_t size)>& chunkCallback, size_t chunkSize)
+{
+    CCASSERT(chunkSize > 0, "Invalid chunk size.");
+
+    Data data;
+    if (!getDataFromSearchPack(filename, false, &data))
+    {
+        const std::string fullPath = fullPathForFilename(filename);
+        FILE *fp = fullPath.empty() ? nullptr : fopen(fullPath.c_str(), "rb");
+        if (fp)
+        {
+            std::vector<char> buffer(chunkSize);
+            bool ret = true;
+            size_t readsize;
+            while (ret && (readsize = fread(buffer.data(), 1, chunkSize, fp)) > 0)
+            {
+                ret = chunkCallback(buffer.data(), readsize);
+            }
+            ret = ret && !ferror(fp);
+            fclose(fp);
+            return ret;
+        }
+
+        // Android assets and the platforms reading files with their own API
+        data = getDataFromFile(filename);
+    }
+    if (data.isNull())
+    {
+        return false;
+    }
+
+    const char* bytes = reinterpret_cast<const char*>(data.getBytes());
+    for (ssize_t offset = 0; offset < data.getSize(); offset += chunkSize)
+    {
+        if (!chunkCallback(bytes + offset, std::min(chunkSize, static_cast<size_t>(data.getSize() - offset))))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FileUtils::getValueMapFromFileAsync(const std::string& filename, const std::function<void(const ValueMap&)>& callback)
+{
+    // the worker thread only reads an absolute path, it never touches the caches of the search paths
+    std::string fullPath = fullPathForFilename(filename);
+    auto result = std::make_shared<ValueMap>();
+
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [result, callback](void*) {
+        callback(*result);
+    }, nullptr, [this, fullPath, result]() {
+        if (!fullPath.empty())
+        {
+            *result = getValueMapFromFile(fullPath);
+        }
+    });
+}
+
 unsigned char* FileUtils::getFileData(const std::string& filename, const char* mode, ssize_t *size)
 {
     unsigned char * buffer = nullptr;
     CCASSERT(!filename.empty() && size != nullptr && mode != nullptr, "Invalid parameters.");
     *size = 0;
+
+    Data data;
+    if (getDataFromSearchPack(filename, false, &data))
+    {
+        return data.takeBuffer(size);
+    }
+
     do
     {
         // read the file from hardware
@@ -751,17 +832,61 @@ std::string FileUtils::fullPathForFilename(const std::string &filename)
     {
         return cacheIter->second;
     }
+
+    if (!_notFoundCache.empty() && _notFoundCache.find(filename) != _notFoundCache.end())
+    {
+        return "";
+    }
     
     // Get the new file name.
     const std::string newFilename( getNewFilename(filename) );
     
 	std::string fullpath;
+
+    // the indices only contain normalized paths, "./" and "../" are resolved by the file system
+    bool useDirectoryIndex = _directoryIndexEnabled && newFilename.find("./") == std::string::npos;
+    bool cacheNotFound = useDirectoryIndex;
     
     for (const auto& searchIt : _searchPathArray)
     {
+        FilePack* pack = nullptr;
+        if (!_searchPacks.empty())
+        {
+            auto packIter = _searchPacks.find(searchIt);
+            if (packIter != _searchPacks.end())
+                pack = packIter->second;
+        }
+
+        const std::unordered_set<std::string>* index = nullptr;
+        if (pack == nullptr && useDirectoryIndex)
+        {
+            index = getDirectoryIndex(searchIt);
+            if (index == nullptr)
+                cacheNotFound = false;
+        }
+
         for (const auto& resolutionIt : _searchResolutionsOrderArray)
         {
-            fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
+            if (pack || index)
+            {
+                // same layout as getPathForFilename(): file_path + resolutionDirectory + file
+                std::string entryName;
+                size_t pos = newFilename.find_last_of("/");
+                if (pos != std::string::npos)
+                {
+                    entryName = newFilename.substr(0, pos+1) + resolutionIt + newFilename.substr(pos+1);
+                }
+                else
+                {
+                    entryName = resolutionIt + newFilename;
+                }
+                bool found = pack ? pack->hasEntry(entryName) : index->find(entryName) != index->end();
+                fullpath = found ? searchIt + entryName : "";
+            }
+            else
+            {
+                fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
+            }
             
             if (fullpath.length() > 0)
             {
@@ -773,6 +898,11 @@ std::string FileUtils::fullPathForFilename(const std::string &filename)
         }
     }
     
+    if (cacheNotFound)
+    {
+        _notFoundCache.insert(filename);
+    }
+
     if(isPopupNotify()){
         CCLOG("cocos2d: fullPathForFilename: No file found at %s. Possible missing file.", filename.c_str());
     }
@@ -790,6 +920,7 @@ void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& search
 {
     bool existDefault = false;
     _fullPathCache.clear();
+    _notFoundCache.clear();
     _searchResolutionsOrderArray.clear();
     for(const auto& iter : searchResolutionsOrder)
     {
@@ -821,9 +952,11 @@ void FileUtils::addSearchResolutionsOrder(const std::string &order,const bool fr
     
     if (front) {
         _searchResolutionsOrderArray.insert(_searchResolutionsOrderArray.begin(), resOrder);
+        _fullPathCache.clear();
     } else {
         _searchResolutionsOrderArray.push_back(resOrder);
     }
+    _notFoundCache.clear();
 }
 
 const std::vector<std::string>& FileUtils::getSearchResolutionsOrder() const
@@ -878,6 +1011,16 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
         //CCLOG("Default root path doesn't exist, adding it.");
         _searchPathArray.push_back(_defaultResRootPath);
     }
+
+    // keep the index of the search paths which are still used
+    _notFoundCache.clear();
+    for (auto iter = _directoryIndices.begin(); iter != _directoryIndices.end(); )
+    {
+        if (std::find(_searchPathArray.begin(), _searchPathArray.end(), iter->first) == _searchPathArray.end())
+            iter = _directoryIndices.erase(iter);
+        else
+            ++iter;
+    }
 }
 
 void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
@@ -893,14 +1036,219 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
     }
     if (front) {
         _searchPathArray.insert(_searchPathArray.begin(), path);
+        _fullPathCache.clear();
     } else {
         _searchPathArray.push_back(path);
     }
+    // the files found before are still found first when the path is appended, but the missing ones may be there
+    _notFoundCache.clear();
+}
+
+bool FileUtils::addSearchPack(const std::string& packPath, const bool front)
+{
+    std::string fullPath = fullPathForFilename(packPath);
+    if (fullPath.empty())
+        return false;
+
+    std::string searchPath = fullPath + "/";
+    if (_searchPacks.find(searchPath) == _searchPacks.end())
+    {
+        FilePack* pack = FilePack::create(fullPath);
+        if (pack == nullptr)
+            return false;
+        _searchPacks[searchPath] = pack;
+    }
+    else
+    {
+        _searchPathArray.erase(std::remove(_searchPathArray.begin(), _searchPathArray.end(), searchPath), _searchPathArray.end());
+    }
+
+    if (front) {
+        _searchPathArray.insert(_searchPathArray.begin(), searchPath);
+    } else {
+        _searchPathArray.push_back(searchPath);
+    }
+    _fullPathCache.clear();
+    _notFoundCache.clear();
+    return true;
+}
+
+void FileUtils::removeSearchPack(const std::string& packPath)
+{
+    std::string fullPath = isAbsolutePath(packPath) ? packPath : fullPathForFilename(packPath);
+    auto iter = _searchPacks.find(fullPath + "/");
+    if (iter == _searchPacks.end())
+        return;
+
+    _searchPathArray.erase(std::remove(_searchPathArray.begin(), _searchPathArray.end(), iter->first), _searchPathArray.end());
+    delete iter->second;
+    _searchPacks.erase(iter);
+    _fullPathCache.clear();
+    _notFoundCache.clear();
+}
+
+FilePack* FileUtils::getSearchPackForPath(const std::string& fullPath, std::string* entryName) const
+{
+    for (const auto& iter : _searchPacks)
+    {
+        const std::string& searchPath = iter.first;
+        if (fullPath.length() > searchPath.length() && fullPath.compare(0, searchPath.length(), searchPath) == 0)
+        {
+            *entryName = fullPath.substr(searchPath.length());
+            return iter.second;
+        }
+    }
+    return nullptr;
+}
+
+bool FileUtils::getDataFromSearchPack(const std::string& filename, bool forString, Data* data)
+{
+    if (_searchPacks.empty() || filename.empty())
+        return false;
+
+    std::string entryName;
+    FilePack* pack = getSearchPackForPath(fullPathForFilename(filename), &entryName);
+    if (pack == nullptr)
+        return false;
+
+    *data = pack->getEntryData(entryName, forString);
+    if (data->isNull())
+    {
+        CCLOG("Get data from file(%s) in pack(%s) failed!", filename.c_str(), pack->getPath().c_str());
+    }
+    return true;
+}
+
+void FileUtils::setDirectoryIndexEnabled(bool enabled)
+{
+    _directoryIndexEnabled = enabled;
+    if (!enabled)
+    {
+        _directoryIndices.clear();
+        _notFoundCache.clear();
+    }
+}
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+static bool listFilesInDirectory(const std::wstring& dirPath, const std::string& prefix, std::unordered_set<std::string>* files)
+{
+    WIN32_FIND_DATAW data;
+    HANDLE findHandle = ::FindFirstFileW((dirPath + L"*").c_str(), &data);
+    if (findHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    do
+    {
+        if (wcscmp(data.cFileName, L".") == 0 || wcscmp(data.cFileName, L"..") == 0)
+            continue;
+
+        char name[MAX_PATH * 4] = {0};
+        WideCharToMultiByte(CP_UTF8, 0, data.cFileName, -1, name, sizeof(name), nullptr, nullptr);
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            listFilesInDirectory(dirPath + data.cFileName + L"\\", prefix + name + "/", files);
+        }
+        else
+        {
+            files->insert(prefix + name);
+        }
+    } while (::FindNextFileW(findHandle, &data));
+
+    ::FindClose(findHandle);
+    return true;
+}
+#elif (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+static bool listFilesInDirectory(const std::string& dirPath, const std::string& prefix, std::unordered_set<std::string>* files)
+{
+    DIR* dir = opendir(dirPath.c_str());
+    if (dir == nullptr)
+        return false;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+
+        std::string path = dirPath + entry->d_name;
+        bool isDirectory = entry->d_type == DT_DIR;
+        if (entry->d_type == DT_UNKNOWN)
+        {
+            struct stat info;
+            isDirectory = stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+        }
+        else if (entry->d_type == DT_LNK)
+        {
+            // files only, linked directories could make loops
+            struct stat info;
+            if (stat(path.c_str(), &info) != 0 || S_ISDIR(info.st_mode))
+                continue;
+        }
+
+        if (isDirectory)
+        {
+            listFilesInDirectory(path + "/", prefix + entry->d_name + "/", files);
+        }
+        else
+        {
+            files->insert(prefix + entry->d_name);
+        }
+    }
+
+    closedir(dir);
+    return true;
+}
+#endif
+
+bool FileUtils::listFilesRecursively(const std::string& dirPath, std::unordered_set<std::string>* files) const
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    int length = MultiByteToWideChar(CP_UTF8, 0, dirPath.c_str(), -1, nullptr, 0);
+    if (length <= 0)
+        return false;
+    std::vector<WCHAR> wideDirPath(length);
+    MultiByteToWideChar(CP_UTF8, 0, dirPath.c_str(), -1, wideDirPath.data(), length);
+    return listFilesInDirectory(wideDirPath.data(), "", files);
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    return false;
+#else
+    // the paths which aren't on the file system, like the Android assets, fail to open
+    return listFilesInDirectory(dirPath, "", files);
+#endif
+}
+
+const std::unordered_set<std::string>* FileUtils::getDirectoryIndex(const std::string& searchPath)
+{
+    auto iter = _directoryIndices.find(searchPath);
+    if (iter == _directoryIndices.end())
+    {
+        DirectoryIndex& index = _directoryIndices[searchPath];
+        index.listed = !searchPath.empty() && listFilesRecursively(searchPath, &index.files);
+        return index.listed ? &index.files : nullptr;
+    }
+    return iter->second.listed ? &iter->second.files : nullptr;
+}
+
+void FileUtils::invalidateDirectoryIndex(const std::string& path)
+{
+    if (_directoryIndices.empty())
+        return;
+
+    _notFoundCache.clear();
+    for (auto iter = _directoryIndices.begin(); iter != _directoryIndices.end(); )
+    {
+        // the path is under the search path, or the search path is under the path
+        if (path.compare(0, iter->first.length(), iter->first) == 0 || iter->first.compare(0, path.length(), path) == 0)
+            iter = _directoryIndices.erase(iter);
+        else
+            ++iter;
+    }
 }
 
 void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
 {
-    _fullPathCache.clear();    
+    _fullPathCache.clear();
+    _notFoundCache.clear();
     _filenameLookupDict = filenameLookupDict;
 }
 
@@ -961,6 +1309,10 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
+        std::string entryName;
+        FilePack* pack = _searchPacks.empty() ? nullptr : getSearchPackForPath(filename, &entryName);
+        if (pack)
+            return pack->hasEntry(entryName);
         return isFileExistInternal(filename);
     }
     else
@@ -1044,6 +1396,7 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath)
 
 bool FileUtils::createDirectory(const std::string& path)
 {
+    invalidateDirectoryIndex(path);
     CCASSERT(!path.empty(), "Invalid path");
     
     if (isDirectoryExist(path))
@@ -1162,6 +1515,7 @@ static int unlink_cb(const char *fpath, const struct stat *sb, int typeflag, str
 
 bool FileUtils::removeDirectory(const std::string& path)
 {
+    invalidateDirectoryIndex(path);
     if (path.size() > 0 && path[path.size() - 1] != '/')
     {
         CCLOGERROR("Fail to remove directory, path must termniate with '/': %s", path.c_str());
@@ -1232,6 +1586,7 @@ bool FileUtils::removeDirectory(const std::string& path)
 
 bool FileUtils::removeFile(const std::string &path)
 {
+    invalidateDirectoryIndex(path);
     // Remove downloaded file
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -1269,6 +1624,7 @@ bool FileUtils::removeFile(const std::string &path)
 
 bool FileUtils::renameFile(const std::string &path, const std::string &oldname, const std::string &name)
 {
+    invalidateDirectoryIndex(path);
     CCASSERT(!path.empty(), "Invalid path");
     std::string oldPath = path + oldname;
     std::string newPath = path + name;
@@ -1324,6 +1680,14 @@ long FileUtils::getFileSize(const std::string &filepath)
         if (fullpath.empty())
             return 0;
     }
+
+    if (!_searchPacks.empty())
+    {
+        std::string entryName;
+        FilePack* pack = getSearchPackForPath(fullpath, &entryName);
+        if (pack)
+            return (long)pack->getEntrySize(entryName);
+    }
     
     struct stat info;
     // Get data associated with "crt_stat.c":
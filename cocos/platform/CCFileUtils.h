@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <functional>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
@@ -41,6 +43,8 @@ NS_CC_BEGIN
  * @{
  */
 
+class FilePack;
+
 //! @brief  Helper class to handle file operations
 class CC_DLL FileUtils
 {
@@ -102,6 +106,20 @@ public:
      *  @return A data object.
      */
     virtual Data getDataFromFile(const std::string& filename);
+
+    /**
+     *  Reads a file in chunks, without loading it in memory.
+     *  The files that can't be read in parts (in a search pack, in the Android apk...) are loaded
+     *  with getDataFromFile() and given in chunks.
+     *  It can be called on a worker thread with an absolute path.
+     *
+     *  @param filename The file to read.
+     *  @param chunkCallback Called with each chunk in order, it returns false to stop reading.
+     *  @param chunkSize The size of the chunks, the last one can be smaller.
+     *  @return true if the whole file was read.
+     *  @since v4.0
+     */
+    virtual bool readFileInChunks(const std::string& filename, const std::function<bool(const char* chunk, size_t size)>& chunkCallback, size_t chunkSize = 64 * 1024);
     
     /**
      *  Gets resource file data
@@ -287,6 +305,51 @@ public:
       */
     void addSearchPath(const std::string & path, const bool front=false);
     
+    /**
+     *  Mounts a file pack as a search path.
+     *
+     *  The pack is opened once and its full path followed by '/' is added to the search paths,
+     *  so the files it contains are found by fullPathForFilename() like the files of a directory,
+     *  and are read from the pack by getDataFromFile(), getStringFromFile() and getFileData().
+     *  The path of a mounted pack can also be passed to setSearchPaths().
+     *  Looking up a file in a pack is a hash probe in its directory, with no stat() call.
+     *
+     *  @param packPath The path of the pack, built by tools/file-pack/build_pack.py.
+     *  @param front Whether the pack is searched before the other search paths.
+     *  @return true if the pack was mounted, false if it is missing or isn't a valid pack.
+     *  @see FilePack
+     *  @since v4.0
+     */
+    virtual bool addSearchPack(const std::string& packPath, const bool front=false);
+
+    /**
+     *  Unmounts a file pack and removes it from the search paths.
+     *
+     *  @param packPath The path of the pack, as passed to addSearchPack().
+     *  @since v4.0
+     */
+    virtual void removeSearchPack(const std::string& packPath);
+
+    /**
+     *  Enables/Disables the directory index of the search paths.
+     *
+     *  When enabled, the files under a search path are listed once, the first time a file is looked up in it,
+     *  and fullPathForFilename() checks this listing instead of calling isFileExistInternal() for each
+     *  search path and resolution directory. The files that can't be found are cached too.
+     *  The names are compared case-sensitively, and the search paths that can't be listed (e.g. the Android assets)
+     *  are still checked with isFileExistInternal().
+     *
+     *  The index of a search path is rebuilt after FileUtils writes, renames or removes a file under it.
+     *  Call purgeCachedEntries() after the files under a search path were changed by other means.
+     *  Disabled by default.
+     *
+     *  @since v4.0
+     */
+    void setDirectoryIndexEnabled(bool enabled);
+
+    /** Returns whether the directory index of the search paths is enabled. */
+    bool isDirectoryIndexEnabled() const { return _directoryIndexEnabled; }
+
     /**
      *  Gets the array of search paths.
      *  
@@ -319,6 +382,14 @@ public:
      */
     virtual ValueMap getValueMapFromFile(const std::string& filename);
 
+    /**
+     *  Converts the contents of a file to a ValueMap on a worker thread.
+     *  The path is resolved by the caller, the callback is called on the cocos thread when the file is parsed,
+     *  with an empty ValueMap if it can't be read.
+     *  @since v4.0
+     */
+    void getValueMapFromFileAsync(const std::string& filename, const std::function<void(const ValueMap&)>& callback);
+
     /**
      *  Converts the contents of a file to a ValueMap.
      *  @note This method is used internally.
@@ -481,6 +552,39 @@ protected:
      *  @return The full path for the file, if not found, the return value will be an empty string
      */
     virtual std::string searchFullPathForFilename(const std::string& filename) const;
+
+    /**
+     *  Returns the mounted pack that contains a full path.
+     *  @param fullPath The full path of the file.
+     *  @param entryName Set to the name of the file in the pack.
+     *  @return The pack, or nullptr if the path isn't in a mounted pack.
+     */
+    FilePack* getSearchPackForPath(const std::string& fullPath, std::string* entryName) const;
+
+    /**
+     *  Reads a file from the mounted packs.
+     *  @return false if the file isn't in a mounted pack, in which case it must be read from the file system.
+     */
+    bool getDataFromSearchPack(const std::string& filename, bool forString, Data* data);
+
+    /**
+     *  Lists the files under a directory and its sub directories.
+     *  @param dirPath The path of the directory, ending with '/'.
+     *  @param files Filled with the paths of the files, relative to dirPath and separated by '/'.
+     *  @return false if the directory can't be listed.
+     */
+    virtual bool listFilesRecursively(const std::string& dirPath, std::unordered_set<std::string>* files) const;
+
+    /**
+     *  Returns the listing of the files under a search path, which is built the first time.
+     *  @return The listing, or nullptr if the search path can't be listed.
+     */
+    const std::unordered_set<std::string>* getDirectoryIndex(const std::string& searchPath);
+
+    /**
+     *  Drops the directory index of the search paths that contain a path, and the cached missing files.
+     */
+    void invalidateDirectoryIndex(const std::string& path);
     
     
     /** Dictionary used to lookup filenames based on a key.
@@ -518,6 +622,28 @@ protected:
      *  This variable is used for improving the performance of file search.
      */
     std::unordered_map<std::string, std::string> _fullPathCache;
+
+    /**
+     *  The mounted packs, by search path.
+     */
+    std::unordered_map<std::string, FilePack*> _searchPacks;
+
+    struct DirectoryIndex
+    {
+        bool listed;
+        std::unordered_set<std::string> files;
+    };
+
+    /**
+     *  The directory index, by search path. Only used if _directoryIndexEnabled is true.
+     */
+    bool _directoryIndexEnabled;
+    std::unordered_map<std::string, DirectoryIndex> _directoryIndices;
+
+    /**
+     *  The files which weren't found in any search path, cached when all of them have an index.
+     */
+    std::unordered_set<std::string> _notFoundCache;
     
     /**
      * Writable path.
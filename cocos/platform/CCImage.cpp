@@ -477,7 +477,7 @@ Image::~Image()
         for (int i = 0; i < _numberOfMipmaps; ++i)
             CC_SAFE_DELETE_ARRAY(_mipmaps[i].address);
     }
-    else
+    else if (!isDataInFile())
         CC_SAFE_FREE(_data);
 }
 
@@ -487,10 +487,12 @@ bool Image::initWithImageFile(const std::string& path)
     _filePath = FileUtils::getInstance()->fullPathForFilename(path);
 
     Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    // shared, so that the compressed texture formats reference it instead of copying it
+    data.share();
 
     if (!data.isNull())
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        ret = initWithImageData(data);
     }
 
     return ret;
@@ -502,15 +504,24 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
     _filePath = fullpath;
 
     Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
+    // shared, so that the compressed texture formats reference it instead of copying it
+    data.share();
 
     if (!data.isNull())
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        ret = initWithImageData(data);
     }
 
     return ret;
 }
 
+bool Image::initWithImageData(const Data& data)
+{
+    // references a shared buffer, an owned one is copied
+    _fileData = data.slice(0, data.getSize());
+    return initWithImageData(_fileData.getBytes(), _fileData.getSize());
+}
+
 bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
 {
     bool ret = false;
@@ -537,6 +548,12 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
             unpackedLen = dataLen;
         }
 
+        if (unpackedData != data && unpackedData != nullptr)
+        {
+            // the unpacked buffer replaces the file, and is released below if nothing points to it
+            _fileData.setSharedBuffer(unpackedData, unpackedLen, free);
+        }
+
         _fileType = detectFormat(unpackedData, unpackedLen);
 
         switch (_fileType)
@@ -584,15 +601,36 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
             }
         }
         
-        if(unpackedData != data)
-        {
-            free(unpackedData);
-        }
     } while (0);
+
+    if (!isDataInFile())
+    {
+        _fileData.clear();
+    }
     
     return ret;
 }
 
+void Image::setDataFromFile(const unsigned char* bytes, ssize_t length)
+{
+    const unsigned char* fileBytes = _fileData.getBytes();
+    if (fileBytes != nullptr && bytes >= fileBytes && bytes + length <= fileBytes + _fileData.getSize())
+    {
+        _data = const_cast<unsigned char*>(bytes);
+    }
+    else
+    {
+        _data = static_cast<unsigned char*>(malloc(length * sizeof(unsigned char)));
+        memcpy(_data, bytes, length);
+    }
+}
+
+bool Image::isDataInFile() const
+{
+    const unsigned char* fileBytes = _fileData.getBytes();
+    return _data != nullptr && fileBytes != nullptr && _data >= fileBytes && _data < fileBytes + _fileData.getSize();
+}
+
 bool Image::isPng(const unsigned char * data, ssize_t dataLen)
 {
     if (dataLen <= 8)
@@ -1411,8 +1449,7 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
 
     //Move by size of header
     _dataLen = dataLen - sizeof(PVRv2TexHeader);
-    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-    memcpy(_data, (unsigned char*)data + sizeof(PVRv2TexHeader), _dataLen);
+    setDataFromFile(data + sizeof(PVRv2TexHeader), _dataLen);
 
     // Calculate the data size for each texture level and respect the minimum number of blocks
     while (dataOffset < dataLength)
@@ -1561,8 +1598,7 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
 	int blockSize = 0, widthBlocks = 0, heightBlocks = 0;
 	
     _dataLen = dataLen - (sizeof(PVRv3TexHeader) + header->metadataLength);
-    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-    memcpy(_data, static_cast<const unsigned char*>(data) + sizeof(PVRv3TexHeader) + header->metadataLength, _dataLen);
+    setDataFromFile(static_cast<const unsigned char*>(data) + sizeof(PVRv3TexHeader) + header->metadataLength, _dataLen);
 	
 	_numberOfMipmaps = header->numberOfMipmaps;
 	CCAssert(_numberOfMipmaps < MIPMAP_MAX, "Image: Maximum number of mimpaps reached. Increate the CC_MIPMAP_MAX value");
@@ -1693,8 +1729,7 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
 #ifdef GL_ETC1_RGB8_OES
         _renderFormat = Texture2D::PixelFormat::ETC;
         _dataLen = dataLen - ETC_PKM_HEADER_SIZE;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        memcpy(_data, static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, _dataLen);
+        setDataFromFile(static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, _dataLen);
         return true;
 #endif
     }
@@ -1829,8 +1864,8 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     /* load the .dds file */
     
     S3TCTexHeader *header = (S3TCTexHeader *)data;
-    unsigned char *pixelData = static_cast<unsigned char*>(malloc((dataLen - sizeof(S3TCTexHeader)) * sizeof(unsigned char)));
-    memcpy((void *)pixelData, data + sizeof(S3TCTexHeader), dataLen - sizeof(S3TCTexHeader));
+    /* pixelData point to the compressed data address */
+    const unsigned char *pixelData = data + sizeof(S3TCTexHeader);
     
     _width = header->ddsd.width;
     _height = header->ddsd.height;
@@ -1846,8 +1881,7 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     if (Configuration::getInstance()->supportsS3TC())  //compressed data length
     {
         _dataLen = dataLen - sizeof(S3TCTexHeader);
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        memcpy((void *)_data,(void *)pixelData , _dataLen);
+        setDataFromFile(pixelData, _dataLen);
     }
     else                                               //decompressed data length
     {
@@ -1913,15 +1947,15 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
             std::vector<unsigned char> decodeImageData(stride * height);
             if (FOURCC_DXT1 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT1);
+                s3tc_decode(const_cast<unsigned char*>(pixelData) + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT1);
             }
             else if (FOURCC_DXT3 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT3);
+                s3tc_decode(const_cast<unsigned char*>(pixelData) + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT3);
             }
             else if (FOURCC_DXT5 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT5);
+                s3tc_decode(const_cast<unsigned char*>(pixelData) + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT5);
             }
             
             _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
@@ -1937,11 +1971,6 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     
     /* end load the mipmaps */
     
-    if (pixelData != nullptr)
-    {
-        free(pixelData);
-    };
-    
     return true;
 }
 
@@ -1980,8 +2009,7 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
     if (Configuration::getInstance()->supportsATITC())  //compressed data length
     {
         _dataLen = dataLen - sizeof(ATITCTexHeader) - header->bytesOfKeyValueData - 4;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        memcpy((void *)_data,(void *)pixelData , _dataLen);
+        setDataFromFile(pixelData, _dataLen);
     }
     else                                               //decompressed data length
     {
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #define __CC_IMAGE_H__
 
 #include "base/CCRef.h"
+#include "base/CCData.h"
 #include "renderer/CCTexture2D.h"
 
 #if defined(CC_USE_WIC)
@@ -116,6 +117,18 @@ public:
     */
     bool initWithImageData(const unsigned char * data, ssize_t dataLen);
 
+    /**
+    @brief Load image from a Data.
+    The compressed texture formats (PVR, ETC, S3TC, ATITC) reference the bytes of the data
+    instead of copying them, so the buffer stays alive while the image uses it.
+    @param data  the data which holds the image file.
+    @return true if loaded correctly.
+    @since v4.0
+    * @js NA
+    * @lua NA
+    */
+    bool initWithImageData(const Data& data);
+
     // @warning kFmtRawData only support RGBA8888
     bool initWithRawData(const unsigned char * data, ssize_t dataLen, int width, int height, int bitsPerComponent, bool preMulti = false);
 
@@ -174,6 +187,11 @@ protected:
     bool saveImageToJPG(const std::string& filePath);
     
     void premultipliedAlpha();
+
+    // points _data to bytes if they are in _fileData, otherwise copies them
+    void setDataFromFile(const unsigned char* bytes, ssize_t length);
+    // whether _data points to the bytes of _fileData
+    bool isDataInFile() const;
     
 protected:
     /**
@@ -193,6 +211,8 @@ protected:
     // false if we cann't auto detect the image is premultiplied or not.
     bool _hasPremultipliedAlpha;
     std::string _filePath;
+    // the (unpacked) file being loaded, kept afterwards if _data points to its bytes
+    Data _fileData;
 
 
 protected:
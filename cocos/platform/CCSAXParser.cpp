@@ -87,13 +87,382 @@ bool XmlSaxHander::Visit( const tinyxml2::XMLText& text )
 	return true;
 }
 
+/**
+ * Incremental xml tokenizer of SAXParser::parseChunk().
+ * It reports the same events as XmlSaxHander: the text made only of white spaces is skipped,
+ * the entities are decoded, comments, declarations and DOCTYPE are ignored.
+ */
+class SAXStreamParser
+{
+public:
+    explicit SAXStreamParser(SAXParser* parser)
+    : _parser(parser)
+    , _pos(0)
+    , _error(false)
+    {
+    }
+
+    bool parse(const char* data, size_t length)
+    {
+        if (_error)
+            return false;
+        _buffer.append(data, length);
+        process(false);
+        return !_error;
+    }
+
+    bool end()
+    {
+        if (!_error)
+            process(true);
+        // the document must be complete
+        bool ret = !_error && _elements.empty() && _pos == _buffer.size();
+        reset();
+        return ret;
+    }
+
+    void reset()
+    {
+        _buffer.clear();
+        _pos = 0;
+        _error = false;
+        _elements.clear();
+    }
+
+private:
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    static void appendUTF8(std::string& out, unsigned long codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            out += static_cast<char>(codePoint);
+        }
+        else if (codePoint < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    // decodes the entities and normalizes the new lines, like tinyxml2
+    static void decode(const char* begin, const char* end, std::string& out)
+    {
+        out.clear();
+        out.reserve(end - begin);
+        for (const char* p = begin; p < end; ++p)
+        {
+            if (*p == '\r')
+            {
+                out += '\n';
+                if (p + 1 < end && p[1] == '\n')
+                    ++p;
+            }
+            else if (*p == '&')
+            {
+                const char* semicolon = static_cast<const char*>(memchr(p, ';', end - p));
+                size_t length = semicolon ? semicolon - p - 1 : 0;
+                const char* entity = p + 1;
+                if (length == 2 && !strncmp(entity, "lt", 2))
+                    out += '<';
+                else if (length == 2 && !strncmp(entity, "gt", 2))
+                    out += '>';
+                else if (length == 3 && !strncmp(entity, "amp", 3))
+                    out += '&';
+                else if (length == 4 && !strncmp(entity, "quot", 4))
+                    out += '"';
+                else if (length == 4 && !strncmp(entity, "apos", 4))
+                    out += '\'';
+                else if (length > 1 && entity[0] == '#')
+                {
+                    bool hex = entity[1] == 'x' || entity[1] == 'X';
+                    appendUTF8(out, strtoul(entity + (hex ? 2 : 1), nullptr, hex ? 16 : 10));
+                }
+                else
+                {
+                    // not an entity, kept as it is
+                    out += '&';
+                    continue;
+                }
+                p = semicolon;
+            }
+            else
+            {
+                out += *p;
+            }
+        }
+    }
+
+    void text(const char* begin, const char* end)
+    {
+        if (_elements.empty())
+            return;
+
+        const char* p = begin;
+        while (p < end && isSpace(*p))
+            ++p;
+        if (p == end)
+            return;
+
+        decode(begin, end, _text);
+        SAXParser::textHandler(_parser, (const CC_XML_CHAR *)_text.c_str(), static_cast<int>(_text.size()));
+    }
+
+    // parses the tag between '<' and '>', returns false if it is malformed
+    bool tag(const char* begin, const char* end)
+    {
+        if (*begin == '/')
+        {
+            const char* nameEnd = end;
+            while (nameEnd > begin + 1 && isSpace(nameEnd[-1]))
+                --nameEnd;
+            if (_elements.empty() || _elements.back().compare(0, std::string::npos, begin + 1, nameEnd - begin - 1) != 0)
+                return false;
+            SAXParser::endElement(_parser, (const CC_XML_CHAR *)_elements.back().c_str());
+            _elements.pop_back();
+            return true;
+        }
+
+        bool empty = end > begin && end[-1] == '/';
+        if (empty)
+            --end;
+
+        const char* p = begin;
+        while (p < end && !isSpace(*p))
+            ++p;
+        if (p == begin)
+            return false;
+        std::string name(begin, p);
+
+        // the names and values are stored in one buffer, the pointers are set once it is complete
+        _attributes.clear();
+        std::vector<size_t> offsets;
+        while (true)
+        {
+            while (p < end && isSpace(*p))
+                ++p;
+            if (p == end)
+                break;
+
+            const char* attributeName = p;
+            while (p < end && *p != '=' && !isSpace(*p))
+                ++p;
+            size_t nameLength = p - attributeName;
+            while (p < end && isSpace(*p))
+                ++p;
+            if (nameLength == 0 || p == end || *p != '=')
+                return false;
+            ++p;
+            while (p < end && isSpace(*p))
+                ++p;
+            if (p == end || (*p != '"' && *p != '\''))
+                return false;
+            const char* valueEnd = static_cast<const char*>(memchr(p + 1, *p, end - p - 1));
+            if (!valueEnd)
+                return false;
+
+            offsets.push_back(_attributes.size());
+            _attributes.append(attributeName, nameLength);
+            _attributes += '\0';
+            decode(p + 1, valueEnd, _text);
+            offsets.push_back(_attributes.size());
+            _attributes += _text;
+            _attributes += '\0';
+            p = valueEnd + 1;
+        }
+
+        std::vector<const char*> atts;
+        atts.reserve(offsets.size() + 1);
+        for (auto offset : offsets)
+            atts.push_back(_attributes.c_str() + offset);
+        atts.push_back(nullptr);
+
+        SAXParser::startElement(_parser, (const CC_XML_CHAR *)name.c_str(), (const CC_XML_CHAR **)atts.data());
+        if (empty)
+            SAXParser::endElement(_parser, (const CC_XML_CHAR *)name.c_str());
+        else
+            _elements.push_back(name);
+        return true;
+    }
+
+    // returns the end of the tag starting at begin, or nullptr if it isn't complete
+    static const char* findTagEnd(const char* begin, const char* end)
+    {
+        char quote = 0;
+        for (const char* p = begin; p < end; ++p)
+        {
+            if (quote)
+            {
+                if (*p == quote)
+                    quote = 0;
+            }
+            else if (*p == '"' || *p == '\'')
+                quote = *p;
+            else if (*p == '>')
+                return p;
+        }
+        return nullptr;
+    }
+
+    // returns the end of a DOCTYPE, whose internal subset may contain '>'
+    static const char* findDeclarationEnd(const char* begin, const char* end)
+    {
+        int depth = 0;
+        char quote = 0;
+        for (const char* p = begin; p < end; ++p)
+        {
+            if (quote)
+            {
+                if (*p == quote)
+                    quote = 0;
+            }
+            else if (*p == '"' || *p == '\'')
+                quote = *p;
+            else if (*p == '[')
+                ++depth;
+            else if (*p == ']')
+                --depth;
+            else if (*p == '>' && depth <= 0)
+                return p;
+        }
+        return nullptr;
+    }
+
+    static const char* find(const char* begin, const char* end, const char* pattern)
+    {
+        size_t length = strlen(pattern);
+        for (const char* p = begin; p + length <= end; ++p)
+        {
+            if (*p == *pattern && !memcmp(p, pattern, length))
+                return p;
+        }
+        return nullptr;
+    }
+
+    static bool startsWith(const char* begin, const char* end, const char* prefix)
+    {
+        size_t length = strlen(prefix);
+        return static_cast<size_t>(end - begin) >= length && !memcmp(begin, prefix, length);
+    }
+
+    // handles the complete tokens of the buffer, the incomplete one is kept unless it is the last chunk
+    void process(bool last)
+    {
+        const char* data = _buffer.c_str();
+        const char* end = data + _buffer.size();
+        const char* p = data + _pos;
+
+        while (p < end && !_error)
+        {
+            if (*p != '<')
+            {
+                const char* lt = static_cast<const char*>(memchr(p, '<', end - p));
+                if (!lt && !last)
+                    break;
+                text(p, lt ? lt : end);
+                p = lt ? lt : end;
+                continue;
+            }
+
+            // the longest prefix is "<![CDATA["
+            if (end - p < 9 && !last && !memchr(p, '>', end - p))
+                break;
+
+            const char* tokenEnd = nullptr;
+            if (startsWith(p, end, "<?"))
+            {
+                tokenEnd = find(p + 2, end, "?>");
+                if (tokenEnd)
+                    tokenEnd += 2;
+            }
+            else if (startsWith(p, end, "<!--"))
+            {
+                tokenEnd = find(p + 4, end, "-->");
+                if (tokenEnd)
+                    tokenEnd += 3;
+            }
+            else if (startsWith(p, end, "<![CDATA["))
+            {
+                const char* cdataEnd = find(p + 9, end, "]]>");
+                if (cdataEnd)
+                {
+                    if (!_elements.empty())
+                    {
+                        _text.assign(p + 9, cdataEnd);
+                        SAXParser::textHandler(_parser, (const CC_XML_CHAR *)_text.c_str(), static_cast<int>(_text.size()));
+                    }
+                    tokenEnd = cdataEnd + 3;
+                }
+            }
+            else if (startsWith(p, end, "<!"))
+            {
+                tokenEnd = findDeclarationEnd(p + 2, end);
+                if (tokenEnd)
+                    tokenEnd += 1;
+            }
+            else
+            {
+                tokenEnd = findTagEnd(p + 1, end);
+                if (tokenEnd)
+                {
+                    if (!tag(p + 1, tokenEnd))
+                        _error = true;
+                    tokenEnd += 1;
+                }
+            }
+
+            if (!tokenEnd)
+            {
+                if (last)
+                    _error = true;
+                break;
+            }
+            p = tokenEnd;
+        }
+
+        _pos = p - data;
+        // drops the parsed data, but not at every chunk
+        if (_pos == _buffer.size() || _pos > 64 * 1024)
+        {
+            _buffer.erase(0, _pos);
+            _pos = 0;
+        }
+    }
+
+    SAXParser* _parser;
+    std::string _buffer;
+    size_t _pos;
+    bool _error;
+    std::vector<std::string> _elements;
+    std::string _text;
+    std::string _attributes;
+};
+
 SAXParser::SAXParser()
 {
     _delegator = nullptr;
+    _stream = nullptr;
 }
 
 SAXParser::~SAXParser(void)
 {
+    CC_SAFE_DELETE(_stream);
 }
 
 bool SAXParser::init(const char *encoding)
@@ -125,6 +494,30 @@ bool SAXParser::parse(const std::string& filename)
     return ret;
 }
 
+bool SAXParser::parseChunk(const char* xmlData, size_t dataLength)
+{
+    if (!_stream)
+    {
+        _stream = new (std::nothrow) SAXStreamParser(this);
+    }
+    return _stream->parse(xmlData, dataLength);
+}
+
+bool SAXParser::endParse()
+{
+    return _stream ? _stream->end() : false;
+}
+
+bool SAXParser::parseStream(const std::string& filename)
+{
+    bool ret = FileUtils::getInstance()->readFileInChunks(filename, [this](const char* chunk, size_t size) {
+        return parseChunk(chunk, size);
+    });
+    // resets the parser even if the file can't be read
+    bool complete = endParse();
+    return ret && complete;
+}
+
 void SAXParser::startElement(void *ctx, const CC_XML_CHAR *name, const CC_XML_CHAR **atts)
 {
     ((SAXParser*)(ctx))->_delegator->startElement(ctx, (char*)name, (const char**)atts);
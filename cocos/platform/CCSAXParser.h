@@ -59,9 +59,12 @@ public:
     virtual void textHandler(void *ctx, const char *s, int len) = 0;
 };
 
+class SAXStreamParser;
+
 class CC_DLL SAXParser
 {
     SAXDelegator*    _delegator;
+    SAXStreamParser* _stream;
 public:
     /**
      * @js NA
@@ -88,6 +91,31 @@ public:
      * @lua NA
      */
     bool parse(const std::string& filename);
+    /**
+     * Parses a part of a xml document. The delegator is called for the elements complete so far,
+     * the rest is kept until the next chunk. endParse() must be called after the last chunk.
+     * @return false if the xml is malformed
+     * @since v4.0
+     * @js NA
+     * @lua NA
+     */
+    bool parseChunk(const char* xmlData, size_t dataLength);
+    /**
+     * Ends the parse of the chunks given to parseChunk(), and resets the parser.
+     * @return false if the xml is malformed or not complete
+     * @since v4.0
+     * @js NA
+     * @lua NA
+     */
+    bool endParse();
+    /**
+     * Parses a file while it is read in chunks by FileUtils::readFileInChunks(), without building a document.
+     * It can be called on a worker thread with an absolute path, if the delegator allows it.
+     * @since v4.0
+     * @js NA
+     * @lua NA
+     */
+    bool parseStream(const std::string& filename);
     /**
      * @js NA
      * @lua NA
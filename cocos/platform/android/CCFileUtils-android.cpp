@@ -310,7 +310,9 @@ Data FileUtilsAndroid::getData(const std::string& filename, bool forString)
 
 std::string FileUtilsAndroid::getStringFromFile(const std::string& filename)
 {
-    Data data = getData(filename, true);
+    Data data;
+    if (!getDataFromSearchPack(filename, true, &data))
+        data = getData(filename, true);
     if (data.isNull())
         return "";
 
@@ -320,6 +322,9 @@ std::string FileUtilsAndroid::getStringFromFile(const std::string& filename)
     
 Data FileUtilsAndroid::getDataFromFile(const std::string& filename)
 {
+    Data data;
+    if (getDataFromSearchPack(filename, false, &data))
+        return data;
     return getData(filename, false);
 }
 
@@ -331,6 +336,12 @@ unsigned char* FileUtilsAndroid::getFileData(const std::string& filename, const
     {
         return 0;
     }
+
+    Data packData;
+    if (getDataFromSearchPack(filename, false, &packData))
+    {
+        return packData.takeBuffer(size);
+    }
     
     string fullPath = fullPathForFilename(filename);
     cocosplay::updateAssets(fullPath);
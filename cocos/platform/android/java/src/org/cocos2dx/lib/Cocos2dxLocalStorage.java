@@ -51,6 +51,7 @@ public class Cocos2dxLocalStorage {
             TABLE_NAME = tableName;
             mDatabaseOpenHelper = new DBOpenHelper(Cocos2dxActivity.getContext());
             mDatabase = mDatabaseOpenHelper.getWritableDatabase();
+            mDatabase.enableWriteAheadLogging();
             return true;
         }
         return false;
@@ -100,6 +101,23 @@ public class Cocos2dxLocalStorage {
             e.printStackTrace();
         }
     }
+
+    public static void beginTransaction() {
+        try {
+            mDatabase.beginTransaction();
+        } catch (Exception e) {
+            e.printStackTrace();
+        }
+    }
+
+    public static void commitTransaction() {
+        try {
+            mDatabase.setTransactionSuccessful();
+            mDatabase.endTransaction();
+        } catch (Exception e) {
+            e.printStackTrace();
+        }
+    }
     
 
     /**
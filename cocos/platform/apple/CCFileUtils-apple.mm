@@ -415,6 +415,16 @@ std::string FileUtilsApple::getFullPathForDirectoryAndFilename(const std::string
 ValueMap FileUtilsApple::getValueMapFromFile(const std::string& filename)
 {
     std::string fullPath = fullPathForFilename(filename);
+
+    // NSDictionary can't read the files in the mounted packs
+    Data packData;
+    if (getDataFromSearchPack(fullPath, false, &packData))
+    {
+        if (packData.isNull())
+            return ValueMap();
+        return getValueMapFromData((const char*)packData.getBytes(), (int)packData.getSize());
+    }
+
     NSString* path = [NSString stringWithUTF8String:fullPath.c_str()];
     NSDictionary* dict = [NSDictionary dictionaryWithContentsOfFile:path];
 
@@ -453,6 +463,7 @@ ValueMap FileUtilsApple::getValueMapFromData(const char* filedata, int filesize)
 
 bool FileUtilsApple::writeToFile(ValueMap& dict, const std::string &fullPath)
 {
+    invalidateDirectoryIndex(fullPath);
     //CCLOG("iOS||Mac Dictionary %d write to file %s", dict->_ID, fullPath.c_str());
     NSMutableDictionary *nsDict = [NSMutableDictionary dictionary];
 
@@ -476,8 +487,29 @@ ValueVector FileUtilsApple::getValueVectorFromFile(const std::string& filename)
     //    pPath = [[NSBundle mainBundle] pathForResource:pPath ofType:pathExtension];
     //    fixing cannot read data using Array::createWithContentsOfFile
     std::string fullPath = fullPathForFilename(filename);
-    NSString* path = [NSString stringWithUTF8String:fullPath.c_str()];
-    NSArray* array = [NSArray arrayWithContentsOfFile:path];
+    NSArray* array = nil;
+
+    // NSArray can't read the files in the mounted packs
+    Data packData;
+    if (getDataFromSearchPack(fullPath, false, &packData))
+    {
+        if (!packData.isNull())
+        {
+            NSData* file = [NSData dataWithBytes:packData.getBytes() length:packData.getSize()];
+            NSPropertyListFormat format;
+            NSError* error;
+            id plist = [NSPropertyListSerialization propertyListWithData:file options:NSPropertyListImmutable format:&format error:&error];
+            if ([plist isKindOfClass:[NSArray class]])
+            {
+                array = plist;
+            }
+        }
+    }
+    else
+    {
+        NSString* path = [NSString stringWithUTF8String:fullPath.c_str()];
+        array = [NSArray arrayWithContentsOfFile:path];
+    }
 
     ValueVector ret;
 
@@ -202,7 +202,9 @@ static Data getData(const std::string& filename, bool forString)
 
 std::string FileUtilsWin32::getStringFromFile(const std::string& filename)
 {
-    Data data = getData(filename, true);
+    Data data;
+    if (!getDataFromSearchPack(filename, true, &data))
+        data = getData(filename, true);
 	if (data.isNull())
 	{
 		return "";
@@ -214,6 +216,9 @@ std::string FileUtilsWin32::getStringFromFile(const std::string& filename)
     
 Data FileUtilsWin32::getDataFromFile(const std::string& filename)
 {
+    Data data;
+    if (getDataFromSearchPack(filename, false, &data))
+        return data;
     return getData(filename, false);
 }
 
@@ -221,6 +226,13 @@ unsigned char* FileUtilsWin32::getFileData(const std::string& filename, const ch
 {
     unsigned char * pBuffer = nullptr;
     *size = 0;
+
+    Data data;
+    if (getDataFromSearchPack(filename, false, &data))
+    {
+        return data.takeBuffer(size);
+    }
+
     do
     {
         // read the file from hardware
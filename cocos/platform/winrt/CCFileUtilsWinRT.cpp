@@ -185,7 +185,9 @@ static Data getData(const std::string& filename, bool forString)
 
 std::string CCFileUtilsWinRT::getStringFromFile(const std::string& filename)
 {
-    Data data = getData(filename, true);
+    Data data;
+    if (!getDataFromSearchPack(filename, true, &data))
+        data = getData(filename, true);
 	if (data.isNull())
 	{
 		return "";
@@ -25,6 +25,8 @@
 #include "renderer/CCRenderer.h"
 
 #include <algorithm>
+#include <cfloat>
+#include <chrono>
 
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCQuadCommand.h"
@@ -41,21 +43,24 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCThreadPool.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
 
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// maps a float to an unsigned integer with the same ordering
+static inline uint32_t floatToSortKey(float value)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    //negative numbers: flip all the bits to reverse their order, positive numbers: set the sign bit to put them after
+    return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
 }
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
-{
-    return  a->getDepth() > b->getDepth();
-}
+// below this size an insertion sort is cheaper than the radix sort passes
+static const size_t RADIX_SORT_MIN_SIZE = 32;
 
 // queue
 
@@ -104,9 +109,79 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    radixSort(_commands[QUEUE_GROUP::TRANSPARENT_3D], true);
+    radixSort(_commands[QUEUE_GROUP::GLOBALZ_NEG], false);
+    radixSort(_commands[QUEUE_GROUP::GLOBALZ_POS], false);
+}
+
+void RenderQueue::radixSort(std::vector<RenderCommand*>& commands, bool byDepth)
+{
+    const size_t count = commands.size();
+    if (count < 2)
+        return;
+    
+    _sortEntries.resize(count);
+    _sortScratch.resize(count);
+    
+    SortEntry* src = _sortEntries.data();
+    SortEntry* dst = _sortScratch.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        RenderCommand* command = commands[i];
+        //farther commands (greater depth) are drawn first
+        src[i].key = byDepth ? ~floatToSortKey(command->getDepth()) : floatToSortKey(command->getGlobalOrder());
+        src[i].command = command;
+    }
+    
+    if (count < RADIX_SORT_MIN_SIZE)
+    {
+        //stable insertion sort
+        for (size_t i = 1; i < count; ++i)
+        {
+            SortEntry entry = src[i];
+            size_t j = i;
+            for (; j > 0 && src[j - 1].key > entry.key; --j)
+            {
+                src[j] = src[j - 1];
+            }
+            src[j] = entry;
+        }
+    }
+    else
+    {
+        //LSD radix sort, one byte per pass. Each pass is stable, so equal keys keep their insertion order
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            size_t histogram[256] = {0};
+            for (size_t i = 0; i < count; ++i)
+            {
+                histogram[(src[i].key >> shift) & 0xFF]++;
+            }
+            
+            //all the keys share this byte, the pass would not move anything
+            if (histogram[(src[0].key >> shift) & 0xFF] == count)
+                continue;
+            
+            size_t offset = 0;
+            for (int bucket = 0; bucket < 256; ++bucket)
+            {
+                size_t bucketSize = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketSize;
+            }
+            
+            for (size_t i = 0; i < count; ++i)
+            {
+                dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+    }
+    
+    for (size_t i = 0; i < count; ++i)
+    {
+        commands[i] = src[i].command;
+    }
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -129,10 +204,11 @@ RenderCommand* RenderQueue::operator[](ssize_t index) const
 
 void RenderQueue::clear()
 {
-    _commands.clear();
+    //keep the capacity of the sub queues, they are refilled every frame
+    _commands.resize(QUEUE_COUNT);
     for(int index = 0; index < QUEUE_COUNT; ++index)
     {
-        _commands.push_back(std::vector<RenderCommand*>());
+        _commands[index].clear();
     }
 }
 
@@ -171,6 +247,107 @@ void RenderQueue::restoreRenderState()
     CHECK_GL_ERROR_DEBUG();
 }
 
+//points the position/color/texcoord attributes at a V3F_C4B_T2F array starting at offset in the bound VBO
+static void setVertexAttribPointers(GLintptr offset)
+{
+    // vertices
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, vertices)));
+    
+    // colors
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, colors)));
+    
+    // tex coords
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, texCoords)));
+}
+
+// batches with less vertices than this are filled on the render thread
+static const int PARALLEL_FILL_MIN_VERTICES = 2048;
+// upper bound of jobs a batch is split in
+static const int PARALLEL_FILL_MAX_JOBS = 16;
+
+static void fillQuadVertices(const QuadCommand* cmd, V3F_C4B_T2F* verts)
+{
+    const V3F_C4B_T2F* quads =  (V3F_C4B_T2F*)cmd->getQuads();
+    const ssize_t vertexCount = cmd->getQuadCount() * 4;
+    
+    //copy colors and texture coordinates, then transform the positions of the whole span in one go
+    memcpy(verts, quads, sizeof(V3F_C4B_T2F) * vertexCount);
+    cmd->getModelView().transformPoints(&quads->vertices, &verts->vertices, sizeof(V3F_C4B_T2F), vertexCount);
+}
+
+static void fillTriangleVertices(const TrianglesCommand* cmd, V3F_C4B_T2F* verts, GLushort* indices, int vertexOffset)
+{
+    memcpy(verts, cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
+    
+    //transform the whole span in one go, in place
+    cmd->getModelView().transformPoints(&verts->vertices, &verts->vertices, sizeof(V3F_C4B_T2F), cmd->getVertexCount());
+    
+    const unsigned short* cmdIndices = cmd->getIndices();
+    //fill index
+    for(ssize_t i=0; i< cmd->getIndexCount(); ++i)
+    {
+        indices[i] = vertexOffset + cmdIndices[i];
+    }
+}
+
+//
+// batch reorder
+//
+
+//how many batches back a command may be moved, bounds the cost of the reorder
+static const int BATCH_REORDER_MAX_LOOKBACK = 64;
+
+static bool isBatchReorderable(RenderCommand* command)
+{
+    auto type = command->getType();
+    return type == RenderCommand::Type::QUAD_COMMAND || type == RenderCommand::Type::TRIANGLES_COMMAND;
+}
+
+//computes the screen-space bounds of the command in normalized device coordinates,
+//returns false when they can't be computed (e.g. vertices behind the camera)
+static bool getScreenBounds(RenderCommand* command, const Mat4& projection, float* minX, float* minY, float* maxX, float* maxY)
+{
+    const V3F_C4B_T2F* verts = nullptr;
+    ssize_t vertexCount = 0;
+    const Mat4* modelView = nullptr;
+    if (command->getType() == RenderCommand::Type::QUAD_COMMAND)
+    {
+        auto cmd = static_cast<QuadCommand*>(command);
+        verts = &cmd->getQuads()->tl;
+        vertexCount = cmd->getQuadCount() * 4;
+        modelView = &cmd->getModelView();
+    }
+    else
+    {
+        auto cmd = static_cast<TrianglesCommand*>(command);
+        verts = cmd->getVertices();
+        vertexCount = cmd->getVertexCount();
+        modelView = &cmd->getModelView();
+    }
+    if (verts == nullptr || vertexCount <= 0)
+        return false;
+    
+    Mat4 mvp = projection * (*modelView);
+    *minX = *minY = FLT_MAX;
+    *maxX = *maxY = -FLT_MAX;
+    Vec4 clip;
+    for (ssize_t i = 0; i < vertexCount; ++i)
+    {
+        const Vec3& pos = verts[i].vertices;
+        mvp.transformVector(Vec4(pos.x, pos.y, pos.z, 1.0f), &clip);
+        if (clip.w <= FLT_EPSILON)
+            return false;
+        float invW = 1.0f / clip.w;
+        float x = clip.x * invW;
+        float y = clip.y * invW;
+        *minX = std::min(*minX, x);
+        *maxX = std::max(*maxX, x);
+        *minY = std::min(*minY, y);
+        *maxY = std::max(*maxY, y);
+    }
+    return true;
+}
+
 //
 //
 //
@@ -186,14 +363,28 @@ Renderer::Renderer()
 ,_filledIndex(0)
 ,_numberQuads(0)
 ,_glViewAssigned(false)
+,_drawnBatches(0)
+,_drawnVertices(0)
+,_uploadedBytes(0)
+,_streamingBufferWraps(0)
+,_stalledUploads(0)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
+,_isParallelFillEnabled(false)
+,_isBatchReorderEnabled(false)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
 {
     _groupCommandManager = new (std::nothrow) GroupCommandManager();
     
+    _verts = new V3F_C4B_T2F[VBO_SIZE];
+    _indices = new GLushort[INDEX_VBO_SIZE];
+    _quadVerts = new V3F_C4B_T2F[VBO_SIZE];
+    _quadIndices = new GLushort[INDEX_VBO_SIZE];
+    _buffersOffset[0] = _buffersOffset[1] = 0;
+    _quadbuffersOffset = 0;
+    
     _commandGroupStack.push(DEFAULT_RENDER_QUEUE);
     
     RenderQueue defaultRenderQueue;
@@ -208,6 +399,10 @@ Renderer::~Renderer()
 {
     _renderGroups.clear();
     _groupCommandManager->release();
+    CC_SAFE_DELETE_ARRAY(_verts);
+    CC_SAFE_DELETE_ARRAY(_indices);
+    CC_SAFE_DELETE_ARRAY(_quadVerts);
+    CC_SAFE_DELETE_ARRAY(_quadIndices);
     
     glDeleteBuffers(2, _buffersVBO);
     glDeleteBuffers(2, _quadbuffersVBO);
@@ -272,7 +467,7 @@ void Renderer::setupVBOAndVAO()
     glGenBuffers(2, &_buffersVBO[0]);
 
     glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE * STREAMING_BUFFER_BATCHES, nullptr, GL_STREAM_DRAW);
 
     // vertices
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -287,7 +482,7 @@ void Renderer::setupVBOAndVAO()
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE * STREAMING_BUFFER_BATCHES, nullptr, GL_STREAM_DRAW);
 
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
@@ -301,7 +496,7 @@ void Renderer::setupVBOAndVAO()
     glGenBuffers(2, &_quadbuffersVBO[0]);
     
     glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * VBO_SIZE, _quadVerts, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * VBO_SIZE * STREAMING_BUFFER_BATCHES, nullptr, GL_STREAM_DRAW);
     
     // vertices
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -323,6 +518,9 @@ void Renderer::setupVBOAndVAO()
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     
+    _buffersOffset[0] = _buffersOffset[1] = 0;
+    _quadbuffersOffset = 0;
+    
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -339,24 +537,73 @@ void Renderer::mapBuffers()
     GL::bindVAO(0);
 
     glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE * STREAMING_BUFFER_BATCHES, nullptr, GL_STREAM_DRAW);
     
     glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * VBO_SIZE, _quadVerts, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * VBO_SIZE * STREAMING_BUFFER_BATCHES, nullptr, GL_STREAM_DRAW);
     
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE * STREAMING_BUFFER_BATCHES, nullptr, GL_STREAM_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_quadIndices[0]) * INDEX_VBO_SIZE, _quadIndices, GL_STATIC_DRAW);
     
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
+    _buffersOffset[0] = _buffersOffset[1] = 0;
+    _quadbuffersOffset = 0;
+
     CHECK_GL_ERROR_DEBUG();
 }
 
+GLintptr Renderer::streamData(GLenum target, GLintptr& offset, GLsizeiptr capacity, const void* data, GLsizeiptr size)
+{
+    CCASSERT(size <= capacity, "data doesn't fit in the streaming buffer");
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    if (offset + size > capacity)
+    {
+        //orphan the storage: pending draws keep using the old one, so there is nothing to wait for
+        glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+        offset = 0;
+        _streamingBufferWraps++;
+    }
+    
+    //the range was never written since the storage was (re)allocated, no need to synchronize with the GPU
+    bool uploaded = false;
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    if (Configuration::getInstance()->supportsMapBufferRange())
+    {
+        void *buf = glMapBufferRange(target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (buf)
+        {
+            memcpy(buf, data, size);
+            glUnmapBuffer(target);
+            uploaded = true;
+        }
+    }
+#endif
+    if (!uploaded)
+    {
+        glBufferSubData(target, offset, size, data);
+    }
+    
+    GLintptr result = offset;
+    offset += size;
+    _uploadedBytes += size;
+    
+    //an upload taking more than a millisecond means the driver made us wait
+    if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(1))
+    {
+        _stalledUploads++;
+    }
+    
+    return result;
+}
+
 void Renderer::addCommand(RenderCommand* command)
 {
     int renderQueue =_commandGroupStack.top();
@@ -600,9 +847,39 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
             glDisable(GL_DEPTH_TEST);
             glDepthMask(false);
         }
-        for (auto it = zZeroQueue.cbegin(); it != zZeroQueue.cend(); ++it)
+        if (_isBatchReorderEnabled)
         {
-            processRenderCommand(*it);
+            //reorder each run of quads/triangles when it is reached, so that it is projected
+            //with the projection set by the commands before it (e.g. RenderTexture)
+            size_t index = 0;
+            const size_t count = zZeroQueue.size();
+            while (index < count)
+            {
+                if (!isBatchReorderable(zZeroQueue[index]))
+                {
+                    processRenderCommand(zZeroQueue[index]);
+                    ++index;
+                    continue;
+                }
+                size_t end = index + 1;
+                while (end < count && isBatchReorderable(zZeroQueue[end]))
+                {
+                    ++end;
+                }
+                reorderForBatching(zZeroQueue, index, end);
+                for (const auto& command : _reorderedCommands)
+                {
+                    processRenderCommand(command);
+                }
+                index = end;
+            }
+        }
+        else
+        {
+            for (auto it = zZeroQueue.cbegin(); it != zZeroQueue.cend(); ++it)
+            {
+                processRenderCommand(*it);
+            }
         }
         flush();
     }
@@ -623,6 +900,94 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     queue.restoreRenderState();
 }
 
+void Renderer::reorderForBatching(const std::vector<RenderCommand*>& commands, size_t begin, size_t end)
+{
+    _reorderedCommands.clear();
+    if (end - begin < 3)
+    {
+        _reorderedCommands.insert(_reorderedCommands.end(), commands.begin() + begin, commands.begin() + end);
+        return;
+    }
+    
+    const Mat4& projection = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    _reorderBatches.clear();
+    _reorderNext.assign(end - begin, -1);
+    
+    for (size_t i = begin; i < end; ++i)
+    {
+        auto command = commands[i];
+        auto type = command->getType();
+        uint32_t materialID;
+        bool skipBatching = command->isSkipBatching();
+        if (type == RenderCommand::Type::QUAD_COMMAND)
+            materialID = static_cast<QuadCommand*>(command)->getMaterialID();
+        else
+            materialID = static_cast<TrianglesCommand*>(command)->getMaterialID();
+        
+        float minX, minY, maxX, maxY;
+        if (!getScreenBounds(command, projection, &minX, &minY, &maxX, &maxY))
+        {
+            //unknown bounds overlap everything
+            minX = minY = -FLT_MAX;
+            maxX = maxY = FLT_MAX;
+        }
+        
+        //walk back from the last batch: the command can join a batch with the same material
+        //as long as no batch after it overlaps the command
+        const int batchCount = (int)_reorderBatches.size();
+        const int lowest = std::max(0, batchCount - BATCH_REORDER_MAX_LOOKBACK);
+        int target = -1;
+        if (!skipBatching && materialID != MATERIAL_ID_DO_NOT_BATCH)
+        {
+            for (int k = batchCount - 1; k >= lowest; --k)
+            {
+                const auto& batch = _reorderBatches[k];
+                if (batch.mergeable && batch.type == type && batch.materialID == materialID)
+                {
+                    target = k;
+                    break;
+                }
+                //strict test: commands that only share an edge don't cover the same pixels
+                if (batch.minX < maxX && minX < batch.maxX && batch.minY < maxY && minY < batch.maxY)
+                    break;
+            }
+        }
+        
+        int index = (int)(i - begin);
+        if (target < 0)
+        {
+            ReorderBatch batch;
+            batch.type = type;
+            batch.materialID = materialID;
+            batch.mergeable = !skipBatching && materialID != MATERIAL_ID_DO_NOT_BATCH;
+            batch.minX = minX;
+            batch.minY = minY;
+            batch.maxX = maxX;
+            batch.maxY = maxY;
+            batch.head = batch.tail = index;
+            _reorderBatches.push_back(batch);
+        }
+        else
+        {
+            auto& batch = _reorderBatches[target];
+            _reorderNext[batch.tail] = index;
+            batch.tail = index;
+            batch.minX = std::min(batch.minX, minX);
+            batch.minY = std::min(batch.minY, minY);
+            batch.maxX = std::max(batch.maxX, maxX);
+            batch.maxY = std::max(batch.maxY, maxY);
+        }
+    }
+    
+    for (const auto& batch : _reorderBatches)
+    {
+        for (int index = batch.head; index >= 0; index = _reorderNext[index])
+        {
+            _reorderedCommands.push_back(commands[begin + index]);
+        }
+    }
+}
+
 void Renderer::render()
 {
     //Uncomment this once everything is rendered by new renderer
@@ -696,21 +1061,10 @@ void Renderer::setDepthTest(bool enable)
 
 void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
 {
-    memcpy(_verts + _filledVertex, cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
-    const Mat4& modelView = cmd->getModelView();
-    
-    for(ssize_t i=0; i< cmd->getVertexCount(); ++i)
+    //when filling in parallel, the batch is filled right before being drawn
+    if (!_isParallelFillEnabled)
     {
-        V3F_C4B_T2F *q = &_verts[i + _filledVertex];
-        Vec3 *vec1 = (Vec3*)&q->vertices;
-        modelView.transformPoint(vec1);
-    }
-    
-    const unsigned short* indices = cmd->getIndices();
-    //fill index
-    for(ssize_t i=0; i< cmd->getIndexCount(); ++i)
-    {
-        _indices[_filledIndex + i] = _filledVertex + indices[i];
+        fillTriangleVertices(cmd, _verts + _filledVertex, _indices + _filledIndex, _filledVertex);
     }
     
     _filledVertex += cmd->getVertexCount();
@@ -719,17 +1073,114 @@ void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
 
 void Renderer::fillQuads(const QuadCommand *cmd)
 {
-    const Mat4& modelView = cmd->getModelView();
-    const V3F_C4B_T2F* quads =  (V3F_C4B_T2F*)cmd->getQuads();
-    for(ssize_t i=0; i< cmd->getQuadCount() * 4; ++i)
+    //when filling in parallel, the batch is filled right before being drawn
+    if (!_isParallelFillEnabled)
     {
-        _quadVerts[i + _numberQuads * 4] = quads[i];
-        modelView.transformPoint(quads[i].vertices,&(_quadVerts[i + _numberQuads * 4].vertices));
+        fillQuadVertices(cmd, _quadVerts + _numberQuads * 4);
     }
     
     _numberQuads += cmd->getQuadCount();
 }
 
+void Renderer::setParallelFillEnabled(bool enabled)
+{
+    CCASSERT(!_isRendering, "Cannot change the fill mode while rendering");
+    
+    if (enabled && ThreadPool::getInstance()->getThreadCount() == 0)
+    {
+        CCLOG("cocos2d: Renderer: parallel fill needs more than one hardware thread");
+        return;
+    }
+    _isParallelFillEnabled = enabled;
+}
+
+int Renderer::partitionFillJobs()
+{
+    const int commandCount = (int)_fillVertexOffsets.size() - 1;
+    const int totalVertices = _fillVertexOffsets.back();
+    const int jobCount = std::min(std::min(ThreadPool::getInstance()->getThreadCount() + 1, PARALLEL_FILL_MAX_JOBS), commandCount);
+    
+    //each job gets a contiguous range of commands of about the same vertex count
+    _fillJobBounds.clear();
+    _fillJobBounds.push_back(0);
+    for (int command = 1, job = 1; command < commandCount && job < jobCount; ++command)
+    {
+        if (_fillVertexOffsets[command] >= (int64_t)totalVertices * job / jobCount)
+        {
+            _fillJobBounds.push_back(command);
+            ++job;
+        }
+    }
+    _fillJobBounds.push_back(commandCount);
+    
+    return (int)_fillJobBounds.size() - 1;
+}
+
+void Renderer::fillBatchedTrianglesInParallel()
+{
+    _fillVertexOffsets.clear();
+    _fillIndexOffsets.clear();
+    int vertexOffset = 0;
+    int indexOffset = 0;
+    for (const auto& cmd : _batchedCommands)
+    {
+        _fillVertexOffsets.push_back(vertexOffset);
+        _fillIndexOffsets.push_back(indexOffset);
+        vertexOffset += (int)cmd->getVertexCount();
+        indexOffset += (int)cmd->getIndexCount();
+    }
+    _fillVertexOffsets.push_back(vertexOffset);
+    _fillIndexOffsets.push_back(indexOffset);
+    
+    auto fillRange = [this](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+        {
+            fillTriangleVertices(_batchedCommands[i], _verts + _fillVertexOffsets[i], _indices + _fillIndexOffsets[i], _fillVertexOffsets[i]);
+        }
+    };
+    
+    if (vertexOffset < PARALLEL_FILL_MIN_VERTICES || _batchedCommands.size() < 2)
+    {
+        fillRange(0, (int)_batchedCommands.size());
+        return;
+    }
+    
+    int jobCount = partitionFillJobs();
+    ThreadPool::getInstance()->parallelFor(jobCount, [this, &fillRange](int job) {
+        fillRange(_fillJobBounds[job], _fillJobBounds[job + 1]);
+    });
+}
+
+void Renderer::fillBatchedQuadsInParallel()
+{
+    _fillVertexOffsets.clear();
+    int vertexOffset = 0;
+    for (const auto& cmd : _batchQuadCommands)
+    {
+        _fillVertexOffsets.push_back(vertexOffset);
+        vertexOffset += (int)cmd->getQuadCount() * 4;
+    }
+    _fillVertexOffsets.push_back(vertexOffset);
+    
+    auto fillRange = [this](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+        {
+            fillQuadVertices(_batchQuadCommands[i], _quadVerts + _fillVertexOffsets[i]);
+        }
+    };
+    
+    if (vertexOffset < PARALLEL_FILL_MIN_VERTICES || _batchQuadCommands.size() < 2)
+    {
+        fillRange(0, (int)_batchQuadCommands.size());
+        return;
+    }
+    
+    int jobCount = partitionFillJobs();
+    ThreadPool::getInstance()->parallelFor(jobCount, [this, &fillRange](int job) {
+        fillRange(_fillJobBounds[job], _fillJobBounds[job + 1]);
+    });
+}
+
 void Renderer::drawBatchedTriangles()
 {
     //TODO: we can improve the draw performance by insert material switching command before hand.
@@ -743,51 +1194,30 @@ void Renderer::drawBatchedTriangles()
         return;
     }
 
+    if (_isParallelFillEnabled)
+    {
+        fillBatchedTrianglesInParallel();
+    }
+
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         //Bind VAO
         GL::bindVAO(_buffersVAO);
-        //Set VBO data
         glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        // option 1: subdata
-//        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
-
-        // option 2: data
-//        glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * (n-start), &quads_[start], GL_DYNAMIC_DRAW);
-
-        // option 3: orphaning + glMapBuffer
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex, nullptr, GL_DYNAMIC_DRAW);
-        void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-        memcpy(buf, _verts, sizeof(_verts[0])* _filledVertex);
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
     }
     else
     {
-#define kQuadSize sizeof(_verts[0])
         glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex , _verts, GL_DYNAMIC_DRAW);
-
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
-
-        // vertices
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
-
-        // colors
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, colors));
-
-        // tex coords
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
     }
+    
+    //Append the batch to the streaming buffers and point the attributes at it
+    GLintptr vertexOffset = streamData(GL_ARRAY_BUFFER, _buffersOffset[0], sizeof(_verts[0]) * VBO_SIZE * STREAMING_BUFFER_BATCHES, _verts, sizeof(_verts[0]) * _filledVertex);
+    setVertexAttribPointers(vertexOffset);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    GLintptr indexOffset = streamData(GL_ELEMENT_ARRAY_BUFFER, _buffersOffset[1], sizeof(_indices[0]) * INDEX_VBO_SIZE * STREAMING_BUFFER_BATCHES, _indices, sizeof(_indices[0]) * _filledIndex);
 
     //Start drawing verties in batch
     for(const auto& cmd : _batchedCommands)
@@ -798,7 +1228,7 @@ void Renderer::drawBatchedTriangles()
             //Draw quads
             if(indexToDraw > 0)
             {
-                glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (startIndex*sizeof(_indices[0])) );
+                glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexOffset + startIndex*sizeof(_indices[0])) );
                 _drawnBatches++;
                 _drawnVertices += indexToDraw;
 
@@ -817,7 +1247,7 @@ void Renderer::drawBatchedTriangles()
     //Draw any remaining triangles
     if(indexToDraw > 0)
     {
-        glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (startIndex*sizeof(_indices[0])) );
+        glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexOffset + startIndex*sizeof(_indices[0])) );
         _drawnBatches++;
         _drawnVertices += indexToDraw;
     }
@@ -851,50 +1281,29 @@ void Renderer::drawBatchedQuads()
         return;
     }
     
+    if (_isParallelFillEnabled)
+    {
+        fillBatchedQuadsInParallel();
+    }
+    
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         //Bind VAO
         GL::bindVAO(_quadVAO);
-        //Set VBO data
         glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
-        
-        // option 1: subdata
-        //        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
-        
-        // option 2: data
-        //        glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * (n-start), &quads_[start], GL_DYNAMIC_DRAW);
-        
-        // option 3: orphaning + glMapBuffer
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * _numberQuads * 4, nullptr, GL_DYNAMIC_DRAW);
-        void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-        memcpy(buf, _quadVerts, sizeof(_quadVerts[0])* _numberQuads * 4);
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-        
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
     }
     else
     {
-#define kQuadSize sizeof(_verts[0])
         glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
-        
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * _numberQuads * 4 , _quadVerts, GL_DYNAMIC_DRAW);
-        
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
-        
-        // vertices
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
-        
-        // colors
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, colors));
-        
-        // tex coords
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
-        
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
     }
     
+    //Append the batch to the streaming buffer and point the attributes at it, the indices never change
+    GLintptr vertexOffset = streamData(GL_ARRAY_BUFFER, _quadbuffersOffset, sizeof(_quadVerts[0]) * VBO_SIZE * STREAMING_BUFFER_BATCHES, _quadVerts, sizeof(_quadVerts[0]) * _numberQuads * 4);
+    setVertexAttribPointers(vertexOffset);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
     //Start drawing verties in batch
     for(const auto& cmd : _batchQuadCommands)
     {
@@ -45,8 +45,9 @@ class MeshCommand;
  Since the commands that have `z == 0` are "pushed back" in
  the correct order, the only `RenderCommand` objects that need to be sorted,
  are the ones that have `z < 0` and `z > 0`.
+ The sort is a stable radix sort: commands with the same key keep their insertion order.
 */
-class RenderQueue {
+class CC_DLL RenderQueue {
 public:
     enum QUEUE_GROUP
     {
@@ -75,9 +76,21 @@ public:
     void restoreRenderState();
     
 protected:
+    struct SortEntry
+    {
+        uint32_t key;
+        RenderCommand* command;
+    };
+    
+    //sorts by globalOrder ascending, or by depth descending (back to front) for transparent 3D commands
+    void radixSort(std::vector<RenderCommand*>& commands, bool byDepth);
     
     std::vector<std::vector<RenderCommand*>> _commands;
     
+    //scratch buffers of radixSort, kept between frames to avoid allocations
+    std::vector<SortEntry> _sortEntries;
+    std::vector<SortEntry> _sortScratch;
+    
     //Render State related
     bool _isCullEnabled;
     bool _isDepthEnabled;
@@ -102,6 +115,9 @@ public:
     static const int VBO_SIZE = 65536;
     static const int INDEX_VBO_SIZE = VBO_SIZE * 6 / 4;
     
+    // the VBOs are used as ring buffers that can hold this many full batches before wrapping around
+    static const int STREAMING_BUFFER_BATCHES = 3;
+    
     static const int BATCH_QUADCOMMAND_RESEVER_SIZE = 64;
     static const int MATERIAL_ID_DO_NOT_BATCH = 0;
     
@@ -145,8 +161,14 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) QuadCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of bytes of vertices and indices uploaded to the GPU in the last frame, shown with the other draw stats */
+    ssize_t getUploadedBytes() const { return _uploadedBytes; }
+    /* returns how many times the streaming buffers wrapped around (and were orphaned) in the last frame */
+    ssize_t getStreamingBufferWraps() const { return _streamingBufferWraps; }
+    /* returns the number of uploads that blocked the render thread in the last frame */
+    ssize_t getStalledUploads() const { return _stalledUploads; }
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats() { _drawnBatches = _drawnVertices = _uploadedBytes = _streamingBufferWraps = _stalledUploads = 0; }
 
     /**
      * Enable/Disable depth test
@@ -160,6 +182,29 @@ public:
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
 
+    /**
+     * Enable/Disable filling the vertex/index staging arrays on worker threads.
+     * When enabled, the copy and transform of a batch of QuadCommands/TrianglesCommands
+     * is deferred until the batch is drawn, then split into disjoint ranges that are
+     * filled in parallel. GL calls are still issued on the render thread.
+     * Disabled by default.
+     */
+    void setParallelFillEnabled(bool enabled);
+    /** returns whether the staging arrays are filled on worker threads */
+    bool isParallelFillEnabled() const { return _isParallelFillEnabled; }
+
+    /**
+     * Enable/Disable reordering the Global-Z = 0 queue to reduce draw calls.
+     * Consecutive QuadCommands/TrianglesCommands are regrouped by material ID, but a command
+     * is never moved before an earlier command whose screen-space bounds intersect its own,
+     * so the rendered result is the same as in scene graph order.
+     * Any other command (custom, group, scissor, stencil...) is kept in place and is never crossed.
+     * Disabled by default.
+     */
+    void setBatchReorderEnabled(bool enabled) { _isBatchReorderEnabled = enabled; }
+    /** returns whether the Global-Z = 0 queue is reordered to reduce draw calls */
+    bool isBatchReorderEnabled() const { return _isBatchReorderEnabled; }
+
 protected:
 
     //Setup VBO or VAO based on OpenGL extensions
@@ -167,6 +212,8 @@ protected:
     void setupVBOAndVAO();
     void setupVBO();
     void mapBuffers();
+    //appends data to the bound streaming buffer and returns its offset in bytes
+    GLintptr streamData(GLenum target, GLintptr& offset, GLsizeiptr capacity, const void* data, GLsizeiptr size);
     void drawBatchedTriangles();
     void drawBatchedQuads();
 
@@ -182,10 +229,32 @@ protected:
 
     void processRenderCommand(RenderCommand* command);
     void visitRenderQueue(RenderQueue& queue);
+    
+    //a run of commands sharing a material, in the batch reorder mode
+    struct ReorderBatch
+    {
+        RenderCommand::Type type;
+        uint32_t materialID;
+        bool mergeable;
+        //union of the screen-space bounds of the commands, in normalized device coordinates
+        float minX, minY, maxX, maxY;
+        //indices of the first and last commands, chained by _reorderNext
+        int head;
+        int tail;
+    };
+    
+    //regroups commands[begin, end) by material into _reorderedCommands, without changing the order of overlapping commands
+    void reorderForBatching(const std::vector<RenderCommand*>& commands, size_t begin, size_t end);
 
     void fillVerticesAndIndices(const TrianglesCommand* cmd);
     void fillQuads(const QuadCommand* cmd);
 
+    //fill the staging arrays of the current batch on the worker threads
+    void fillBatchedTrianglesInParallel();
+    void fillBatchedQuadsInParallel();
+    //split the commands described by _fillVertexOffsets in jobs of similar vertex count, returns the number of jobs
+    int partitionFillJobs();
+
     /* clear color set outside be used in setGLDefaultValues() */
     Color4F _clearColor;
 
@@ -200,19 +269,21 @@ protected:
     std::vector<QuadCommand*> _batchQuadCommands;
 
     //for TrianglesCommand
-    V3F_C4B_T2F _verts[VBO_SIZE];
-    GLushort _indices[INDEX_VBO_SIZE];
+    V3F_C4B_T2F* _verts;
+    GLushort* _indices;
     GLuint _buffersVAO;
     GLuint _buffersVBO[2]; //0: vertex  1: indices
+    GLintptr _buffersOffset[2]; //write offsets in the streaming buffers
 
     int _filledVertex;
     int _filledIndex;
     
     //for QuadCommand
-    V3F_C4B_T2F _quadVerts[VBO_SIZE];
-    GLushort _quadIndices[INDEX_VBO_SIZE];
+    V3F_C4B_T2F* _quadVerts;
+    GLushort* _quadIndices;
     GLuint _quadVAO;
     GLuint _quadbuffersVBO[2]; //0: vertex  1: indices
+    GLintptr _quadbuffersOffset; //write offset in the streaming vertex buffer
     int _numberQuads;
     
     bool _glViewAssigned;
@@ -220,11 +291,26 @@ protected:
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _uploadedBytes;
+    ssize_t _streamingBufferWraps;
+    ssize_t _stalledUploads;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
     bool _isDepthTestFor2D;
     
+    //parallel fill of the staging arrays
+    bool _isParallelFillEnabled;
+    std::vector<int> _fillJobBounds;
+    std::vector<int> _fillVertexOffsets;
+    std::vector<int> _fillIndexOffsets;
+    
+    //batch reorder of the Global-Z = 0 queue
+    bool _isBatchReorderEnabled;
+    std::vector<ReorderBatch> _reorderBatches;
+    std::vector<int> _reorderNext;
+    std::vector<RenderCommand*> _reorderedCommands;
+    
     GroupCommandManager* _groupCommandManager;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
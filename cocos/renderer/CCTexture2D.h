@@ -285,6 +285,11 @@ public:
     */
     void setAliasTexParameters();
 
+    /** whether the texture uses the anti alias (GL_LINEAR) or the alias (GL_NEAREST) filtering
+    @since v4.0
+    */
+    bool isAntiAliasEnabled() const { return _antialiasEnabled; }
+
 
     /** Generates mipmap images for the texture.
     It only works if the texture size is POT (power of 2).
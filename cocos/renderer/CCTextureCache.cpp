@@ -28,11 +28,13 @@ THE SOFTWARE.
 #include "renderer/CCTextureCache.h"
 
 #include <errno.h>
+#include <algorithm>
 #include <stack>
 #include <cctype>
 #include <list>
 
 #include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureTranscoder.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
@@ -52,11 +54,12 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _asyncStructQueue(nullptr)
-, _imageInfoQueue(nullptr)
-, _needQuit(false)
+: _decodedQueue(std::make_shared<DecodedQueue>())
+, _asyncDecodeThreadCount(0)
+, _asyncMaxDecodedImages(0)
+, _asyncUploadBudget(0)
 , _asyncRefCount(0)
+, _memoryBudget(0)
 {
 }
 
@@ -67,7 +70,13 @@ TextureCache::~TextureCache()
     for( auto it=_textures.begin(); it!=_textures.end(); ++it)
         (it->second)->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    // the decodings still running complete into _decodedQueue, which they keep alive
+    _asyncToken.cancel();
+    
+    if (_memoryBudget > 0)
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::evictTextures), this);
+    }
 }
 
 void TextureCache::destroyInstance()
@@ -89,6 +98,11 @@ std::string TextureCache::getDescription() const
 }
 
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback)
+{
+    addImageAsync(path, callback, ThreadPool::TaskPriority::NORMAL);
+}
+
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, ThreadPool::TaskPriority priority)
 {
     Texture2D *texture = nullptr;
 
@@ -104,16 +118,20 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
         return;
     }
 
-    // lazy init
-    if (_asyncStructQueue == nullptr)
-    {             
-        _asyncStructQueue = new queue<AsyncStruct*>();
-        _imageInfoQueue   = new deque<ImageInfo*>();        
-
-        // create a new thread to load images
-        _loadingThread = new std::thread(&TextureCache::loadImage, this);
-
-        _needQuit = false;
+    // the image is already being loaded, wait for it
+    auto found = _asyncStructs.find(fullpath);
+    if (found != _asyncStructs.end())
+    {
+        auto& asyncStruct = found->second;
+        asyncStruct->callbacks.push_back(callback);
+        if (!asyncStruct->dispatched && priority < asyncStruct->priority)
+        {
+            // the entry left in the lower priority queue is skipped
+            asyncStruct->priority = priority;
+            _asyncPending[(int)priority].push_back(asyncStruct);
+            dispatchAsyncDecodes();
+        }
+        return;
     }
 
     if (0 == _asyncRefCount)
@@ -124,150 +142,121 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     ++_asyncRefCount;
 
     // generate async struct
-    AsyncStruct *data = new (std::nothrow) AsyncStruct(fullpath, callback);
-
-    // add async struct into queue
-    _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
-    _asyncStructQueueMutex.unlock();
+    auto asyncStruct = std::make_shared<AsyncStruct>(fullpath, priority);
+    asyncStruct->callbacks.push_back(callback);
+    asyncStruct->requestTime = utils::gettime();
+    _asyncStructs.insert(std::make_pair(fullpath, asyncStruct));
+    _asyncPending[(int)priority].push_back(asyncStruct);
 
-    _sleepCondition.notify_one();
+    dispatchAsyncDecodes();
 }
 
-void TextureCache::unbindImageAsync(const std::string& filename)
+void TextureCache::dispatchAsyncDecodes()
 {
-    _imageInfoMutex.lock();
-    if (_imageInfoQueue && !_imageInfoQueue->empty())
+    auto threadPool = ThreadPool::getInstance();
+    int decodeCount = _asyncDecodeThreadCount > 0 ? _asyncDecodeThreadCount : std::max(threadPool->getThreadCount(), 1);
+    
+    int maxDecodedImages = _asyncMaxDecodedImages > 0 ? _asyncMaxDecodedImages : decodeCount * 2;
+    
+    int decoding;
+    int decoded;
+    {
+        std::lock_guard<std::mutex> lock(_decodedQueue->mutex);
+        decoding = _decodedQueue->decoding;
+        decoded = (int)_decodedQueue->images.size();
+    }
+    
+    // the decodings in flight are bounded, and so are the images decoded ahead of their upload
+    for (int priority = 0; priority < ThreadPool::TASK_PRIORITY_COUNT; ++priority)
     {
-        std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
-        auto found = std::find_if(_imageInfoQueue->begin(), _imageInfoQueue->end(), [&fullpath](ImageInfo* ptr)->bool{ return ptr->asyncStruct->filename == fullpath; });
-        if (found != _imageInfoQueue->end())
+        auto& pending = _asyncPending[priority];
+        while (!pending.empty() && decoding < decodeCount && decoding + decoded < maxDecodedImages)
         {
-            (*found)->asyncStruct->callback = nullptr;
+            auto asyncStruct = pending.front();
+            pending.pop_front();
+            if (asyncStruct->dispatched || (int)asyncStruct->priority != priority)
+                continue;
+            
+            asyncStruct->dispatched = true;
+            ++decoding;
+            {
+                std::lock_guard<std::mutex> lock(_decodedQueue->mutex);
+                ++_decodedQueue->decoding;
+            }
+            
+            auto decodedQueue = _decodedQueue;
+            bool transcode = TextureTranscoder::getInstance()->isEnabled();
+            threadPool->enqueue([asyncStruct, decodedQueue, transcode]{
+                asyncStruct->decodeStartTime = utils::gettime();
+                Image* image = new (std::nothrow) Image();
+                bool loaded = image && (transcode ? TextureTranscoder::getInstance()->initImage(image, asyncStruct->filename)
+                                                  : image->initWithImageFileThreadSafe(asyncStruct->filename));
+                if (image && !loaded)
+                {
+                    CC_SAFE_RELEASE_NULL(image);
+                    CCLOG("can not load %s", asyncStruct->filename.c_str());
+                }
+                asyncStruct->image = image;
+                asyncStruct->decodeEndTime = utils::gettime();
+                
+                std::lock_guard<std::mutex> lock(decodedQueue->mutex);
+                --decodedQueue->decoding;
+                decodedQueue->images.push_back(asyncStruct);
+            }, asyncStruct->priority, nullptr, &_asyncToken);
         }
     }
-    _imageInfoMutex.unlock();
 }
 
-void TextureCache::unbindAllImageAsync()
+void TextureCache::unbindImageAsync(const std::string& filename)
 {
-    _imageInfoMutex.lock();
-    if (_imageInfoQueue && !_imageInfoQueue->empty())
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
+    auto found = _asyncStructs.find(fullpath);
+    if (found != _asyncStructs.end())
     {
-        std::for_each(_imageInfoQueue->begin(), _imageInfoQueue->end(), [](ImageInfo* ptr) { ptr->asyncStruct->callback = nullptr; });
+        found->second->callbacks.clear();
     }
-    _imageInfoMutex.unlock();
 }
 
-void TextureCache::loadImage()
+void TextureCache::unbindAllImageAsync()
 {
-    AsyncStruct *asyncStruct = nullptr;
-
-    while (true)
-    {
-        std::queue<AsyncStruct*> *pQueue = _asyncStructQueue;
-        _asyncStructQueueMutex.lock();
-        if (pQueue->empty())
-        {
-            _asyncStructQueueMutex.unlock();
-            if (_needQuit) {
-                break;
-            }
-            else {
-                std::unique_lock<std::mutex> lk(_sleepMutex);
-                _sleepCondition.wait(lk);
-                continue;
-            }
-        }
-        else
-        {
-            asyncStruct = pQueue->front();
-            pQueue->pop();
-            _asyncStructQueueMutex.unlock();
-        }        
-
-        Image *image = nullptr;
-        bool generateImage = false;
-
-        auto it = _textures.find(asyncStruct->filename);
-        if( it == _textures.end() )
-        {
-           _imageInfoMutex.lock();
-           ImageInfo *imageInfo;
-           size_t pos = 0;
-           size_t infoSize = _imageInfoQueue->size();
-           for (; pos < infoSize; pos++)
-           {
-               imageInfo = (*_imageInfoQueue)[pos];
-               if(imageInfo->asyncStruct->filename.compare(asyncStruct->filename) == 0)
-                   break;
-           }
-           _imageInfoMutex.unlock();
-           if(infoSize == 0 || pos == infoSize)
-               generateImage = true;
-        }
-
-        if (generateImage)
-        {
-            const std::string& filename = asyncStruct->filename;
-            // generate image      
-            image = new (std::nothrow) Image();
-            if (image && !image->initWithImageFileThreadSafe(filename))
-            {
-                CC_SAFE_RELEASE(image);
-                CCLOG("can not load %s", filename.c_str());
-                continue;
-            }
-        }    
-
-        // generate image info
-        ImageInfo *imageInfo = new (std::nothrow) ImageInfo();
-        imageInfo->asyncStruct = asyncStruct;
-        imageInfo->image = image;
-
-        // put the image info into the queue
-        _imageInfoMutex.lock();
-        _imageInfoQueue->push_back(imageInfo);
-        _imageInfoMutex.unlock();
-    }
-    
-	if(_asyncStructQueue != nullptr)
+    for (auto& asyncStruct : _asyncStructs)
     {
-        delete _asyncStructQueue;
-	    _asyncStructQueue = nullptr;
-        delete _imageInfoQueue;
-	    _imageInfoQueue = nullptr;
+        asyncStruct.second->callbacks.clear();
     }
 }
 
 void TextureCache::addImageAsyncCallBack(float dt)
 {
-    // the image is generated in loading thread
-    std::deque<ImageInfo*> *imagesQueue = _imageInfoQueue;
-
-    _imageInfoMutex.lock();
-    if (imagesQueue->empty())
-    {
-        _imageInfoMutex.unlock();
-    }
-    else
+    double startTime = utils::gettime();
+    do
     {
-        ImageInfo *imageInfo = imagesQueue->front();
-        imagesQueue->pop_front();
-        _imageInfoMutex.unlock();
-
-        AsyncStruct *asyncStruct = imageInfo->asyncStruct;
-        Image *image = imageInfo->image;
-
+        // the image is generated in a worker thread
+        std::shared_ptr<AsyncStruct> asyncStruct;
+        {
+            std::lock_guard<std::mutex> lock(_decodedQueue->mutex);
+            if (_decodedQueue->images.empty())
+                break;
+            asyncStruct = _decodedQueue->images.front();
+            _decodedQueue->images.pop_front();
+        }
+        
+        double uploadStartTime = utils::gettime();
         const std::string& filename = asyncStruct->filename;
+        Image *image = asyncStruct->image;
 
         Texture2D *texture = nullptr;
-        if (image)
+        auto it = _textures.find(filename);
+        if (it != _textures.end())
+        {
+            // loaded meanwhile by addImage()
+            texture = it->second;
+        }
+        else if (image)
         {
             // generate texture in render thread
             texture = new (std::nothrow) Texture2D();
 
-            texture->initWithImage(image);
+            initTextureWithImage(texture, image, filename);
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
             // cache the texture file name
@@ -275,34 +264,42 @@ void TextureCache::addImageAsyncCallBack(float dt)
 #endif
             // cache the texture. retain it, since it is added in the map
             _textures.insert( std::make_pair(filename, texture) );
+            _textureLastUsedFrames[filename] = Director::getInstance()->getTotalFrames();
             texture->retain();
 
             texture->autorelease();
         }
         else
         {
-            auto it = _textures.find(asyncStruct->filename);
-            if(it != _textures.end())
-                texture = it->second;
+            CCLOG("cocos2d: failed to call TextureCache::addImageAsync(%s)", filename.c_str());
         }
+        double uploadEndTime = utils::gettime();
         
-        if (asyncStruct->callback)
+        _asyncStructs.erase(filename);
+        for (const auto& callback : asyncStruct->callbacks)
         {
-            asyncStruct->callback(texture);
+            if (callback)
+                callback(texture);
         }
         
-        if(image)
-        {
-            image->release();
-        }       
-        delete asyncStruct;
-        delete imageInfo;
-
-        --_asyncRefCount;
-        if (0 == _asyncRefCount)
+        if (_asyncLoadTimingsCallback)
         {
-            Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
+            AsyncLoadTimings timings;
+            timings.filename = filename;
+            timings.waitTime = (float)(asyncStruct->decodeStartTime - asyncStruct->requestTime);
+            timings.decodeTime = (float)(asyncStruct->decodeEndTime - asyncStruct->decodeStartTime);
+            timings.uploadTime = (float)(uploadEndTime - uploadStartTime);
+            _asyncLoadTimingsCallback(timings);
         }
+        
+        --_asyncRefCount;
+    } while (utils::gettime() - startTime < _asyncUploadBudget);
+    
+    dispatchAsyncDecodes();
+    
+    if (0 == _asyncRefCount)
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
     }
 }
 
@@ -321,7 +318,12 @@ Texture2D * TextureCache::addImage(const std::string &path)
     }
     auto it = _textures.find(fullpath);
     if( it != _textures.end() )
+    {
         texture = it->second;
+        auto lastUsedFrame = _textureLastUsedFrames.find(fullpath);
+        if (lastUsedFrame != _textureLastUsedFrames.end())
+            lastUsedFrame->second = Director::getInstance()->getTotalFrames();
+    }
 
     if (! texture)
     {
@@ -331,12 +333,13 @@ Texture2D * TextureCache::addImage(const std::string &path)
             image = new (std::nothrow) Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            auto transcoder = TextureTranscoder::getInstance();
+            bool bRet = transcoder->isEnabled() ? transcoder->initImage(image, fullpath) : image->initWithImageFile(fullpath);
             CC_BREAK_IF(!bRet);
 
             texture = new (std::nothrow) Texture2D();
 
-            if( texture && texture->initWithImage(image) )
+            if( texture && initTextureWithImage(texture, image, fullpath) )
             {
 #if CC_ENABLE_CACHE_TEXTURE_DATA
                 // cache the texture file name
@@ -344,6 +347,7 @@ Texture2D * TextureCache::addImage(const std::string &path)
 #endif
                 // texture already retained, no need to re-retain it
                 _textures.insert( std::make_pair(fullpath, texture) );
+                _textureLastUsedFrames[fullpath] = Director::getInstance()->getTotalFrames();
             }
             else
             {
@@ -357,6 +361,31 @@ Texture2D * TextureCache::addImage(const std::string &path)
     return texture;
 }
 
+bool TextureCache::initTextureWithImage(Texture2D* texture, Image* image, const std::string& fullpath)
+{
+    auto evicted = _evictedTextures.find(fullpath);
+    if (evicted == _evictedTextures.end())
+    {
+        return texture->initWithImage(image);
+    }
+    
+    EvictedTexture state = evicted->second;
+    _evictedTextures.erase(evicted);
+    if (!texture->initWithImage(image, state.pixelFormat))
+    {
+        return false;
+    }
+    if (state.hasMipmaps)
+    {
+        texture->generateMipmap();
+    }
+    if (!state.antialias)
+    {
+        texture->setAliasTexParameters();
+    }
+    return true;
+}
+
 Texture2D* TextureCache::addImage(Image *image, const std::string &key)
 {
     CCASSERT(image != nullptr, "TextureCache: image MUST not be nil");
@@ -423,7 +452,8 @@ bool TextureCache::reloadTexture(const std::string& fileName)
             image = new (std::nothrow) Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            auto transcoder = TextureTranscoder::getInstance();
+            bool bRet = transcoder->isEnabled() ? transcoder->initImage(image, fullpath) : image->initWithImageFile(fullpath);
             CC_BREAK_IF(!bRet);
             
             ret = texture->initWithImage(image);
@@ -443,6 +473,8 @@ void TextureCache::removeAllTextures()
         (it->second)->release();
     }
     _textures.clear();
+    _textureLastUsedFrames.clear();
+    _evictedTextures.clear();
 }
 
 void TextureCache::removeUnusedTextures()
@@ -453,6 +485,7 @@ void TextureCache::removeUnusedTextures()
             CCLOG("cocos2d: TextureCache: removing unused texture: %s", it->first.c_str());
 
             tex->release();
+            _textureLastUsedFrames.erase(it->first);
             _textures.erase(it++);
         } else {
             ++it;
@@ -471,6 +504,7 @@ void TextureCache::removeTexture(Texture2D* texture)
     for( auto it=_textures.cbegin(); it!=_textures.cend(); /* nothing */ ) {
         if( it->second == texture ) {
             texture->release();
+            _textureLastUsedFrames.erase(it->first);
             _textures.erase(it++);
             break;
         } else
@@ -488,8 +522,12 @@ void TextureCache::removeTextureForKey(const std::string &textureKeyName)
         it = _textures.find(key);
     }
 
+    // an evicted texture is no longer in _textures, its state is forgotten as well
+    _evictedTextures.erase(key);
+
     if( it != _textures.end() ) {
         (it->second)->release();
+        _textureLastUsedFrames.erase(it->first);
         _textures.erase(it);
     }
 }
@@ -519,10 +557,8 @@ void TextureCache::reloadAllTextures()
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
-    _needQuit = true;
-    _sleepCondition.notify_one();
-    if (_loadingThread) _loadingThread->join();
+    // the images that didn't start decoding are dropped, the others complete without the cache
+    _asyncToken.cancel();
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -559,9 +595,91 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp)-1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    if (_memoryBudget > 0)
+    {
+        snprintf(buftmp, sizeof(buftmp)-1, "TextureCache budget: %lu KB, %ld evicted textures\n", (unsigned long)(_memoryBudget / 1024), (long)_evictedTextures.size());
+        buffer += buftmp;
+    }
+
     return buffer;
 }
 
+static size_t getTextureBytes(Texture2D* texture)
+{
+    size_t bytes = (size_t)texture->getPixelsWide() * texture->getPixelsHigh() * texture->getBitsPerPixelForFormat() / 8;
+    // the mipmaps add a third
+    return texture->hasMipmaps() ? bytes * 4 / 3 : bytes;
+}
+
+size_t TextureCache::getMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const auto& texture : _textures)
+    {
+        bytes += getTextureBytes(texture.second);
+    }
+    return bytes;
+}
+
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    auto scheduler = Director::getInstance()->getScheduler();
+    if (bytes > 0 && _memoryBudget == 0)
+    {
+        // after the updates and the actions of the frame, which may release textures
+        scheduler->schedule(CC_SCHEDULE_SELECTOR(TextureCache::evictTextures), this, 0, false);
+    }
+    else if (bytes == 0 && _memoryBudget > 0)
+    {
+        scheduler->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::evictTextures), this);
+    }
+    _memoryBudget = bytes;
+}
+
+void TextureCache::evictTextures(float dt)
+{
+    unsigned int frame = Director::getInstance()->getTotalFrames();
+    size_t bytes = 0;
+    std::vector<std::pair<unsigned int, std::string>> unusedTextures;
+    for (const auto& texture : _textures)
+    {
+        bytes += getTextureBytes(texture.second);
+        
+        auto lastUsedFrame = _textureLastUsedFrames.find(texture.first);
+        if (lastUsedFrame == _textureLastUsedFrames.end())
+            continue;
+        if (texture.second->getReferenceCount() > 1)
+            lastUsedFrame->second = frame;
+        else
+            unusedTextures.push_back(std::make_pair(lastUsedFrame->second, texture.first));
+    }
+    
+    if (bytes <= _memoryBudget)
+        return;
+    
+    std::sort(unusedTextures.begin(), unusedTextures.end());
+    for (const auto& unusedTexture : unusedTextures)
+    {
+        if (bytes <= _memoryBudget)
+            break;
+        
+        auto it = _textures.find(unusedTexture.second);
+        Texture2D* texture = it->second;
+        CCLOG("cocos2d: TextureCache: evicting texture: %s", it->first.c_str());
+        
+        EvictedTexture state;
+        state.pixelFormat = texture->getPixelFormat();
+        state.hasMipmaps = texture->hasMipmaps();
+        state.antialias = texture->isAntiAliasEnabled();
+        _evictedTextures[it->first] = state;
+        
+        bytes -= getTextureBytes(texture);
+        texture->release();
+        _textureLastUsedFrames.erase(it->first);
+        _textures.erase(it);
+    }
+}
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 
 std::list<VolatileTexture*> VolatileTextureMgr::_textures;
@@ -721,9 +839,19 @@ void VolatileTextureMgr::reloadAllTextures()
             {
                 Image* image = new (std::nothrow) Image();
                 
-                Data data = FileUtils::getInstance()->getDataFromFile(vt->_fileName);
+                auto transcoder = TextureTranscoder::getInstance();
+                bool loaded = false;
+                if (image && transcoder->isEnabled())
+                {
+                    loaded = transcoder->initImage(image, vt->_fileName);
+                }
+                else if (image)
+                {
+                    Data data = FileUtils::getInstance()->getDataFromFile(vt->_fileName);
+                    loaded = image->initWithImageData(data.getBytes(), data.getSize());
+                }
                 
-                if (image && image->initWithImageData(data.getBytes(), data.getSize()))
+                if (loaded)
                 {
                     Texture2D::PixelFormat oldPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
                     Texture2D::setDefaultAlphaPixelFormat(vt->_pixelFormat);
@@ -36,8 +36,11 @@ THE SOFTWARE.
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <memory>
+#include <vector>
 
 #include "base/CCRef.h"
+#include "base/CCThreadPool.h"
 #include "renderer/CCTexture2D.h"
 #include "platform/CCImage.h"
 
@@ -114,11 +117,52 @@ public:
     * If the file image was not previously loaded, it will create a new Texture2D object and it will return it.
     * Otherwise it will load a texture in a new thread, and when the image is loaded, the callback will be called with the Texture2D as a parameter.
     * The callback will be called from the main thread, so it is safe to create any cocos2d object from the callback.
+    * If the image can't be loaded, the callback is called with nullptr.
     * Supported image extensions: .png, .jpg
     * @since v0.8
     */
     virtual void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback);
     
+    /* Same as addImageAsync(), with a priority: images needed right now should use HIGH, prefetched ones LOW.
+    * Images are decoded on the ThreadPool, higher priorities first. A file requested again before it is loaded
+    * is decoded once, with the highest of the priorities, and all the callbacks are called.
+    * @since v4.0
+    */
+    void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback, ThreadPool::TaskPriority priority);
+    
+    /* Sets the maximum number of images decoded at the same time by addImageAsync(), the others wait in the queues of the cache.
+    * 0, the default, uses as many as the ThreadPool has threads.
+    * @since v4.0
+    */
+    void setAsyncDecodeThreadCount(int count) { _asyncDecodeThreadCount = count; }
+    
+    /* Sets the maximum number of images loaded by addImageAsync() that are being decoded or wait for their upload,
+    * so that decoded images don't pile up in memory when the uploads are slower than the decodings.
+    * 0, the default, uses twice the number of images decoded at the same time.
+    * @since v4.0
+    */
+    void setAsyncMaxDecodedImages(int count) { _asyncMaxDecodedImages = count; }
+    
+    /* Sets the time, in seconds, the main thread can spend each frame creating the textures of the images loaded by addImageAsync().
+    * At least one texture is created per frame. 0, the default, creates only one texture per frame.
+    * @since v4.0
+    */
+    void setAsyncUploadBudget(float seconds) { _asyncUploadBudget = seconds; }
+    
+    /** Timings of the loading of a texture by addImageAsync() */
+    struct AsyncLoadTimings
+    {
+        std::string filename;   ///< full path of the image
+        float waitTime;         ///< seconds between the request and the start of the decoding
+        float decodeTime;       ///< seconds spent decoding the image on a worker thread
+        float uploadTime;       ///< seconds spent creating the texture on the main thread
+    };
+    
+    /* Sets a function called on the main thread with the timings of each texture loaded by addImageAsync(), or nullptr
+    * @since v4.0
+    */
+    void setAsyncLoadTimingsCallback(const std::function<void(const AsyncLoadTimings&)>& callback) { _asyncLoadTimingsCallback = callback; }
+    
     /* Unbind a specified bound image asynchronous callback
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
      * the object always need to unbind this callback manually.
@@ -185,47 +229,91 @@ public:
     */
     std::string getCachedTextureInfo() const;
 
-    //wait for texture cahe to quit befor destroy instance
+    /** Sets the GPU memory, in bytes, the textures of the cache should fit in. 0, the default, means no budget.
+    * Each frame, while the textures use more memory, the unused textures loaded from files are removed,
+    * least recently used first. A texture is unused when only the cache retains it.
+    * A removed texture is loaded again by the next addImage() or addImageAsync() of its file,
+    * with the pixel format, mipmaps and filtering it had.
+    * @since v4.0
+    */
+    void setMemoryBudget(size_t bytes);
+    /** Returns the GPU memory budget of the textures, in bytes
+    * @since v4.0
+    */
+    size_t getMemoryBudget() const { return _memoryBudget; }
+    /** Returns the GPU memory used by the textures of the cache, in bytes
+    * @since v4.0
+    */
+    size_t getMemoryUsage() const;
+
+    //stops the decoding of the images that are not loaded yet, before destroying the cache
     //called by director, please do not called outside
     void waitForQuit();
 
 private:
     void addImageAsyncCallBack(float dt);
-    void loadImage();
+    void dispatchAsyncDecodes();
+    //inits the texture of a file, as it was if it has been evicted
+    bool initTextureWithImage(Texture2D* texture, Image* image, const std::string& fullpath);
+    //removes the least recently used textures while the memory used is above the budget
+    void evictTextures(float dt);
 
 public:
     struct AsyncStruct
     {
     public:
-        AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f) {}
+        AsyncStruct(const std::string& fn, ThreadPool::TaskPriority p) : filename(fn), priority(p), image(nullptr), dispatched(false), requestTime(0), decodeStartTime(0), decodeEndTime(0) {}
+        ~AsyncStruct() { CC_SAFE_RELEASE(image); }
 
         std::string filename;
-        std::function<void(Texture2D*)> callback;
+        std::vector<std::function<void(Texture2D*)>> callbacks;
+        ThreadPool::TaskPriority priority;
+        Image* image;           // decoded image, nullptr if the decoding failed
+        bool dispatched;        // whether the decoding was handed to the ThreadPool
+        double requestTime;
+        double decodeStartTime;
+        double decodeEndTime;
     };
 
 protected:
-    typedef struct _ImageInfo
+    // images decoded by the worker threads, waiting for their upload on the main thread.
+    // shared with the tasks so that they can complete after the cache is gone
+    struct DecodedQueue
     {
-        AsyncStruct *asyncStruct;
-        Image        *image;
-    } ImageInfo;
+        std::mutex mutex;
+        std::deque<std::shared_ptr<AsyncStruct>> images;
+        int decoding;   // images handed to the ThreadPool and not decoded yet
+        
+        DecodedQueue() : decoding(0) {}
+    };
     
-    std::thread* _loadingThread;
-
-    std::queue<AsyncStruct*>* _asyncStructQueue;
-    std::deque<ImageInfo*>* _imageInfoQueue;
-
-    std::mutex _asyncStructQueueMutex;
-    std::mutex _imageInfoMutex;
-
-    std::mutex _sleepMutex;
-    std::condition_variable _sleepCondition;
-
-    bool _needQuit;
+    // loads in progress by full path, and the ones waiting for a decode slot by priority
+    std::unordered_map<std::string, std::shared_ptr<AsyncStruct>> _asyncStructs;
+    std::deque<std::shared_ptr<AsyncStruct>> _asyncPending[ThreadPool::TASK_PRIORITY_COUNT];
+    std::shared_ptr<DecodedQueue> _decodedQueue;
+    ThreadPool::CancellationToken _asyncToken;
+    
+    int _asyncDecodeThreadCount;
+    int _asyncMaxDecodedImages;
+    float _asyncUploadBudget;
+    std::function<void(const AsyncLoadTimings&)> _asyncLoadTimingsCallback;
 
     int _asyncRefCount;
 
     std::unordered_map<std::string, Texture2D*> _textures;
+    
+    // state of an evicted texture, restored when it is loaded again
+    struct EvictedTexture
+    {
+        Texture2D::PixelFormat pixelFormat;
+        bool hasMipmaps;
+        bool antialias;
+    };
+    
+    size_t _memoryBudget;
+    // last frame the textures loaded from files were used, by full path. Only these textures can be evicted
+    std::unordered_map<std::string, unsigned int> _textureLastUsedFrames;
+    std::unordered_map<std::string, EvictedTexture> _evictedTextures;
 };
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
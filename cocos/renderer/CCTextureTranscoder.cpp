@@ -0,0 +1,539 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "renderer/CCTextureTranscoder.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "base/CCConfiguration.h"
+#include "base/etc1.h"
+#include "base/s3tc.h"
+#include "platform/CCFileUtils.h"
+#include "platform/CCImage.h"
+#include "xxhash/xxhash.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // changes the cache keys when the encoders change
+    const unsigned int TRANSCODER_VERSION = 1;
+    
+    const int DDS_HEADER_SIZE = 128;
+    
+    const size_t DEFAULT_MAX_CACHE_SIZE = 64 * 1024 * 1024;
+    
+    // lists the files of the cache directory, one "name size" line per file, least recently used first
+    const char* CACHE_INDEX_FILE = "index.txt";
+    
+    // whether a name is the name of a texture of the cache, see TextureTranscoder::getCacheFileName()
+    bool isCacheFileName(const std::string& name)
+    {
+        if (name.size() != 28 || name.compare(24, 4, ".tex") != 0)
+            return false;
+        for (size_t i = 0; i < 24; ++i)
+        {
+            if (!isxdigit((unsigned char)name[i]))
+                return false;
+        }
+        return true;
+    }
+    
+    void writeUint32(unsigned char* out, uint32_t value)
+    {
+        out[0] = value & 0xff;
+        out[1] = (value >> 8) & 0xff;
+        out[2] = (value >> 16) & 0xff;
+        out[3] = (value >> 24) & 0xff;
+    }
+    
+    void writeDDSHeader(unsigned char* header, int width, int height, const char* fourCC, int dataSize)
+    {
+        memset(header, 0, DDS_HEADER_SIZE);
+        memcpy(header, "DDS ", 4);
+        writeUint32(header + 4, 124);                       //size
+        writeUint32(header + 8, 0x1 | 0x2 | 0x4 | 0x1000 | 0x80000); //caps, height, width, pixel format, linear size
+        writeUint32(header + 12, height);
+        writeUint32(header + 16, width);
+        writeUint32(header + 20, dataSize);                 //linear size
+        writeUint32(header + 28, 1);                        //mipmap count
+        writeUint32(header + 76, 32);                       //pixel format size
+        writeUint32(header + 80, 0x4);                      //fourCC flag
+        memcpy(header + 84, fourCC, 4);
+        writeUint32(header + 108, 0x1000);                  //texture caps
+    }
+    
+    Data readFile(const std::string& path)
+    {
+        Data ret;
+        FILE* fp = fopen(path.c_str(), "rb");
+        if (fp)
+        {
+            fseek(fp, 0, SEEK_END);
+            long size = ftell(fp);
+            fseek(fp, 0, SEEK_SET);
+            if (size > 0)
+            {
+                unsigned char* buffer = (unsigned char*)malloc(size);
+                if (buffer && fread(buffer, 1, size, fp) == (size_t)size)
+                {
+                    ret.fastSet(buffer, size);
+                }
+                else
+                {
+                    free(buffer);
+                }
+            }
+            fclose(fp);
+        }
+        return ret;
+    }
+    
+    // writes a temporary file then renames it, so that a partially written file is never loaded.
+    // an existing file is replaced only if asked to, the rename fails otherwise on some platforms
+    bool writeFile(const std::string& path, const Data& data, bool replace)
+    {
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), ".%x.tmp", (unsigned int)std::hash<std::thread::id>()(std::this_thread::get_id()));
+        std::string tmpPath = path + suffix;
+        FILE* fp = fopen(tmpPath.c_str(), "wb");
+        if (!fp)
+        {
+            return false;
+        }
+        bool ret = fwrite(data.getBytes(), 1, data.getSize(), fp) == (size_t)data.getSize();
+        ret = (fclose(fp) == 0) && ret;
+        if (ret && rename(tmpPath.c_str(), path.c_str()) != 0)
+        {
+            // the textures are named after their content, the rename fails only if the same file is already written
+            ret = replace && remove(path.c_str()) == 0 && rename(tmpPath.c_str(), path.c_str()) == 0;
+        }
+        if (!ret)
+        {
+            remove(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+}
+
+TextureTranscoder* TextureTranscoder::s_sharedTranscoder = nullptr;
+
+TextureTranscoder* TextureTranscoder::getInstance()
+{
+    if (! s_sharedTranscoder)
+    {
+        s_sharedTranscoder = new (std::nothrow) TextureTranscoder();
+    }
+    
+    return s_sharedTranscoder;
+}
+
+void TextureTranscoder::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedTranscoder);
+}
+
+TextureTranscoder::TextureTranscoder()
+: _enabled(false)
+, _cacheSize(0)
+, _maxCacheSize(DEFAULT_MAX_CACHE_SIZE)
+, _cacheUseCount(0)
+, _cacheIndexDirty(false)
+, _supportsETC(false)
+, _supportsS3TC(false)
+{
+}
+
+TextureTranscoder::~TextureTranscoder()
+{
+    // saves the textures used since the last texture was written
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    if (_cacheIndexDirty)
+    {
+        saveCacheIndex();
+    }
+}
+
+void TextureTranscoder::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+    if (enabled)
+    {
+        auto configuration = Configuration::getInstance();
+        _supportsETC = configuration->supportsETC();
+        _supportsS3TC = configuration->supportsS3TC();
+        if (_cachePath.empty())
+        {
+            setCachePath(FileUtils::getInstance()->getWritablePath() + "texture-cache/");
+        }
+    }
+}
+
+void TextureTranscoder::setCachePath(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        if (_cacheIndexDirty)
+        {
+            saveCacheIndex();
+        }
+    }
+    
+    _cachePath = path;
+    if (!_cachePath.empty() && _cachePath.back() != '/')
+    {
+        _cachePath += '/';
+    }
+    FileUtils::getInstance()->createDirectory(_cachePath);
+    loadCacheIndex();
+}
+
+void TextureTranscoder::purgeCache()
+{
+    if (!_cachePath.empty())
+    {
+        // only the textures of the index are removed, the directory may hold other files
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        for (const auto& file : _cacheFiles)
+        {
+            remove((_cachePath + file.first).c_str());
+        }
+        _cacheFiles.clear();
+        _cacheSize = 0;
+        saveCacheIndex();
+    }
+}
+
+void TextureTranscoder::setMaxCacheSize(size_t size)
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    _maxCacheSize = size;
+    trimCache();
+    if (_cacheIndexDirty)
+    {
+        saveCacheIndex();
+    }
+}
+
+size_t TextureTranscoder::getCacheSize() const
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    return _cacheSize;
+}
+
+void TextureTranscoder::loadCacheIndex()
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    _cacheFiles.clear();
+    _cacheSize = 0;
+    _cacheUseCount = 0;
+    _cacheIndexDirty = false;
+    if (_cachePath.empty())
+    {
+        return;
+    }
+    
+    Data index = readFile(_cachePath + CACHE_INDEX_FILE);
+    if (index.isNull())
+    {
+        // a new cache, nothing in the directory is removed
+        saveCacheIndex();
+        return;
+    }
+    
+    std::string content((const char*)index.getBytes(), index.getSize());
+    size_t start = 0;
+    while (start < content.size())
+    {
+        size_t end = content.find('\n', start);
+        if (end == std::string::npos)
+        {
+            end = content.size();
+        }
+        size_t space = content.find(' ', start);
+        // the lines that don't name a texture are skipped, so that no other file can be removed
+        if (space != std::string::npos && space < end && isCacheFileName(content.substr(start, space - start)))
+        {
+            useCacheFile(content.substr(start, space - start), (size_t)strtoul(content.c_str() + space + 1, nullptr, 10));
+        }
+        start = end + 1;
+    }
+    _cacheIndexDirty = false;
+    
+    // the maximum size may be lower than when the textures were written
+    trimCache();
+    if (_cacheIndexDirty)
+    {
+        saveCacheIndex();
+    }
+}
+
+void TextureTranscoder::saveCacheIndex()
+{
+    std::vector<std::pair<unsigned int, const std::string*>> order;
+    order.reserve(_cacheFiles.size());
+    for (const auto& file : _cacheFiles)
+    {
+        order.push_back(std::make_pair(file.second.lastUse, &file.first));
+    }
+    std::sort(order.begin(), order.end());
+    
+    std::string content;
+    char size[32];
+    for (const auto& file : order)
+    {
+        snprintf(size, sizeof(size), " %lu\n", (unsigned long)_cacheFiles[*file.second].size);
+        content += *file.second;
+        content += size;
+    }
+    
+    Data data;
+    data.copy((const unsigned char*)content.c_str(), content.size());
+    if (writeFile(_cachePath + CACHE_INDEX_FILE, data, true))
+    {
+        _cacheIndexDirty = false;
+    }
+    else
+    {
+        CCLOG("cocos2d: TextureTranscoder: can not write the index of %s", _cachePath.c_str());
+    }
+}
+
+void TextureTranscoder::useCacheFile(const std::string& name, size_t size)
+{
+    // a new file has a size of 0
+    auto& file = _cacheFiles[name];
+    _cacheSize = _cacheSize - file.size + size;
+    file.size = size;
+    file.lastUse = ++_cacheUseCount;
+    _cacheIndexDirty = true;
+}
+
+void TextureTranscoder::trimCache()
+{
+    if (_maxCacheSize == 0 || _cacheSize <= _maxCacheSize)
+    {
+        return;
+    }
+    
+    std::vector<std::pair<unsigned int, std::string>> order;
+    order.reserve(_cacheFiles.size());
+    for (const auto& file : _cacheFiles)
+    {
+        order.push_back(std::make_pair(file.second.lastUse, file.first));
+    }
+    std::sort(order.begin(), order.end());
+    
+    for (const auto& file : order)
+    {
+        if (_cacheSize <= _maxCacheSize)
+            break;
+        
+        remove((_cachePath + file.second).c_str());
+        _cacheSize -= _cacheFiles[file.second].size;
+        _cacheFiles.erase(file.second);
+        _cacheIndexDirty = true;
+    }
+}
+
+std::string TextureTranscoder::getCacheFileName(const Data& source) const
+{
+    // the texture of a source depends on the formats supported by the GPU
+    unsigned int seed = TRANSCODER_VERSION << 2 | (_supportsETC ? 1 : 0) << 1 | (_supportsS3TC ? 1 : 0);
+    char name[64];
+    snprintf(name, sizeof(name), "%08x%08x%08x.tex",
+             XXH32(source.getBytes(), (int)source.getSize(), seed),
+             XXH32(source.getBytes(), (int)source.getSize(), seed ^ 0x9e3779b1),
+             (unsigned int)source.getSize());
+    return name;
+}
+
+bool TextureTranscoder::initImage(Image* image, const std::string& fullpath)
+{
+    Data source = FileUtils::getInstance()->getDataFromFile(fullpath);
+    if (source.isNull())
+    {
+        return false;
+    }
+    
+    std::string cacheFileName = getCacheFileName(source);
+    std::string cacheFilePath = _cachePath + cacheFileName;
+    Data texture = readFile(cacheFilePath);
+    if (!texture.isNull())
+    {
+        if (image->initWithImageData(texture))
+        {
+            std::lock_guard<std::mutex> lock(_cacheMutex);
+            useCacheFile(cacheFileName, texture.getSize());
+            return true;
+        }
+        CCLOG("cocos2d: TextureTranscoder: invalid cached texture %s for %s", cacheFilePath.c_str(), fullpath.c_str());
+    }
+    
+    Image* decoded = new (std::nothrow) Image();
+    if (!decoded || !decoded->initWithImageData(source))
+    {
+        CC_SAFE_RELEASE(decoded);
+        return false;
+    }
+    
+    texture = encodeImage(decoded, getFormatForImage(decoded));
+    decoded->release();
+    if (texture.isNull())
+    {
+        // can't be compressed, decodes it again rather than copying the pixels
+        return image->initWithImageData(source);
+    }
+    
+    // the texture is listed before it is written, so that a crash can't leave a file missing from the index
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        useCacheFile(cacheFileName, texture.getSize());
+        trimCache();
+        saveCacheIndex();
+    }
+    if (!writeFile(cacheFilePath, texture, false))
+    {
+        CCLOG("cocos2d: TextureTranscoder: can not write %s", cacheFilePath.c_str());
+    }
+    return image->initWithImageData(texture);
+}
+
+TextureTranscoder::Format TextureTranscoder::getFormatForImage(Image* image) const
+{
+    if (image->getWidth() % 4 != 0 || image->getHeight() % 4 != 0)
+    {
+        return Format::NONE;
+    }
+    
+    bool opaque;
+    switch (image->getRenderFormat())
+    {
+        case Texture2D::PixelFormat::RGB888:
+            opaque = true;
+            break;
+        case Texture2D::PixelFormat::RGBA8888:
+        {
+            // many RGBA images don't use their alpha channel
+            opaque = true;
+            const unsigned char* pixels = image->getData();
+            for (ssize_t i = 3; i < image->getDataLen() && opaque; i += 4)
+            {
+                opaque = pixels[i] == 255;
+            }
+            break;
+        }
+        default:
+            return Format::NONE;
+    }
+    
+    if (opaque && _supportsETC)
+        return Format::ETC1;
+    if (opaque && _supportsS3TC)
+        return Format::DXT1;
+    if (_supportsS3TC)
+        return Format::DXT5;
+    return Format::NONE;
+}
+
+Data TextureTranscoder::encodeImage(Image* image, Format format)
+{
+    Data ret;
+    Texture2D::PixelFormat pixelFormat = image->getRenderFormat();
+    if (format == Format::NONE || image->isCompressed()
+        || (pixelFormat != Texture2D::PixelFormat::RGB888 && pixelFormat != Texture2D::PixelFormat::RGBA8888))
+    {
+        return ret;
+    }
+    
+    int width = image->getWidth();
+    int height = image->getHeight();
+    int bytesPerPixel = pixelFormat == Texture2D::PixelFormat::RGB888 ? 3 : 4;
+    const unsigned char* pixels = image->getData();
+    
+    if (format == Format::ETC1)
+    {
+        // the ETC1 encoder takes RGB888 pixels
+        unsigned char* rgb = nullptr;
+        if (bytesPerPixel == 4)
+        {
+            rgb = (unsigned char*)malloc(width * height * 3);
+            for (int i = 0; i < width * height; ++i)
+            {
+                memcpy(rgb + i * 3, pixels + i * 4, 3);
+            }
+        }
+        
+        ssize_t size = ETC_PKM_HEADER_SIZE + etc1_get_encoded_data_size(width, height);
+        unsigned char* buffer = (unsigned char*)malloc(size);
+        etc1_pkm_format_header(buffer, width, height);
+        if (etc1_encode_image(rgb ? rgb : pixels, width, height, 3, width * 3, buffer + ETC_PKM_HEADER_SIZE) == 0)
+        {
+            ret.fastSet(buffer, size);
+        }
+        else
+        {
+            free(buffer);
+        }
+        free(rgb);
+        return ret;
+    }
+    
+    // the S3TC encoder takes RGBA8888 pixels, premultiplied as the .dds files are loaded
+    bool premultiply = bytesPerPixel == 4 && !image->hasPremultipliedAlpha();
+    unsigned char* rgba = nullptr;
+    if (bytesPerPixel == 3 || premultiply)
+    {
+        rgba = (unsigned char*)malloc(width * height * 4);
+        for (int i = 0; i < width * height; ++i)
+        {
+            const unsigned char* src = pixels + i * bytesPerPixel;
+            unsigned char* dst = rgba + i * 4;
+            unsigned int alpha = bytesPerPixel == 4 ? src[3] : 255;
+            dst[0] = premultiply ? src[0] * alpha / 255 : src[0];
+            dst[1] = premultiply ? src[1] * alpha / 255 : src[1];
+            dst[2] = premultiply ? src[2] * alpha / 255 : src[2];
+            dst[3] = alpha;
+        }
+    }
+    
+    S3TCDecodeFlag flag = format == Format::DXT1 ? S3TCDecodeFlag::DXT1 : S3TCDecodeFlag::DXT5;
+    int dataSize = s3tc_get_encoded_data_size(width, height, flag);
+    unsigned char* buffer = (unsigned char*)malloc(DDS_HEADER_SIZE + dataSize);
+    writeDDSHeader(buffer, width, height, format == Format::DXT1 ? "DXT1" : "DXT5", dataSize);
+    s3tc_encode(rgba ? rgba : pixels, buffer + DDS_HEADER_SIZE, width, height, flag);
+    ret.fastSet(buffer, DDS_HEADER_SIZE + dataSize);
+    free(rgba);
+    return ret;
+}
+
+NS_CC_END
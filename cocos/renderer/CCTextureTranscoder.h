@@ -0,0 +1,163 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CCTEXTURE_TRANSCODER_H__
+#define __CCTEXTURE_TRANSCODER_H__
+
+#include <string>
+#include <mutex>
+#include <unordered_map>
+
+#include "base/CCData.h"
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class Image;
+
+/**
+ * @addtogroup textures
+ * @{
+ */
+
+/** @brief Converts the images loaded by the TextureCache to GPU compressed textures, and caches them on disk.
+ 
+ The first time an image file is loaded, it is decoded and encoded to ETC1 (opaque images) or DXT1/DXT5,
+ depending on the formats supported by the GPU. The result is saved as a .pkm or .dds file in the cache directory,
+ keyed by the hash of the source file, and is loaded directly the next times, without decoding the source.
+ The least recently used files are removed once the cache directory grows above its maximum size.
+ The compressed textures use 4 (ETC1, DXT1) or 8 (DXT5) bits per pixel instead of 32.
+ 
+ Images which can't be compressed are loaded as usual: compressed, 8 or 16 bits per pixel sources,
+ images with alpha when DXT5 isn't supported, and images whose size isn't a multiple of 4.
+ The compression is lossy, it is disabled by default.
+ @since v4.0
+ */
+class CC_DLL TextureTranscoder
+{
+public:
+    /** The compressed formats */
+    enum class Format
+    {
+        NONE,
+        ETC1,
+        DXT1,
+        DXT5,
+    };
+    
+    /** Returns the shared instance of the transcoder */
+    static TextureTranscoder* getInstance();
+    
+    /** Destroys the shared instance */
+    static void destroyInstance();
+    
+    /** Enables/Disables the transcoding of the images loaded by the TextureCache.
+     It must be called from the cocos thread, after the GL context is created, since the formats depend on the GPU.
+     */
+    void setEnabled(bool enabled);
+    /** Returns whether the images loaded by the TextureCache are transcoded */
+    bool isEnabled() const { return _enabled; }
+    
+    /** Sets the directory of the compressed textures, writable path + "texture-cache/" by default.
+     It must be set before loading textures.
+     */
+    void setCachePath(const std::string& path);
+    /** Returns the directory of the compressed textures */
+    const std::string& getCachePath() const { return _cachePath; }
+    
+    /** Removes the compressed textures from the disk */
+    void purgeCache();
+    
+    /** Sets the maximum size, in bytes, of the compressed textures on disk, 64 MB by default. 0 means no limit.
+     The least recently used textures are removed when it is exceeded.
+     */
+    void setMaxCacheSize(size_t size);
+    /** Returns the maximum size, in bytes, of the compressed textures on disk */
+    size_t getMaxCacheSize() const { return _maxCacheSize; }
+    /** Returns the size, in bytes, of the compressed textures on disk */
+    size_t getCacheSize() const;
+    
+    /** Initializes an image with an image file, from its compressed texture.
+     The compressed texture is created and saved in the cache directory if it doesn't exist yet.
+     It can be called from any thread.
+     @param image the image to initialize.
+     @param fullpath the absolute path of the image file.
+     @return true if the image is initialized, compressed or not.
+     */
+    bool initImage(Image* image, const std::string& fullpath);
+    
+    /** Returns the format an image is compressed to, Format::NONE if it isn't compressed */
+    Format getFormatForImage(Image* image) const;
+    
+    /** Encodes an image, e.g. to compress images offline.
+     @param image the image to encode, RGB888 or RGBA8888.
+     @param format the format to encode the image to.
+     @return the content of a .pkm (ETC1) or .dds (DXT1, DXT5) file, or a null Data if the image can't be encoded.
+     */
+    static Data encodeImage(Image* image, Format format);
+    
+protected:
+    TextureTranscoder();
+    ~TextureTranscoder();
+    
+    std::string getCacheFileName(const Data& source) const;
+    
+    // the files of the cache are listed in an index file, in the order they were last used.
+    // only the files named in the index are ever removed, since the directory may be shared with other files
+    void loadCacheIndex();
+    // the methods below must be called with _cacheMutex locked
+    void saveCacheIndex();
+    void useCacheFile(const std::string& name, size_t size);
+    void trimCache();
+    
+    struct CacheFile
+    {
+        size_t size;
+        unsigned int lastUse;
+    };
+    
+    static TextureTranscoder* s_sharedTranscoder;
+    
+    bool _enabled;
+    std::string _cachePath;
+    //the files of the cache directory by name, initImage() uses them from any thread
+    std::unordered_map<std::string, CacheFile> _cacheFiles;
+    size_t _cacheSize;
+    size_t _maxCacheSize;
+    unsigned int _cacheUseCount;
+    //whether _cacheFiles changed since the index was saved
+    bool _cacheIndexDirty;
+    mutable std::mutex _cacheMutex;
+    //the formats supported by the GPU, from the Configuration
+    bool _supportsETC;
+    bool _supportsS3TC;
+};
+
+// end of textures group
+/// @}
+
+NS_CC_END
+
+#endif //__CCTEXTURE_TRANSCODER_H__
@@ -16523,18 +16523,6 @@ color4f
 {
 },
 
-/**
- * @method updateQuadWithParticle
- * @param {cc.sParticle} arg0
- * @param {vec2_object} arg1
- */
-updateQuadWithParticle : function (
-sparticle, 
-vec2 
-)
-{
-},
-
 /**
  * @method getAtlasIndex
  * @return {int}
@@ -16683,16 +16671,6 @@ getRotatePerSecond : function (
     return 0;
 },
 
-/**
- * @method initParticle
- * @param {cc.sParticle} arg0
- */
-initParticle : function (
-sparticle 
-)
-{
-},
-
 /**
  * @method setEmitterMode
  * @param {cc.ParticleSystem::Mode} arg0
@@ -36,11 +36,26 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <unordered_map>
 #include "jni.h"
 #include "jni/JniHelper.h"
 
 USING_NS_CC;
 static int _initialized = 0;
+static int _transactionDepth = 0;
+
+// the items read or written, the reads of cached items don't go to Java
+static std::unordered_map<std::string, std::string> _cache;
+
+static void callStaticVoidMethod(const char* methodName)
+{
+    JniMethodInfo t;
+
+    if (JniHelper::getStaticMethodInfo(t, "org/cocos2dx/lib/Cocos2dxLocalStorage", methodName, "()V")) {
+        t.env->CallStaticVoidMethod(t.classID, t.methodID);
+        t.env->DeleteLocalRef(t.classID);
+    }
+}
 
 static void splitFilename (std::string& str)
 {
@@ -81,6 +96,13 @@ void localStorageFree()
 {
 	if( _initialized ) {
 		
+        // an open transaction is committed before the database is closed
+        if (_transactionDepth > 0)
+        {
+            _transactionDepth = 0;
+            callStaticVoidMethod("commitTransaction");
+        }
+
 		JniMethodInfo t;
         
         if (JniHelper::getStaticMethodInfo(t, "org/cocos2dx/lib/Cocos2dxLocalStorage", "destory", "()V"))
@@ -88,6 +110,8 @@ void localStorageFree()
             t.env->CallStaticVoidMethod(t.classID, t.methodID);
         	t.env->DeleteLocalRef(t.classID); 
         }
+
+        _cache.clear();
         
 		_initialized = 0;
 	}
@@ -97,6 +121,8 @@ void localStorageFree()
 void localStorageSetItem( const std::string& key, const std::string& value)
 {
 	assert( _initialized );
+
+    _cache[key] = value;
 	
     JniMethodInfo t;
 
@@ -114,6 +140,11 @@ void localStorageSetItem( const std::string& key, const std::string& value)
 std::string localStorageGetItem( const std::string& key )
 {
 	assert( _initialized );
+
+    auto iter = _cache.find(key);
+    if (iter != _cache.end())
+        return iter->second;
+
     JniMethodInfo t;
 
     std::string ret;
@@ -124,6 +155,7 @@ std::string localStorageGetItem( const std::string& key )
         t.env->DeleteLocalRef(jret);
         t.env->DeleteLocalRef(jkey);
         t.env->DeleteLocalRef(t.classID);
+        _cache[key] = ret;
     }
     return ret;
 }
@@ -132,6 +164,9 @@ std::string localStorageGetItem( const std::string& key )
 void localStorageRemoveItem( const std::string& key )
 {
 	assert( _initialized );
+
+    _cache[key] = std::string();
+
     JniMethodInfo t;
 
     if (JniHelper::getStaticMethodInfo(t, "org/cocos2dx/lib/Cocos2dxLocalStorage", "removeItem", "(Ljava/lang/String;)V")) {
@@ -142,5 +177,39 @@ void localStorageRemoveItem( const std::string& key )
     }
 
 }
+void localStorageSetItems( const std::vector<std::pair<std::string, std::string>>& items )
+{
+	assert( _initialized );
+
+    localStorageBeginTransaction();
+    for (const auto& item : items)
+        localStorageSetItem(item.first, item.second);
+    localStorageCommitTransaction();
+}
+
+void localStorageBeginTransaction()
+{
+	assert( _initialized );
+
+    if (_transactionDepth++ == 0)
+        callStaticVoidMethod("beginTransaction");
+}
+
+void localStorageCommitTransaction()
+{
+	assert( _initialized && _transactionDepth > 0 );
+
+    if (--_transactionDepth == 0)
+        callStaticVoidMethod("commitTransaction");
+}
+
+void localStorageSetAsyncWriteEnabled( bool enabled )
+{
+    // the items are written by the Java SQLiteDatabase on the calling thread
+}
+
+void localStorageFlush()
+{
+}
 
 #endif // #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
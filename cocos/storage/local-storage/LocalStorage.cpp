@@ -35,18 +35,47 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
 #include "sqlite3/sqlite3.h"
 #else
 #include <sqlite3.h>
 #endif
 
+// an item to set, or to remove
+struct WriteOp
+{
+	std::string key;
+	std::string value;
+	bool remove;
+};
+typedef std::vector<WriteOp> WriteBatch;
+
 static int _initialized = 0;
 static sqlite3 *_db;
-static sqlite3_stmt *_stmt_select;
 static sqlite3_stmt *_stmt_remove;
 static sqlite3_stmt *_stmt_update;
 
+// all the items, the reads never go to the database
+static std::unordered_map<std::string, std::string> _cache;
+
+// the items set or removed in the current transaction
+static int _transactionDepth = 0;
+static WriteBatch _transaction;
+
+// the background writer commits all the queued items in one transaction
+static bool _asyncWriteEnabled = true;
+static std::thread _writer;
+static std::mutex _writerMutex;
+static std::condition_variable _writerCondition;
+static std::condition_variable _flushCondition;
+static WriteBatch _queuedOps;
+static bool _writing = false;
+static bool _stopWriter = false;
+
 
 static void localStorageCreateTable()
 {
@@ -60,6 +89,99 @@ static void localStorageCreateTable()
 		printf("Error in CREATE TABLE\n");
 }
 
+static void localStorageLoadItems()
+{
+	const char *sql_select = "SELECT key,value FROM data;";
+	sqlite3_stmt *stmt;
+	int ok = sqlite3_prepare_v2(_db, sql_select, -1, &stmt, nullptr);
+	while( ok == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW ) {
+		const unsigned char *key = sqlite3_column_text(stmt, 0);
+		const unsigned char *value = sqlite3_column_text(stmt, 1);
+		if (key)
+			_cache[(const char*)key] = value ? (const char*)value : "";
+	}
+	ok |= sqlite3_finalize(stmt);
+
+	if( ok != SQLITE_OK )
+		printf("Error loading localStorage items\n");
+}
+
+// writes the items, in a single transaction if there are more than one
+static void localStorageWrite( const WriteBatch& ops )
+{
+	bool transaction = ops.size() > 1;
+	if (transaction)
+		sqlite3_exec(_db, "BEGIN;", nullptr, nullptr, nullptr);
+
+	for (const auto& op : ops) {
+		int ok;
+		if (op.remove) {
+			ok = sqlite3_bind_text(_stmt_remove, 1, op.key.c_str(), -1, SQLITE_STATIC);
+			ok |= sqlite3_step(_stmt_remove);
+			ok |= sqlite3_reset(_stmt_remove);
+		} else {
+			ok = sqlite3_bind_text(_stmt_update, 1, op.key.c_str(), -1, SQLITE_STATIC);
+			ok |= sqlite3_bind_text(_stmt_update, 2, op.value.c_str(), -1, SQLITE_STATIC);
+			ok |= sqlite3_step(_stmt_update);
+			ok |= sqlite3_reset(_stmt_update);
+		}
+
+		if( ok != SQLITE_OK && ok != SQLITE_DONE)
+			printf("Error in localStorage.%s()\n", op.remove ? "removeItem" : "setItem");
+	}
+
+	if (transaction && sqlite3_exec(_db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+		printf("Error committing localStorage items\n");
+}
+
+static void localStorageWriterLoop()
+{
+	std::unique_lock<std::mutex> lock(_writerMutex);
+	while (true) {
+		_writerCondition.wait(lock, []{ return _stopWriter || !_queuedOps.empty(); });
+		if (_queuedOps.empty())
+			break;
+
+		WriteBatch ops;
+		ops.swap(_queuedOps);
+		_writing = true;
+		lock.unlock();
+
+		localStorageWrite(ops);
+
+		lock.lock();
+		_writing = false;
+		_flushCondition.notify_all();
+	}
+}
+
+// writes the items on the writer thread, or on the calling thread when async writes are disabled
+static void localStorageSubmit( WriteBatch& ops )
+{
+	if (_asyncWriteEnabled) {
+		{
+			std::lock_guard<std::mutex> lock(_writerMutex);
+			if (_queuedOps.empty())
+				_queuedOps.swap(ops);
+			else
+				_queuedOps.insert(_queuedOps.end(), ops.begin(), ops.end());
+		}
+		_writerCondition.notify_one();
+	} else {
+		// keeps the order with the items queued before
+		localStorageFlush();
+		localStorageWrite(ops);
+	}
+	ops.clear();
+}
+
+static void localStorageAddOp( const std::string& key, const std::string& value, bool remove )
+{
+	_transaction.push_back({key, value, remove});
+	if (_transactionDepth == 0)
+		localStorageSubmit(_transaction);
+}
+
 void localStorageInit( const std::string& fullpath/* = "" */)
 {
 	if( ! _initialized ) {
@@ -68,14 +190,15 @@ void localStorageInit( const std::string& fullpath/* = "" */)
 		
 		if (fullpath.empty())
 			ret = sqlite3_open(":memory:",&_db);
-		else
+		else {
 			ret = sqlite3_open(fullpath.c_str(), &_db);
 
-		localStorageCreateTable();
+			// the commits only append to the log, and are synced at checkpoints
+			sqlite3_exec(_db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+			sqlite3_exec(_db, "PRAGMA synchronous=NORMAL;", nullptr, nullptr, nullptr);
+		}
 
-		// SELECT
-		const char *sql_select = "SELECT value FROM data WHERE key=?;";
-		ret |= sqlite3_prepare_v2(_db, sql_select, -1, &_stmt_select, nullptr);
+		localStorageCreateTable();
 
 		// REPLACE
 		const char *sql_update = "REPLACE INTO data (key, value) VALUES (?,?);";
@@ -89,6 +212,11 @@ void localStorageInit( const std::string& fullpath/* = "" */)
 			printf("Error initializing DB\n");
 			// report error
 		}
+
+		localStorageLoadItems();
+
+		_stopWriter = false;
+		_writer = std::thread(localStorageWriterLoop);
 		
 		_initialized = 1;
 	}
@@ -97,11 +225,24 @@ void localStorageInit( const std::string& fullpath/* = "" */)
 void localStorageFree()
 {
 	if( _initialized ) {
-		sqlite3_finalize(_stmt_select);
+		// an open transaction is committed
+		_transactionDepth = 0;
+		if (!_transaction.empty())
+			localStorageSubmit(_transaction);
+
+		{
+			std::lock_guard<std::mutex> lock(_writerMutex);
+			_stopWriter = true;
+		}
+		_writerCondition.notify_one();
+		_writer.join();
+
 		sqlite3_finalize(_stmt_remove);
 		sqlite3_finalize(_stmt_update);		
 
 		sqlite3_close(_db);
+
+		_cache.clear();
 		
 		_initialized = 0;
 	}
@@ -111,16 +252,9 @@ void localStorageFree()
 void localStorageSetItem( const std::string& key, const std::string& value)
 {
 	assert( _initialized );
-	
-	int ok = sqlite3_bind_text(_stmt_update, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-	ok |= sqlite3_bind_text(_stmt_update, 2, value.c_str(), -1, SQLITE_TRANSIENT);
 
-	ok |= sqlite3_step(_stmt_update);
-	
-	ok |= sqlite3_reset(_stmt_update);
-	
-	if( ok != SQLITE_OK && ok != SQLITE_DONE)
-		printf("Error in localStorage.setItem()\n");
+	_cache[key] = value;
+	localStorageAddOp(key, value, false);
 }
 
 /** gets an item from the LS */
@@ -128,34 +262,55 @@ std::string localStorageGetItem( const std::string& key )
 {
 	assert( _initialized );
 
-	std::string ret;
-	int ok = sqlite3_reset(_stmt_select);
+	auto iter = _cache.find(key);
+	return iter != _cache.end() ? iter->second : std::string();
+}
 
-	ok |= sqlite3_bind_text(_stmt_select, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-	ok |= sqlite3_step(_stmt_select);
-	const unsigned char *text = sqlite3_column_text(_stmt_select, 0);
-	if (text)
-		ret = (const char*)text;
+/** removes an item from the LS */
+void localStorageRemoveItem( const std::string& key )
+{
+	assert( _initialized );
+
+	_cache.erase(key);
+	localStorageAddOp(key, std::string(), true);
+}
 
-	if( ok != SQLITE_OK && ok != SQLITE_DONE && ok != SQLITE_ROW)
-		printf("Error in localStorage.getItem()\n");
+void localStorageSetItems( const std::vector<std::pair<std::string, std::string>>& items )
+{
+	assert( _initialized );
 
-	return ret;
+	localStorageBeginTransaction();
+	for (const auto& item : items)
+		localStorageSetItem(item.first, item.second);
+	localStorageCommitTransaction();
 }
 
-/** removes an item from the LS */
-void localStorageRemoveItem( const std::string& key )
+void localStorageBeginTransaction()
 {
 	assert( _initialized );
 
-	int ok = sqlite3_bind_text(_stmt_remove, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-	
-	ok |= sqlite3_step(_stmt_remove);
-	
-	ok |= sqlite3_reset(_stmt_remove);
+	++_transactionDepth;
+}
 
-	if( ok != SQLITE_OK && ok != SQLITE_DONE)
-		printf("Error in localStorage.removeItem()\n");
+void localStorageCommitTransaction()
+{
+	assert( _initialized && _transactionDepth > 0 );
+
+	if (--_transactionDepth == 0 && !_transaction.empty())
+		localStorageSubmit(_transaction);
+}
+
+void localStorageSetAsyncWriteEnabled( bool enabled )
+{
+	_asyncWriteEnabled = enabled;
+}
+
+void localStorageFlush()
+{
+	if( _initialized ) {
+		std::unique_lock<std::mutex> lock(_writerMutex);
+		_flushCondition.wait(lock, []{ return _queuedOps.empty() && !_writing; });
+	}
 }
 
 #endif // #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #define __JSB_LOCALSTORAGE_H
 
 #include <string>
+#include <vector>
+#include <utility>
 #include "CCPlatformMacros.h"
 
 /** Initializes the database. If path is null, it will create an in-memory DB */
@@ -48,4 +50,21 @@ std::string CC_DLL localStorageGetItem( const std::string& key );
 /** removes an item from the LS */
 void CC_DLL localStorageRemoveItem( const std::string& key );
 
+/** sets several items in the LS, they are written in a single transaction */
+void CC_DLL localStorageSetItems( const std::vector<std::pair<std::string, std::string>>& items );
+
+/** starts a transaction: the items set or removed until localStorageCommitTransaction() are written together.
+ Transactions can be nested, the outermost commit writes the items. */
+void CC_DLL localStorageBeginTransaction();
+
+/** commits the transaction started by localStorageBeginTransaction() */
+void CC_DLL localStorageCommitTransaction();
+
+/** enables/disables writing the items on a background thread. Enabled by default.
+ When it is disabled, every item set outside of a transaction is written on the calling thread. */
+void CC_DLL localStorageSetAsyncWriteEnabled( bool enabled );
+
+/** blocks until the items set or removed are written */
+void CC_DLL localStorageFlush();
+
 #endif // __JSB_LOCALSTORAGE_H
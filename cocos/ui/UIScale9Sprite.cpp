@@ -1069,6 +1069,7 @@ namespace ui {
         
         //we must invalide the transform when toggling scale9enabled
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markParentSubtreeBoundsDirty();
         
         if (_scale9Enabled)
         {
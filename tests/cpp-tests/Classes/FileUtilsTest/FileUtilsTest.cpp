@@ -3,11 +3,14 @@
 static std::function<Layer*()> createFunctions[] = {
     CL(TestResolutionDirectories),
     CL(TestSearchPath),
+    CL(TestSearchPack),
+    CL(TestSearchPackConcurrentRead),
     CL(TestFilenameLookup),
     CL(TestIsFileExist),
     CL(TestFileFuncs),
     CL(TestDirectoryFuncs),
     CL(TextWritePlist),
+    CL(TestValueMapAsync),
 };
 
 static int sceneIdx=-1;
@@ -227,6 +230,127 @@ std::string TestSearchPath::subtitle() const
     return "See the console";
 }
 
+// TestSearchPack
+
+void TestSearchPack::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto s = Director::getInstance()->getWinSize();
+    auto sharedFileUtils = FileUtils::getInstance();
+
+    // Misc/searchpack.ccpk was built by tools/file-pack/build_pack.py from a directory containing
+    // file1.txt (compressed), resources-ipad/file2.txt and Images/grossini_packed.png (stored)
+    if (!sharedFileUtils->addSearchPack("Misc/searchpack.ccpk", true))
+    {
+        log("Failed to mount Misc/searchpack.ccpk");
+        return;
+    }
+
+    _defaultResolutionsOrderArray = sharedFileUtils->getSearchResolutionsOrder();
+    std::vector<std::string> resolutionsOrder = _defaultResolutionsOrderArray;
+    resolutionsOrder.insert(resolutionsOrder.begin(), "resources-ipad");
+    sharedFileUtils->setSearchResolutionsOrder(resolutionsOrder);
+
+    for( int i=1; i<3; i++) {
+        auto filename = StringUtils::format("file%d.txt", i);
+        std::string fullPath = sharedFileUtils->fullPathForFilename(filename);
+        log("%s -> %s, %ld bytes", filename.c_str(), fullPath.c_str(), sharedFileUtils->getFileSize(filename));
+        log("content: %s", sharedFileUtils->getStringFromFile(filename).c_str());
+    }
+
+    auto sprite = Sprite::create("Images/grossini_packed.png");
+    sprite->setPosition(s.width/2, s.height/2);
+    this->addChild(sprite);
+
+    bool isExist = sharedFileUtils->isFileExist("Images/grossini_packed.png");
+    auto label = Label::createWithSystemFont(isExist ? "Images/grossini_packed.png exists in the pack" : "Images/grossini_packed.png doesn't exist", "", 20);
+    label->setPosition(s.width/2, s.height/4);
+    this->addChild(label);
+}
+
+void TestSearchPack::onExit()
+{
+    auto sharedFileUtils = FileUtils::getInstance();
+
+    sharedFileUtils->removeSearchPack("Misc/searchpack.ccpk");
+    if (!_defaultResolutionsOrderArray.empty())
+    {
+        sharedFileUtils->setSearchResolutionsOrder(_defaultResolutionsOrderArray);
+    }
+    FileUtilsDemo::onExit();
+}
+
+std::string TestSearchPack::title() const
+{
+    return "FileUtils: search pack";
+}
+
+std::string TestSearchPack::subtitle() const
+{
+    return "Sprite and text files read from Misc/searchpack.ccpk, see the console";
+}
+
+// TestSearchPackConcurrentRead
+
+void TestSearchPackConcurrentRead::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto s = Director::getInstance()->getWinSize();
+
+    std::string message;
+    auto pack = FilePack::create(FileUtils::getInstance()->fullPathForFilename("Misc/searchpack.ccpk"));
+    if (pack == nullptr)
+    {
+        message = "Failed to open Misc/searchpack.ccpk";
+    }
+    else
+    {
+        // two entries stored uncompressed, sliced from the same pack by two threads at the same time
+        const std::string names[] = { "resources-ipad/file2.txt", "Images/grossini_packed.png" };
+        const int readCount = 1000;
+        std::atomic<int> failures(0);
+
+        std::vector<std::thread> threads;
+        for (const auto& name : names)
+        {
+            threads.push_back(std::thread([pack, name, readCount, &failures]{
+                ssize_t size = pack->getEntrySize(name);
+                for (int i = 0; i < readCount; ++i)
+                {
+                    Data data = pack->getEntryData(name);
+                    if (data.isNull() || data.getSize() != size)
+                    {
+                        ++failures;
+                    }
+                }
+            }));
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        delete pack;
+
+        message = failures == 0 ? "Both entries were read concurrently"
+                                : StringUtils::format("%d reads failed", failures.load());
+    }
+
+    log("%s", message.c_str());
+    auto label = Label::createWithSystemFont(message, "", 20);
+    label->setPosition(s.width/2, s.height/2);
+    this->addChild(label);
+}
+
+std::string TestSearchPackConcurrentRead::title() const
+{
+    return "FileUtils: concurrent pack reads";
+}
+
+std::string TestSearchPackConcurrentRead::subtitle() const
+{
+    return "Two threads read two entries of Misc/searchpack.ccpk";
+}
+
 // TestFilenameLookup
 
 void TestFilenameLookup::onEnter()
@@ -550,3 +674,40 @@ std::string TextWritePlist::subtitle() const
     std::string writablePath = FileUtils::getInstance()->getWritablePath().c_str();
     return ("See plist file at your writablePath");
 }
+
+// TestValueMapAsync
+
+void TestValueMapAsync::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto s = Director::getInstance()->getWinSize();
+
+    auto label = Label::createWithTTF("Loading animations/animations.plist...", "fonts/Thonburi.ttf", 18);
+    label->setPosition(s.width/2, s.height/3);
+    this->addChild(label);
+
+    // keeps the label alive if the test is left before the callback
+    label->retain();
+    FileUtils::getInstance()->getValueMapFromFileAsync("animations/animations.plist", [label](const ValueMap& dict) {
+        auto iter = dict.find("animations");
+        if (iter != dict.end() && iter->second.getType() == Value::Type::MAP)
+        {
+            label->setString(StringUtils::format("%d animations loaded on a worker thread", (int)iter->second.asValueMap().size()));
+        }
+        else
+        {
+            label->setString("Failed to load animations/animations.plist");
+        }
+        label->release();
+    });
+}
+
+std::string TestValueMapAsync::title() const
+{
+    return "FileUtils: getValueMapFromFileAsync";
+}
+
+std::string TestValueMapAsync::subtitle() const
+{
+    return "The plist is parsed on a worker thread";
+}
@@ -51,6 +51,29 @@ private:
     std::vector<std::string> _defaultResolutionsOrderArray;
 };
 
+class TestSearchPack : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestSearchPack);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    std::vector<std::string> _defaultResolutionsOrderArray;
+};
+
+class TestSearchPackConcurrentRead : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestSearchPackConcurrentRead);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 class TestFilenameLookup : public FileUtilsDemo
 {
 public:
@@ -103,4 +126,14 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class TestValueMapAsync : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestValueMapAsync);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif /* __FILEUTILSTEST_H__ */
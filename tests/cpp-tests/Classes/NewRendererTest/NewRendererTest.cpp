@@ -40,6 +40,7 @@ static std::function<Layer*()> createFunctions[] =
     CL(NewDrawNodeTest),
     CL(NewCullingTest),
     CL(VBOFullTest),
+    CL(BatchReorderTest),
     CL(CaptureScreenTest)
 };
 
@@ -564,6 +565,62 @@ std::string VBOFullTest::subtitle() const
     return "VBO full Test, everthing should render normally";
 }
 
+BatchReorderTest::BatchReorderTest()
+{
+    Size s = Director::getInstance()->getWinSize();
+    
+    // A grid of sprites alternating between two textures, they don't overlap so they can be regrouped
+    const int columns = 12;
+    const int rows = 6;
+    for (int i = 0; i < columns * rows; ++i)
+    {
+        auto sprite = Sprite::create((i % 2) ? "Images/grossinis_sister1.png" : "Images/grossini_dance_01.png");
+        sprite->setScale(0.3f);
+        sprite->setPosition(Vec2(s.width * (i % columns + 0.5f) / columns, s.height * 0.2f + s.height * 0.5f * (i / columns) / rows));
+        addChild(sprite);
+    }
+    
+    // Overlapping sprites must keep their order: grossini stays on top of its sister
+    auto sister = Sprite::create("Images/grossinis_sister1.png");
+    sister->setPosition(Vec2(s.width / 2 - 10, s.height * 0.8f));
+    addChild(sister);
+    auto grossini = Sprite::create("Images/grossini.png");
+    grossini->setPosition(Vec2(s.width / 2 + 10, s.height * 0.8f));
+    addChild(grossini);
+    
+    Director::getInstance()->getRenderer()->setBatchReorderEnabled(true);
+    
+    MenuItemFont::setFontSize(20);
+    auto toggle = MenuItemToggle::createWithCallback(CC_CALLBACK_1(BatchReorderTest::onToggleReorder, this),
+                                                     MenuItemFont::create("Batch Reorder: On"),
+                                                     MenuItemFont::create("Batch Reorder: Off"),
+                                                     nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width / 2, s.height * 0.1f));
+    addChild(menu);
+}
+
+BatchReorderTest::~BatchReorderTest()
+{
+    Director::getInstance()->getRenderer()->setBatchReorderEnabled(false);
+}
+
+void BatchReorderTest::onToggleReorder(Ref* sender)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setBatchReorderEnabled(!renderer->isBatchReorderEnabled());
+}
+
+std::string BatchReorderTest::title() const
+{
+    return "New Renderer";
+}
+
+std::string BatchReorderTest::subtitle() const
+{
+    return "Batch reorder, GL calls should drop when On,\nthe top sprites keep their order";
+}
+
 CaptureScreenTest::CaptureScreenTest()
 {
     Size s = Director::getInstance()->getWinSize();
@@ -146,6 +146,20 @@ protected:
     virtual ~VBOFullTest();
 };
 
+class BatchReorderTest : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(BatchReorderTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    
+protected:
+    BatchReorderTest();
+    virtual ~BatchReorderTest();
+    
+    void onToggleReorder(Ref* sender);
+};
+
 class CaptureScreenTest : public MultiSceneTest
 {
     static const int childTag = 119;
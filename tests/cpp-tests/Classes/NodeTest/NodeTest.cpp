@@ -76,6 +76,8 @@ static std::function<Layer*()> createFunctions[] =
     CL(NodeNormalizedPositionTest2),
     CL(NodeNormalizedPositionBugTest),
     CL(NodeNameTest),
+    CL(NodeTransformHierarchyTest),
+    CL(NodeSubtreeCullingTest),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -1510,6 +1512,143 @@ void NodeNameTest::test(float dt)
     
 }
 
+//------------------------------------------------------------------
+//
+// NodeTransformHierarchyTest
+//
+//------------------------------------------------------------------
+NodeTransformHierarchyTest::NodeTransformHierarchyTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    
+    // two arms of nested rotating sprites, every level depends on the transform of its parent
+    for (int arm = 0; arm < 2; ++arm)
+    {
+        Node* parent = this;
+        for (int i = 0; i < 8; ++i)
+        {
+            auto sprite = Sprite::create("Images/grossini.png");
+            sprite->setScale(i == 0 ? 0.5f : 0.9f);
+            if (i == 0)
+                sprite->setPosition(Vec2(s.width * (arm + 1) / 3, s.height / 2));
+            else
+                sprite->setPosition(Vec2(parent->getContentSize().width, parent->getContentSize().height));
+            sprite->runAction(RepeatForever::create(RotateBy::create(4, arm ? -20 : 20)));
+            parent->addChild(sprite);
+            parent = sprite;
+        }
+        
+        // normalized positions are resolved during the transform update too
+        auto child = Sprite::create("Images/grossinis_sister1.png");
+        child->setNormalizedPosition(Vec2(0.5f, 0.5f));
+        child->runAction(RepeatForever::create(Sequence::create(ScaleTo::create(1, 0.5f), ScaleTo::create(1, 1.0f), nullptr)));
+        parent->addChild(child);
+    }
+    
+    MenuItemFont::setFontSize(20);
+    auto toggle = MenuItemToggle::createWithCallback(CC_CALLBACK_1(NodeTransformHierarchyTest::onToggleHierarchy, this),
+                                                     MenuItemFont::create("Transform Hierarchy: On"),
+                                                     MenuItemFont::create("Transform Hierarchy: Off"),
+                                                     nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width / 2, s.height / 5));
+    addChild(menu);
+}
+
+void NodeTransformHierarchyTest::onEnter()
+{
+    TestCocosNodeDemo::onEnter();
+    getScene()->setTransformHierarchyEnabled(true);
+}
+
+void NodeTransformHierarchyTest::onExit()
+{
+    getScene()->setTransformHierarchyEnabled(false);
+    TestCocosNodeDemo::onExit();
+}
+
+void NodeTransformHierarchyTest::onToggleHierarchy(Ref* sender)
+{
+    auto scene = getScene();
+    scene->setTransformHierarchyEnabled(!scene->isTransformHierarchyEnabled());
+}
+
+std::string NodeTransformHierarchyTest::title() const
+{
+    return "Transform Hierarchy";
+}
+
+std::string NodeTransformHierarchyTest::subtitle() const
+{
+    return "Sprites should move the same way with the hierarchy On or Off";
+}
+
+//------------------------------------------------------------------
+//
+// NodeSubtreeCullingTest
+//
+//------------------------------------------------------------------
+NodeSubtreeCullingTest::NodeSubtreeCullingTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    
+    // a map much larger than the screen, split in chunks that are culled as a whole
+    const int chunkCount = 12;
+    const int tilesPerChunk = 6;
+    const float tileSize = 40;
+    
+    _map = Node::create();
+    for (int y = 0; y < chunkCount; ++y)
+    {
+        for (int x = 0; x < chunkCount; ++x)
+        {
+            auto chunk = Node::create();
+            chunk->setPosition(Vec2(x * tilesPerChunk * tileSize, y * tilesPerChunk * tileSize));
+            chunk->setSubtreeCullingEnabled(true);
+            for (int i = 0; i < tilesPerChunk * tilesPerChunk; ++i)
+            {
+                auto tile = Sprite::create("Images/grossini_dance_atlas.png", Rect(0, 0, 85, 121));
+                tile->setScale(tileSize / 121);
+                tile->setAnchorPoint(Vec2::ZERO);
+                tile->setPosition(Vec2((i % tilesPerChunk) * tileSize, (i / tilesPerChunk) * tileSize));
+                chunk->addChild(tile);
+            }
+            _chunks.pushBack(chunk);
+            _map->addChild(chunk);
+        }
+    }
+    addChild(_map, -1);
+    
+    float mapSize = chunkCount * tilesPerChunk * tileSize;
+    auto scroll = MoveBy::create(8, Vec2(s.width - mapSize, s.height - mapSize));
+    _map->runAction(RepeatForever::create(Sequence::create(scroll, scroll->reverse(), nullptr)));
+    
+    MenuItemFont::setFontSize(20);
+    auto toggle = MenuItemToggle::createWithCallback(CC_CALLBACK_1(NodeSubtreeCullingTest::onToggleCulling, this),
+                                                     MenuItemFont::create("Subtree Culling: On"),
+                                                     MenuItemFont::create("Subtree Culling: Off"),
+                                                     nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width / 2, s.height / 5));
+    addChild(menu);
+}
+
+void NodeSubtreeCullingTest::onToggleCulling(Ref* sender)
+{
+    for (const auto& chunk : _chunks)
+        chunk->setSubtreeCullingEnabled(!chunk->isSubtreeCullingEnabled());
+}
+
+std::string NodeSubtreeCullingTest::title() const
+{
+    return "Subtree Culling";
+}
+
+std::string NodeSubtreeCullingTest::subtitle() const
+{
+    return "The map should look the same with culling On or Off.\nOnly the visible chunks are visited when On";
+}
+
 ///
 /// main
 ///
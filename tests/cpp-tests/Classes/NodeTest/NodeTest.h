@@ -335,6 +335,38 @@ public:
     void test(float dt);
 };
 
+class NodeTransformHierarchyTest : public TestCocosNodeDemo
+{
+public:
+    CREATE_FUNC(NodeTransformHierarchyTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    
+protected:
+    NodeTransformHierarchyTest();
+    
+    void onToggleHierarchy(Ref* sender);
+};
+
+class NodeSubtreeCullingTest : public TestCocosNodeDemo
+{
+public:
+    CREATE_FUNC(NodeSubtreeCullingTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    
+protected:
+    NodeSubtreeCullingTest();
+    
+    void onToggleCulling(Ref* sender);
+    
+    Node* _map;
+    Vector<Node*> _chunks;
+};
+
 
 // main
 class CocosNodeTestScene : public TestScene
@@ -1013,13 +1013,14 @@ Layer* createParticleLayer(int nIndex)
         case 47: return new ParticleAutoBatching();
         case 48: return new ParticleVisibleTest();
         case 49: return new ParticleResetTotalParticles();
+        case 50: return new ParticlePrewarm();
         default:
             break;
     }
 
     return nullptr;
 }
-#define MAX_LAYER    50
+#define MAX_LAYER    51
 
 
 Layer* nextParticleAction()
@@ -2052,6 +2053,66 @@ std::string ParticleResetTotalParticles::subtitle() const
     return "it should work as well";
 }
 
+//
+// ParticlePrewarm
+//
+void ParticlePrewarm::onEnter()
+{
+    ParticleDemo::onEnter();
+    
+    _color->setColor(Color3B::BLACK);
+    removeChild(_background, true);
+    _background = nullptr;
+    
+    Size s = Director::getInstance()->getWinSize();
+    auto texture = Director::getInstance()->getTextureCache()->addImage(s_fire);
+    
+    // left: started now, right: prewarmed
+    Vector<ParticleSystem*> prewarmed;
+    for (int i = 0; i < 2; ++i)
+    {
+        auto smoke = ParticleSmoke::create();
+        smoke->setTexture(texture);
+        smoke->setPosition(Vec2(s.width * (i + 1) / 3, 100));
+        this->addChild(smoke, 10);
+        
+        auto rain = ParticleRain::create();
+        rain->setTexture(texture);
+        rain->setPosition(Vec2(s.width * (i + 1) / 3, s.height));
+        rain->setPosVar(Vec2(s.width / 6, 0));
+        this->addChild(rain, 10);
+        
+        if (i == 1)
+        {
+            smoke->prewarm(5);
+            rain->prewarm(5);
+            prewarmed.pushBack(smoke);
+            prewarmed.pushBack(rain);
+        }
+    }
+    
+    auto item = MenuItemFont::create("prewarm again", [prewarmed](Ref*)->void
+                                     {
+                                         for (auto system : prewarmed)
+                                         {
+                                             system->prewarm(5);
+                                         }
+                                     });
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(Vec2(s.width * 2 / 3, s.height / 2));
+    this->addChild(menu, 20);
+}
+
+std::string ParticlePrewarm::title() const
+{
+    return "Prewarm";
+}
+
+std::string ParticlePrewarm::subtitle() const
+{
+    return "Right systems are prewarmed by 5 seconds";
+}
+
 //
 // main
 //
@@ -336,4 +336,12 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class ParticlePrewarm : public ParticleDemo
+{
+public:
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif
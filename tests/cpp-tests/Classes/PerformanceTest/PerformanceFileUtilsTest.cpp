@@ -0,0 +1,175 @@
+#include "PerformanceFileUtilsTest.h"
+
+#include <chrono>
+
+static const int TEST_COUNT = 2;
+static int s_nTouchCurCase = 0;
+
+static const int NAME_COUNT = 10000;
+static const int s_foundPercents[TEST_COUNT] = { 0, 50 };
+
+// files found in one of the search paths set by the test
+static const char* s_existingNames[] = {
+    "file1.txt",
+    "grossini.png",
+    "arial.ttf",
+    "grossini_dance_01.png",
+    "Images/grossini.png",
+};
+
+static PerformanceFileUtilsLayer* createLayer()
+{
+    s_nTouchCurCase = s_nTouchCurCase % TEST_COUNT;
+    
+    auto result = new (std::nothrow) PerformanceFileUtilsLayer(true, TEST_COUNT, s_nTouchCurCase);
+    if(result)
+    {
+        result->autorelease();
+    }
+    return result;
+}
+
+PerformanceFileUtilsLayer::PerformanceFileUtilsLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+, _foundPercent(s_foundPercents[nCurCase % TEST_COUNT])
+, _defaultPopupNotify(true)
+, _resultLabel(nullptr)
+{
+    
+}
+
+std::string PerformanceFileUtilsLayer::subtitle() const
+{
+    char str[96] = {0};
+    sprintf(str, "fullPathForFilename, %d names (%d%% found), 5 search paths", NAME_COUNT, _foundPercent);
+    return str;
+}
+
+void PerformanceFileUtilsLayer::onEnter()
+{
+    PerformBasicLayer::onEnter();
+    
+    auto s = Director::getInstance()->getWinSize();
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+    
+    // Subtitle
+    auto l = Label::createWithTTF(subtitle().c_str(), "fonts/Thonburi.ttf", 16);
+    addChild(l, 1);
+    l->setPosition(Vec2(s.width/2, s.height-80));
+    
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+    
+    auto fileUtils = FileUtils::getInstance();
+    _defaultSearchPaths = fileUtils->getSearchPaths();
+    _defaultPopupNotify = fileUtils->isPopupNotify();
+    // the missing files would be logged
+    fileUtils->setPopupNotify(false);
+    
+    // 4 search paths and the default root
+    std::vector<std::string> searchPaths = _defaultSearchPaths;
+    searchPaths.insert(searchPaths.begin(), "Misc/searchpath1");
+    searchPaths.insert(searchPaths.begin() + 1, "Misc/searchpath2");
+    searchPaths.insert(searchPaths.begin() + 2, "Images");
+    searchPaths.insert(searchPaths.begin() + 3, "fonts");
+    fileUtils->setSearchPaths(searchPaths);
+    
+    int existingCount = sizeof(s_existingNames) / sizeof(s_existingNames[0]);
+    _names.reserve(NAME_COUNT);
+    for (int i = 0; i < NAME_COUNT; ++i)
+    {
+        if (i % 100 < _foundPercent)
+            _names.push_back(s_existingNames[i % existingCount]);
+        else
+            _names.push_back(StringUtils::format("missing/file_%d.png", i));
+    }
+    
+    getScheduler()->schedule(schedule_selector(PerformanceFileUtilsLayer::doPerformanceTest), this, 1.0f, false);
+}
+
+void PerformanceFileUtilsLayer::onExit()
+{
+    auto fileUtils = FileUtils::getInstance();
+    fileUtils->setDirectoryIndexEnabled(false);
+    fileUtils->setSearchPaths(_defaultSearchPaths);
+    fileUtils->setPopupNotify(_defaultPopupNotify);
+    
+    PerformBasicLayer::onExit();
+}
+
+void PerformanceFileUtilsLayer::restartCallback(Ref* sender)
+{
+    runFileUtilsPerformanceTest();
+}
+
+void PerformanceFileUtilsLayer::nextCallback(Ref* sender)
+{
+    ++s_nTouchCurCase;
+    s_nTouchCurCase = s_nTouchCurCase % TEST_COUNT;
+    runFileUtilsPerformanceTest();
+}
+
+void PerformanceFileUtilsLayer::backCallback(Ref* sender)
+{
+    s_nTouchCurCase = s_nTouchCurCase + TEST_COUNT -1;
+    s_nTouchCurCase = s_nTouchCurCase % TEST_COUNT;
+    runFileUtilsPerformanceTest();
+}
+
+void PerformanceFileUtilsLayer::resolveNames(long long* coldDuration, long long* warmDuration)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+    
+    auto fileUtils = FileUtils::getInstance();
+    fileUtils->purgeCachedEntries();
+    
+    // the first pass fills the caches, and builds the directory index if it is enabled
+    auto start = Clock::now();
+    for (const auto& name : _names)
+    {
+        fileUtils->fullPathForFilename(name);
+    }
+    auto end = Clock::now();
+    *coldDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    
+    start = Clock::now();
+    for (const auto& name : _names)
+    {
+        fileUtils->fullPathForFilename(name);
+    }
+    end = Clock::now();
+    *warmDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+void PerformanceFileUtilsLayer::doPerformanceTest(float dt)
+{
+    auto fileUtils = FileUtils::getInstance();
+    
+    long long statCold = 0, statWarm = 0;
+    fileUtils->setDirectoryIndexEnabled(false);
+    resolveNames(&statCold, &statWarm);
+    
+    long long indexCold = 0, indexWarm = 0;
+    fileUtils->setDirectoryIndexEnabled(true);
+    resolveNames(&indexCold, &indexWarm);
+    fileUtils->setDirectoryIndexEnabled(false);
+    
+    char str[192] = {0};
+    sprintf(str, "isFileExistInternal: %lld us, then %lld us\ndirectory index: %lld us, then %lld us",
+            statCold, statWarm, indexCold, indexWarm);
+    _resultLabel->setString(str);
+}
+
+void runFileUtilsPerformanceTest()
+{
+    auto scene = Scene::create();
+    auto layer = createLayer();
+    
+    scene->addChild(layer);
+    
+    Director::getInstance()->replaceScene(scene);
+}
@@ -0,0 +1,37 @@
+#ifndef __PERFORMANCE_FILE_UTILS_TEST_H__
+#define __PERFORMANCE_FILE_UTILS_TEST_H__
+
+#include "PerformanceTest.h"
+
+class PerformanceFileUtilsLayer : public PerformBasicLayer
+{
+public:
+    PerformanceFileUtilsLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+    
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void restartCallback(Ref* sender) override;
+    virtual void nextCallback(Ref* sender) override;
+    virtual void backCallback(Ref* sender) override;
+    
+    virtual void showCurrentTest() {}
+    
+    virtual std::string title() const { return "FileUtils Performance Test"; }
+    virtual std::string subtitle() const;
+    
+protected:
+    void doPerformanceTest(float dt);
+    //resolves all the names twice with the caches purged, returns the durations in microseconds
+    void resolveNames(long long* coldDuration, long long* warmDuration);
+    
+protected:
+    int _foundPercent;
+    std::vector<std::string> _names;
+    std::vector<std::string> _defaultSearchPaths;
+    bool _defaultPopupNotify;
+    Label* _resultLabel;
+};
+
+void runFileUtilsPerformanceTest();
+
+#endif //__PERFORMANCE_FILE_UTILS_TEST_H__
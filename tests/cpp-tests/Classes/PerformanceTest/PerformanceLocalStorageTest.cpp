@@ -0,0 +1,153 @@
+#include "PerformanceLocalStorageTest.h"
+#include "storage/local-storage/LocalStorage.h"
+
+#include <chrono>
+
+static const int TEST_COUNT = 1;
+static int s_nTouchCurCase = 0;
+
+static const int KEY_COUNT = 10000;
+
+static PerformanceLocalStorageLayer* createLayer()
+{
+    s_nTouchCurCase = s_nTouchCurCase % TEST_COUNT;
+    
+    auto result = new (std::nothrow) PerformanceLocalStorageLayer(true, TEST_COUNT, s_nTouchCurCase);
+    if(result)
+    {
+        result->autorelease();
+    }
+    return result;
+}
+
+PerformanceLocalStorageLayer::PerformanceLocalStorageLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+, _resultLabel(nullptr)
+{
+    
+}
+
+std::string PerformanceLocalStorageLayer::subtitle() const
+{
+    char str[64] = {0};
+    sprintf(str, "localStorageSetItem, %d keys", KEY_COUNT);
+    return str;
+}
+
+void PerformanceLocalStorageLayer::onEnter()
+{
+    PerformBasicLayer::onEnter();
+    
+    auto s = Director::getInstance()->getWinSize();
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+    
+    // Subtitle
+    auto l = Label::createWithTTF(subtitle().c_str(), "fonts/Thonburi.ttf", 16);
+    addChild(l, 1);
+    l->setPosition(Vec2(s.width/2, s.height-80));
+    
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+    
+    _dbPath = FileUtils::getInstance()->getWritablePath() + "PerformanceLocalStorageTest.sqlite";
+    
+    getScheduler()->schedule(schedule_selector(PerformanceLocalStorageLayer::doPerformanceTest), this, 1.0f, false);
+}
+
+void PerformanceLocalStorageLayer::onExit()
+{
+    localStorageSetAsyncWriteEnabled(true);
+    
+    PerformBasicLayer::onExit();
+}
+
+void PerformanceLocalStorageLayer::restartCallback(Ref* sender)
+{
+    runLocalStoragePerformanceTest();
+}
+
+void PerformanceLocalStorageLayer::nextCallback(Ref* sender)
+{
+    ++s_nTouchCurCase;
+    s_nTouchCurCase = s_nTouchCurCase % TEST_COUNT;
+    runLocalStoragePerformanceTest();
+}
+
+void PerformanceLocalStorageLayer::backCallback(Ref* sender)
+{
+    s_nTouchCurCase = s_nTouchCurCase + TEST_COUNT -1;
+    s_nTouchCurCase = s_nTouchCurCase % TEST_COUNT;
+    runLocalStoragePerformanceTest();
+}
+
+void PerformanceLocalStorageLayer::writeKeys(bool asyncWrite, bool transaction, long long* callDuration, long long* totalDuration)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+    
+    auto fileUtils = FileUtils::getInstance();
+    fileUtils->removeFile(_dbPath);
+    fileUtils->removeFile(_dbPath + "-wal");
+    fileUtils->removeFile(_dbPath + "-shm");
+    
+    localStorageInit(_dbPath);
+    localStorageSetAsyncWriteEnabled(asyncWrite);
+    
+    auto start = Clock::now();
+    if (transaction)
+        localStorageBeginTransaction();
+    for (int i = 0; i < KEY_COUNT; ++i)
+    {
+        localStorageSetItem(StringUtils::format("key_%d", i), StringUtils::format("value_%d", i));
+    }
+    if (transaction)
+        localStorageCommitTransaction();
+    auto end = Clock::now();
+    *callDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    
+    localStorageFlush();
+    end = Clock::now();
+    *totalDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    
+    localStorageFree();
+    localStorageSetAsyncWriteEnabled(true);
+    
+    fileUtils->removeFile(_dbPath);
+    fileUtils->removeFile(_dbPath + "-wal");
+    fileUtils->removeFile(_dbPath + "-shm");
+}
+
+void PerformanceLocalStorageLayer::doPerformanceTest(float dt)
+{
+    // only run once, writing the keys one by one takes seconds on mobile devices
+    getScheduler()->unschedule(schedule_selector(PerformanceLocalStorageLayer::doPerformanceTest), this);
+    
+    // one sqlite transaction per key, like before the background writer
+    long long syncCall = 0, syncTotal = 0;
+    writeKeys(false, false, &syncCall, &syncTotal);
+    
+    // the writer commits the queued keys together
+    long long asyncCall = 0, asyncTotal = 0;
+    writeKeys(true, false, &asyncCall, &asyncTotal);
+    
+    long long transactionCall = 0, transactionTotal = 0;
+    writeKeys(true, true, &transactionCall, &transactionTotal);
+    
+    char str[256] = {0};
+    sprintf(str, "one transaction per key: %lld us\nbackground writer: %lld us (written in %lld us)\nbegin/commit: %lld us (written in %lld us)",
+            syncTotal, asyncCall, asyncTotal, transactionCall, transactionTotal);
+    _resultLabel->setString(str);
+}
+
+void runLocalStoragePerformanceTest()
+{
+    auto scene = Scene::create();
+    auto layer = createLayer();
+    
+    scene->addChild(layer);
+    
+    Director::getInstance()->replaceScene(scene);
+}
@@ -0,0 +1,34 @@
+#ifndef __PERFORMANCE_LOCAL_STORAGE_TEST_H__
+#define __PERFORMANCE_LOCAL_STORAGE_TEST_H__
+
+#include "PerformanceTest.h"
+
+class PerformanceLocalStorageLayer : public PerformBasicLayer
+{
+public:
+    PerformanceLocalStorageLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+    
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void restartCallback(Ref* sender) override;
+    virtual void nextCallback(Ref* sender) override;
+    virtual void backCallback(Ref* sender) override;
+    
+    virtual void showCurrentTest() {}
+    
+    virtual std::string title() const { return "LocalStorage Performance Test"; }
+    virtual std::string subtitle() const;
+    
+protected:
+    void doPerformanceTest(float dt);
+    //writes the keys in a new database, returns the durations in microseconds of the calls and of the writes
+    void writeKeys(bool asyncWrite, bool transaction, long long* callDuration, long long* totalDuration);
+    
+protected:
+    std::string _dbPath;
+    Label* _resultLabel;
+};
+
+void runLocalStoragePerformanceTest();
+
+#endif //__PERFORMANCE_LOCAL_STORAGE_TEST_H__
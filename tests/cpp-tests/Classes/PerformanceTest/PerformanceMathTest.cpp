@@ -1,5 +1,7 @@
 #include "PerformanceMathTest.h"
 
+#include <chrono>
+
 // Enable profiles for this file
 #undef CC_PROFILER_DISPLAY_TIMERS
 #define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
@@ -27,7 +29,7 @@
 #undef CC_PROFILER_RESET_INSTANCE
 #define CC_PROFILER_RESET_INSTANCE(__id__, __name__) do{ ProfilingResetTimingBlock( String::createWithFormat("%08X - %s", __id__, __name__)->getCString() ); } while(0)
 
-static const int TEST_COUNT = 2;
+static const int TEST_COUNT = 3;
 static int s_nTouchCurCase = 0;
 
 static const int K_INFO_LOOP_TAG = 1581;
@@ -45,6 +47,9 @@ static PerformanceMathLayer* createLayer()
         case 1:
             result = new PerformanceMathLayer2(true, TEST_COUNT, s_nTouchCurCase);
             break;
+        case 2:
+            result = new PerformanceMathLayer3(true, TEST_COUNT, s_nTouchCurCase);
+            break;
         default:
             result = new PerformanceMathLayer1(true, TEST_COUNT, s_nTouchCurCase);
             break;
@@ -182,6 +187,96 @@ void PerformanceMathLayer2::doPerformanceTest(float dt)
     
 }
 
+void PerformanceMathLayer3::onEnter()
+{
+    PerformanceMathLayer::onEnter();
+    
+    auto s = Director::getInstance()->getWinSize();
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2 - 80));
+    addChild(_resultLabel, 1);
+}
+
+void PerformanceMathLayer3::doPerformanceTest(float dt)
+{
+    // _loopCount is the number of vertices transformed per frame
+    if (_srcVerts.size() != (size_t)_loopCount)
+    {
+        _srcVerts.resize(_loopCount);
+        _dstVerts.resize(_loopCount);
+        for (int i = 0; i < _loopCount; ++i)
+        {
+            _srcVerts[i].vertices.set(i % 1024, i / 1024, 0);
+        }
+    }
+    if (_loopCount == 0)
+        return;
+    
+    Mat4 modelView;
+    Mat4::createRotation(Vec3(1,1,1), 10, &modelView);
+    modelView.translate(100, 50, 0);
+    
+    typedef std::chrono::high_resolution_clock Clock;
+    
+    CC_PROFILER_START("profile_MatTransformPoint");
+    auto start = Clock::now();
+    for (int i = 0; i < _loopCount; ++i)
+    {
+        _dstVerts[i] = _srcVerts[i];
+        modelView.transformPoint(_srcVerts[i].vertices, &_dstVerts[i].vertices);
+    }
+    auto end = Clock::now();
+    CC_PROFILER_STOP("profile_MatTransformPoint");
+    auto perVertexDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    
+    // the same batch in plain C, the reference for the SIMD path below
+    CC_PROFILER_START("profile_MatTransformPointsScalar");
+    start = Clock::now();
+    memcpy(_dstVerts.data(), _srcVerts.data(), sizeof(V3F_C4B_T2F) * _loopCount);
+    const float* m = modelView.m;
+    for (int i = 0; i < _loopCount; ++i)
+    {
+        const Vec3& v = _srcVerts[i].vertices;
+        _dstVerts[i].vertices.set(v.x * m[0] + v.y * m[4] + v.z * m[8] + m[12],
+                                  v.x * m[1] + v.y * m[5] + v.z * m[9] + m[13],
+                                  v.x * m[2] + v.y * m[6] + v.z * m[10] + m[14]);
+    }
+    end = Clock::now();
+    CC_PROFILER_STOP("profile_MatTransformPointsScalar");
+    auto scalarDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    
+    CC_PROFILER_START(_profileName.c_str());
+    start = Clock::now();
+    memcpy(_dstVerts.data(), _srcVerts.data(), sizeof(V3F_C4B_T2F) * _loopCount);
+    modelView.transformPoints(&_srcVerts[0].vertices, &_dstVerts[0].vertices, sizeof(V3F_C4B_T2F), _loopCount);
+    end = Clock::now();
+    CC_PROFILER_STOP(_profileName.c_str());
+    auto batchDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    
+#if defined(__SSE__)
+    const char* batchPath = "SSE";
+#elif defined(__aarch64__) || defined(__arm64__)
+    const char* batchPath = "NEON64";
+#elif defined(__ARM_NEON__)
+    const char* batchPath = "NEON";
+#else
+    const char* batchPath = "C";
+#endif
+    
+    // vertices per millisecond, durations are in microseconds
+    const double perVertexThroughput = _loopCount * 1000.0 / std::max((long long)perVertexDuration, 1LL);
+    const double scalarThroughput = _loopCount * 1000.0 / std::max((long long)scalarDuration, 1LL);
+    const double batchThroughput = _loopCount * 1000.0 / std::max((long long)batchDuration, 1LL);
+    char str[192] = {0};
+    sprintf(str, "transformPoint: %.0f verts/ms\nscalar: %.0f verts/ms | %s: %.0f verts/ms (x%.2f)",
+            perVertexThroughput,
+            scalarThroughput,
+            batchPath,
+            batchThroughput,
+            batchThroughput / scalarThroughput);
+    _resultLabel->setString(str);
+}
+
 void runMathPerformanceTest()
 {
     auto scene = Scene::create();
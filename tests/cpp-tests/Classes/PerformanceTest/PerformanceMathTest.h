@@ -68,6 +68,27 @@ public:
     
 };
 
+class PerformanceMathLayer3 : public PerformanceMathLayer
+{
+public:
+    PerformanceMathLayer3(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0):
+    PerformanceMathLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    , _resultLabel(nullptr)
+    {
+        _profileName = "profile_MatTransformPoints";
+    }
+    
+    virtual void onEnter() override;
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const { return "Mat4 TransformPoint vs TransformPoints (V3F_C4B_T2F)"; }
+    
+protected:
+    std::vector<V3F_C4B_T2F> _srcVerts;
+    std::vector<V3F_C4B_T2F> _dstVerts;
+    Label* _resultLabel;
+};
+
 void runMathPerformanceTest();
 
 #endif //__PERFORMANCE_MATH_TEST_H__
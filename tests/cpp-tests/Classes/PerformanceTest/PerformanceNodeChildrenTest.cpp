@@ -2,6 +2,8 @@
 
 #include <algorithm>
 
+#include "base/CCThreadPool.h"
+
 // Enable profiles for this file
 #undef CC_PROFILER_DISPLAY_TIMERS
 #define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
@@ -46,6 +48,8 @@ static std::function<NodeChildrenMainScene*()> createFunctions[] =
     CL(SortAllChildrenSpriteSheet),
 
     CL(VisitSceneGraph),
+    CL(UpdateTransformsSceneGraph),
+    CL(SortFewReorderedChildren),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -968,6 +972,172 @@ const char*  VisitSceneGraph::testName()
     return "visit()";
 }
 
+////////////////////////////////////////////////////////
+//
+// UpdateTransformsSceneGraph
+//
+////////////////////////////////////////////////////////
+static const int kNodesPerGroup = 64;
+
+UpdateTransformsSceneGraph::UpdateTransformsSceneGraph()
+: _container(nullptr)
+{
+}
+
+UpdateTransformsSceneGraph::~UpdateTransformsSceneGraph()
+{
+    CC_SAFE_RELEASE(_container);
+}
+
+void UpdateTransformsSceneGraph::initWithQuantityOfNodes(unsigned int nodes)
+{
+    // the benchmarked tree is detached: the hierarchy updates it from an identity root
+    // and clears its dirty flags, which must not affect what is drawn
+    _container = Node::create();
+    _container->retain();
+    
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+    scheduleUpdate();
+}
+
+void UpdateTransformsSceneGraph::updateQuantityOfNodes()
+{
+    // the nodes are grouped under parents of kNodesPerGroup children, which are independent subtrees
+    _container->removeAllChildren();
+    for (int i = 0; i < quantityOfNodes; i += kNodesPerGroup)
+    {
+        auto group = Node::create();
+        _container->addChild(group);
+        for (int j = 0; j < kNodesPerGroup && i + j < quantityOfNodes; ++j)
+        {
+            auto node = Node::create();
+            node->setPosition(Vec2(j, j));
+            group->addChild(node);
+        }
+    }
+    
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void UpdateTransformsSceneGraph::update(float dt)
+{
+    // moving the groups makes every node dirty
+    for (const auto& group : _container->getChildren())
+    {
+        group->setRotation(group->getRotation() + 1);
+    }
+    
+    CC_PROFILER_START("TransformHierarchy::update() sequential");
+    _hierarchy.update(_container, Mat4::IDENTITY, 0);
+    CC_PROFILER_STOP("TransformHierarchy::update() sequential");
+    
+    for (const auto& group : _container->getChildren())
+    {
+        group->setRotation(group->getRotation() + 1);
+    }
+    
+    CC_PROFILER_START("TransformHierarchy::update() parallel");
+    _hierarchy.update(_container, Mat4::IDENTITY, 0, ThreadPool::getInstance());
+    CC_PROFILER_STOP("TransformHierarchy::update() parallel");
+    
+    // the results are not visited, end this pass like Scene::render() does
+    TransformHierarchy::invalidate();
+}
+
+std::string UpdateTransformsSceneGraph::title() const
+{
+    return "Performance of updating transforms";
+}
+
+std::string UpdateTransformsSceneGraph::subtitle() const
+{
+    return "TransformHierarchy sequential vs parallel. See console";
+}
+
+const char*  UpdateTransformsSceneGraph::testName()
+{
+    return "TransformHierarchy::update()";
+}
+
+////////////////////////////////////////////////////////
+//
+// SortFewReorderedChildren
+//
+////////////////////////////////////////////////////////
+SortFewReorderedChildren::SortFewReorderedChildren()
+: _container(nullptr)
+{
+}
+
+void SortFewReorderedChildren::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _container = Node::create();
+    _container->setPosition(Vec2(-1000,-1000));
+    addChild(_container);
+    
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+    scheduleUpdate();
+}
+
+void SortFewReorderedChildren::updateQuantityOfNodes()
+{
+    _container->removeAllChildren();
+    for (int i = 0; i < quantityOfNodes; ++i)
+    {
+        _container->addChild(Node::create(), CCRANDOM_MINUS1_1() * 50);
+    }
+    _container->sortAllChildren();
+    
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void SortFewReorderedChildren::reorderFewChildren()
+{
+    // 1% of the children change their z-order, like bullets going over or under each other
+    auto& children = _container->getChildren();
+    ssize_t count = std::max(children.size() / 100, (ssize_t)1);
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        auto child = children.at(rand() % children.size());
+        child->setLocalZOrder(CCRANDOM_MINUS1_1() * 50);
+    }
+}
+
+void SortFewReorderedChildren::update(float dt)
+{
+    if (_container->getChildrenCount() == 0)
+        return;
+    
+    reorderFewChildren();
+    CC_PROFILER_START("Node::sortAllChildren() incremental");
+    _container->sortAllChildren();
+    CC_PROFILER_STOP("Node::sortAllChildren() incremental");
+    
+    reorderFewChildren();
+    auto& children = _container->getChildren();
+    CC_PROFILER_START("Node::sortAllChildren() std::sort");
+    std::sort(std::begin(children), std::end(children), nodeComparisonLess);
+    CC_PROFILER_STOP("Node::sortAllChildren() std::sort");
+    
+    // forget the children reordered for the comparison
+    _container->sortAllChildren();
+}
+
+std::string SortFewReorderedChildren::title() const
+{
+    return "Node::sortAllChildren() with few changes";
+}
+
+std::string SortFewReorderedChildren::subtitle() const
+{
+    return "1% of children reordered, incremental vs std::sort. See console";
+}
+
+const char*  SortFewReorderedChildren::testName()
+{
+    return "Node::sortAllChildren()";
+}
+
 ///----------------------------------------
 void runNodeChildrenTest()
 {
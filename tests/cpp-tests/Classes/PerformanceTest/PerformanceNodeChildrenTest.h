@@ -226,6 +226,48 @@ public:
     virtual const char* testName() override;
 };
 
+class UpdateTransformsSceneGraph : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(UpdateTransformsSceneGraph);
+    
+    UpdateTransformsSceneGraph();
+    virtual ~UpdateTransformsSceneGraph();
+    
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+    
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+    
+protected:
+    Node* _container;
+    TransformHierarchy _hierarchy;
+};
+
+class SortFewReorderedChildren : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(SortFewReorderedChildren);
+    
+    SortFewReorderedChildren();
+    
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+    
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+    
+protected:
+    void reorderFewChildren();
+    
+    Node* _container;
+};
+
 void runNodeChildrenTest();
 
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
@@ -556,3 +556,157 @@ void runParticleTest()
     Director::getInstance()->replaceScene(scene);
     scene->release();
 }
+
+////////////////////////////////////////////////////////
+//
+// ParticleEmittersPerformTest
+//
+////////////////////////////////////////////////////////
+static const int kEmitterCount = 100;
+static const int kParticlesPerEmitter = 1000;
+// the average update duration is shown every kMeasuredFrames frames
+static const int kMeasuredFrames = 60;
+
+ParticleEmittersPerformTest::ParticleEmittersPerformTest(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+, _updateDuration(0)
+, _frames(0)
+, _afterUpdateListener(nullptr)
+, _parallelItem(nullptr)
+, _resultLabel(nullptr)
+{
+
+}
+
+std::string ParticleEmittersPerformTest::subtitle() const
+{
+    char str[64] = {0};
+    sprintf(str, "%d emitters of %d particles", kEmitterCount, kParticlesPerEmitter);
+    return str;
+}
+
+void ParticleEmittersPerformTest::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    auto texture = Director::getInstance()->getTextureCache()->addImage("Images/fire.png");
+
+    // a grid of emitters
+    const int columns = 10;
+    const int rows = kEmitterCount / columns;
+    for (int i = 0; i < kEmitterCount; ++i)
+    {
+        auto particleSystem = ParticleSystemQuad::createWithTotalParticles(kParticlesPerEmitter);
+        particleSystem->setTexture(texture);
+        particleSystem->setDuration(-1);
+        particleSystem->setGravity(Vec2(0,-90));
+        particleSystem->setAngle(90);
+        particleSystem->setAngleVar(20);
+        particleSystem->setSpeed(60);
+        particleSystem->setSpeedVar(20);
+        particleSystem->setPosition(Vec2(s.width * (i % columns + 0.5f) / columns, s.height * (i / columns + 0.5f) / rows));
+        particleSystem->setPosVar(Vec2(4,4));
+        particleSystem->setLife(2.0f);
+        particleSystem->setLifeVar(1);
+        particleSystem->setEmissionRate(kParticlesPerEmitter / particleSystem->getLife());
+        particleSystem->setStartColor(Color4F(0.5f, 0.5f, 0.5f, 1.0f));
+        particleSystem->setStartColorVar(Color4F(0.5f, 0.5f, 0.5f, 1.0f));
+        particleSystem->setEndColor(Color4F(0.1f, 0.1f, 0.1f, 0.2f));
+        particleSystem->setEndColorVar(Color4F(0.1f, 0.1f, 0.1f, 0.2f));
+        particleSystem->setStartSize(4.0f);
+        particleSystem->setEndSize(4.0f);
+        particleSystem->setBlendAdditive(false);
+        addChild(particleSystem);
+    }
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    auto l = Label::createWithTTF(subtitle().c_str(), "fonts/Thonburi.ttf", 16);
+    addChild(l, 1);
+    l->setPosition(Vec2(s.width/2, s.height-80));
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    MenuItemFont::setFontSize(24);
+    _parallelItem = MenuItemFont::create("", CC_CALLBACK_1(ParticleEmittersPerformTest::toggleParallelUpdate, this));
+    _parallelItem->setString(Director::getInstance()->isParallelParticleUpdateEnabled() ? "parallel update: on" : "parallel update: off");
+    auto menu = Menu::create(_parallelItem, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2 - 40));
+    addChild(menu, 1);
+
+    // the particle systems are updated with priority 1, the deferred ones after the scheduler update
+    scheduleUpdateWithPriority(-1);
+    _afterUpdateListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_UPDATE,
+                                                                                                CC_CALLBACK_1(ParticleEmittersPerformTest::onAfterUpdate, this));
+}
+
+void ParticleEmittersPerformTest::onExit()
+{
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_afterUpdateListener);
+    Director::getInstance()->setParallelParticleUpdateEnabled(false);
+
+    PerformBasicLayer::onExit();
+}
+
+void ParticleEmittersPerformTest::restartCallback(Ref* sender)
+{
+    runParticleEmittersTest();
+}
+
+void ParticleEmittersPerformTest::nextCallback(Ref* sender)
+{
+    runParticleEmittersTest();
+}
+
+void ParticleEmittersPerformTest::backCallback(Ref* sender)
+{
+    runParticleEmittersTest();
+}
+
+void ParticleEmittersPerformTest::update(float dt)
+{
+    _updateStart = std::chrono::high_resolution_clock::now();
+}
+
+void ParticleEmittersPerformTest::onAfterUpdate(EventCustom* event)
+{
+    auto end = std::chrono::high_resolution_clock::now();
+    _updateDuration += std::chrono::duration_cast<std::chrono::microseconds>(end - _updateStart).count();
+
+    if (++_frames == kMeasuredFrames)
+    {
+        char str[64] = {0};
+        sprintf(str, "particles update: %.2f ms per frame", _updateDuration / 1000.0f / kMeasuredFrames);
+        _resultLabel->setString(str);
+
+        _updateDuration = 0;
+        _frames = 0;
+    }
+}
+
+void ParticleEmittersPerformTest::toggleParallelUpdate(Ref* sender)
+{
+    auto director = Director::getInstance();
+    director->setParallelParticleUpdateEnabled(!director->isParallelParticleUpdateEnabled());
+    _parallelItem->setString(director->isParallelParticleUpdateEnabled() ? "parallel update: on" : "parallel update: off");
+
+    _updateDuration = 0;
+    _frames = 0;
+}
+
+void runParticleEmittersTest()
+{
+    auto scene = Scene::create();
+    auto layer = new (std::nothrow) ParticleEmittersPerformTest(true, 1, 0);
+    scene->addChild(layer);
+    layer->release();
+
+    Director::getInstance()->replaceScene(scene);
+}
@@ -3,6 +3,8 @@
 
 #include "PerformanceTest.h"
 
+#include <chrono>
+
 class ParticleMenuLayer : public PerformBasicLayer
 {
 public:
@@ -58,6 +60,39 @@ public:
     virtual void doTest();
 };
 
+class ParticleEmittersPerformTest : public PerformBasicLayer
+{
+public:
+    ParticleEmittersPerformTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void restartCallback(Ref* sender) override;
+    virtual void nextCallback(Ref* sender) override;
+    virtual void backCallback(Ref* sender) override;
+
+    virtual void showCurrentTest() {}
+
+    virtual std::string title() const { return "Particle Emitters Perf Test"; }
+    virtual std::string subtitle() const;
+
+    // starts the measure, scheduled before the particle systems
+    virtual void update(float dt) override;
+
+protected:
+    // ends the measure, after the deferred particle updates
+    void onAfterUpdate(EventCustom* event);
+    void toggleParallelUpdate(Ref* sender);
+
+    std::chrono::high_resolution_clock::time_point _updateStart;
+    long long _updateDuration;
+    int _frames;
+    EventListenerCustom* _afterUpdateListener;
+    MenuItemFont* _parallelItem;
+    Label* _resultLabel;
+};
+
 void runParticleTest();
+void runParticleEmittersTest();
 
 #endif
@@ -0,0 +1,129 @@
+#include "PerformanceRenderQueueTest.h"
+
+#include <algorithm>
+#include <chrono>
+
+static const int TEST_COUNT = 3;
+static int s_nTouchCurCase = 0;
+
+static const int s_commandCounts[TEST_COUNT] = { 1000, 10000, 100000 };
+
+static PerformanceRenderQueueLayer* createLayer()
+{
+    s_nTouchCurCase = s_nTouchCurCase % TEST_COUNT;
+    
+    auto result = new (std::nothrow) PerformanceRenderQueueLayer(true, TEST_COUNT, s_nTouchCurCase);
+    if(result)
+    {
+        result->autorelease();
+    }
+    return result;
+}
+
+PerformanceRenderQueueLayer::PerformanceRenderQueueLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+, _commandCount(s_commandCounts[nCurCase % TEST_COUNT])
+, _resultLabel(nullptr)
+{
+    
+}
+
+std::string PerformanceRenderQueueLayer::subtitle() const
+{
+    char str[96] = {0};
+    sprintf(str, "RenderQueue::sort (radix) vs std::sort, %d commands", _commandCount);
+    return str;
+}
+
+void PerformanceRenderQueueLayer::onEnter()
+{
+    PerformBasicLayer::onEnter();
+    
+    auto s = Director::getInstance()->getWinSize();
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+    
+    // Subtitle
+    auto l = Label::createWithTTF(subtitle().c_str(), "fonts/Thonburi.ttf", 16);
+    addChild(l, 1);
+    l->setPosition(Vec2(s.width/2, s.height-80));
+    
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+    
+    // Commands keep their globalZ between frames, only the order they are pushed in changes
+    _commands.resize(_commandCount);
+    for (int i = 0; i < _commandCount; ++i)
+    {
+        float globalZ = (float)(rand() % 2000 - 1000);
+        if (globalZ == 0)
+            globalZ = 1;
+        _commands[i].init(globalZ);
+    }
+    
+    getScheduler()->schedule(schedule_selector(PerformanceRenderQueueLayer::doPerformanceTest), this, 0.0f, false);
+}
+
+void PerformanceRenderQueueLayer::restartCallback(Ref* sender)
+{
+    runRenderQueuePerformanceTest();
+}
+
+void PerformanceRenderQueueLayer::nextCallback(Ref* sender)
+{
+    ++s_nTouchCurCase;
+    s_nTouchCurCase = s_nTouchCurCase % TEST_COUNT;
+    runRenderQueuePerformanceTest();
+}
+
+void PerformanceRenderQueueLayer::backCallback(Ref* sender)
+{
+    s_nTouchCurCase = s_nTouchCurCase + TEST_COUNT -1;
+    s_nTouchCurCase = s_nTouchCurCase % TEST_COUNT;
+    runRenderQueuePerformanceTest();
+}
+
+void PerformanceRenderQueueLayer::doPerformanceTest(float dt)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+    
+    std::random_shuffle(_commands.begin(), _commands.end());
+    
+    _queue.clear();
+    for (auto& command : _commands)
+    {
+        _queue.push_back(&command);
+    }
+    _negCommands = _queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_NEG);
+    _posCommands = _queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_POS);
+    
+    auto start = Clock::now();
+    _queue.sort();
+    auto end = Clock::now();
+    auto radixDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    
+    // The comparison sort RenderQueue used before
+    auto compare = [](RenderCommand* a, RenderCommand* b) { return a->getGlobalOrder() < b->getGlobalOrder(); };
+    start = Clock::now();
+    std::sort(std::begin(_negCommands), std::end(_negCommands), compare);
+    std::sort(std::begin(_posCommands), std::end(_posCommands), compare);
+    end = Clock::now();
+    auto comparisonDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    
+    char str[128] = {0};
+    sprintf(str, "radix sort: %lld us\nstd::sort: %lld us", (long long)radixDuration, (long long)comparisonDuration);
+    _resultLabel->setString(str);
+}
+
+void runRenderQueuePerformanceTest()
+{
+    auto scene = Scene::create();
+    auto layer = createLayer();
+    
+    scene->addChild(layer);
+    
+    Director::getInstance()->replaceScene(scene);
+}
@@ -0,0 +1,37 @@
+#ifndef __PERFORMANCE_RENDER_QUEUE_TEST_H__
+#define __PERFORMANCE_RENDER_QUEUE_TEST_H__
+
+#include "PerformanceTest.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCCustomCommand.h"
+
+class PerformanceRenderQueueLayer : public PerformBasicLayer
+{
+public:
+    PerformanceRenderQueueLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+    
+    virtual void onEnter() override;
+    virtual void restartCallback(Ref* sender) override;
+    virtual void nextCallback(Ref* sender) override;
+    virtual void backCallback(Ref* sender) override;
+    
+    virtual void showCurrentTest() {}
+    
+    virtual std::string title() const { return "RenderQueue Performance Test"; }
+    virtual std::string subtitle() const;
+    
+protected:
+    void doPerformanceTest(float dt);
+    
+protected:
+    int _commandCount;
+    std::vector<CustomCommand> _commands;
+    std::vector<RenderCommand*> _negCommands;
+    std::vector<RenderCommand*> _posCommands;
+    RenderQueue _queue;
+    Label* _resultLabel;
+};
+
+void runRenderQueuePerformanceTest();
+
+#endif //__PERFORMANCE_RENDER_QUEUE_TEST_H__
@@ -442,6 +442,13 @@ void SpriteMainScene::initWithSubTest(int asubtest, int nNodes)
     autoTestItem->setTag(1);
     autoTestItem->setPosition(Vec2( s.width - 90, s.height / 2));
     menuAutoTest->addChild(autoTestItem);
+    
+    auto renderer = Director::getInstance()->getRenderer();
+    auto parallelFillItem = MenuItemFont::create(renderer->isParallelFillEnabled() ? "Parallel Fill On" : "Parallel Fill Off",
+                                                 CC_CALLBACK_1(SpriteMainScene::onParallelFill, this));
+    parallelFillItem->setTag(2);
+    parallelFillItem->setPosition(Vec2( s.width - 90, s.height / 2 - 30));
+    menuAutoTest->addChild(parallelFillItem);
     addChild( menuAutoTest, 3, kTagAutoTestMenu );
     
     // Sub Tests
@@ -770,6 +777,15 @@ void  SpriteMainScene::onAutoTest(Ref* sender)
     }
 }
 
+void  SpriteMainScene::onParallelFill(Ref* sender)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setParallelFillEnabled(!renderer->isParallelFillEnabled());
+    
+    MenuItemFont* menuItem = dynamic_cast<MenuItemFont*>(sender);
+    menuItem->setString(renderer->isParallelFillEnabled() ? "Parallel Fill On" : "Parallel Fill Off");
+}
+
 ////////////////////////////////////////////////////////
 //
 // For test functions
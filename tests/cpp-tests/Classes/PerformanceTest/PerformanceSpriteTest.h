@@ -83,6 +83,7 @@ public:
     virtual void onExit() override;
     void updateAutoTest(float dt);
     void onAutoTest(Ref* sender);
+    void onParallelFill(Ref* sender);
 
     // auto tests
     static bool _s_autoTest;
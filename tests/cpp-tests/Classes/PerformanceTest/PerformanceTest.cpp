@@ -13,6 +13,9 @@
 #include "PerformanceScenarioTest.h"
 #include "PerformanceCallbackTest.h"
 #include "PerformanceMathTest.h"
+#include "PerformanceRenderQueueTest.h"
+#include "PerformanceFileUtilsTest.h"
+#include "PerformanceLocalStorageTest.h"
 
 enum
 {
@@ -28,6 +31,7 @@ struct {
     { "Alloc Test", [](Ref*sender){runAllocPerformanceTest(); } },
     { "NodeChildren Test", [](Ref*sender){runNodeChildrenTest();} },
 	{ "Particle Test",[](Ref*sender){runParticleTest();} },
+    { "Particle Emitters Perf Test",[](Ref*sender){runParticleEmittersTest();} },
 	{ "Sprite Perf Test",[](Ref*sender){runSpriteTest();} },
 	{ "Texture Perf Test",[](Ref*sender){runTextureTest();} },
 	{ "Touches Perf Test",[](Ref*sender){runTouchesTest();} },
@@ -38,6 +42,9 @@ struct {
     { "Scenario Perf Test", [](Ref* sender ) { runScenarioTest(); } },
     { "Callback Perf Test", [](Ref* sender ) { runCallbackPerformanceTest(); } },
     { "Math Perf Test", [](Ref* sender ) { runMathPerformanceTest(); } },
+    { "RenderQueue Perf Test", [](Ref* sender ) { runRenderQueuePerformanceTest(); } },
+    { "FileUtils Perf Test", [](Ref* sender ) { runFileUtilsPerformanceTest(); } },
+    { "LocalStorage Perf Test", [](Ref* sender ) { runLocalStoragePerformanceTest(); } },
 };
 
 static const int g_testMax = sizeof(g_testsName)/sizeof(g_testsName[0]);
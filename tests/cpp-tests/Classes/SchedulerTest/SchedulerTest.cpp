@@ -1,5 +1,6 @@
 #include "SchedulerTest.h"
 #include "../testResource.h"
+#include <chrono>
 
 enum {
     kTagAnimationDance = 1,
@@ -30,7 +31,9 @@ static std::function<Layer*()> createFunctions[] = {
     CL(SchedulerIssue2268),
     CL(ScheduleCallbackTest),
     CL(ScheduleUpdatePriority),
-    CL(SchedulerIssue10232)
+    CL(SchedulerIssue10232),
+    CL(SchedulerTimersPerformance),
+    CL(SchedulerPerformFunctions)
 };
 
 #define MAX_LAYER (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -1239,3 +1242,160 @@ std::string SchedulerIssue10232::subtitle() const
 {
     return "Should not crash";
 }
+
+// SchedulerTimersPerformance
+
+static const int kTimersPerformanceCount = 10000;
+static const int kTimersPerformanceFrames = 600;
+
+void SchedulerTimersPerformance::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    const float dt = 1.0f / 60;
+    std::vector<float> intervals(kTimersPerformanceCount);
+    for (auto& interval : intervals)
+    {
+        interval = 0.5f + CCRANDOM_0_1() * 4.5f;
+    }
+
+    int walkFired = 0;
+    int heapFired = 0;
+    auto scheduler = new (std::nothrow) Scheduler();
+
+    // every timer updated each frame, as the scheduler used to do
+    std::vector<TimerTargetCallback*> timers;
+    for (int i = 0; i < kTimersPerformanceCount; ++i)
+    {
+        auto timer = new (std::nothrow) TimerTargetCallback();
+        timer->initWithCallback(scheduler, [&walkFired](float) { ++walkFired; }, this,
+                                StringUtils::format("walk%d", i), intervals[i], CC_REPEAT_FOREVER, 0.0f);
+        timers.push_back(timer);
+    }
+
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int frame = 0; frame < kTimersPerformanceFrames; ++frame)
+    {
+        for (auto timer : timers)
+        {
+            timer->update(dt);
+        }
+    }
+    auto walkTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    for (auto timer : timers)
+    {
+        timer->release();
+    }
+
+    // only the due timers taken out of the scheduler heap
+    for (int i = 0; i < kTimersPerformanceCount; ++i)
+    {
+        scheduler->schedule([&heapFired](float) { ++heapFired; }, this, intervals[i], false, StringUtils::format("heap%d", i));
+    }
+
+    begin = std::chrono::high_resolution_clock::now();
+    for (int frame = 0; frame < kTimersPerformanceFrames; ++frame)
+    {
+        scheduler->update(dt);
+    }
+    auto heapTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    scheduler->unscheduleAll();
+    scheduler->release();
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF(StringUtils::format("%d timers, %d frames\nper-frame walk: %.2f ms/frame (%d fired)\nheap: %.2f ms/frame (%d fired)",
+                                                          kTimersPerformanceCount, kTimersPerformanceFrames,
+                                                          walkTime / 1000.0f / kTimersPerformanceFrames, walkFired,
+                                                          heapTime / 1000.0f / kTimersPerformanceFrames, heapFired),
+                                      "fonts/arial.ttf", 20);
+    label->setAlignment(TextHAlignment::CENTER);
+    label->setPosition(Vec2(s.width / 2, s.height / 2));
+    addChild(label);
+
+    CCLOG("SchedulerTimersPerformance: walk %lld us, heap %lld us", (long long)walkTime, (long long)heapTime);
+}
+
+std::string SchedulerTimersPerformance::title() const
+{
+    return "Timers Performance";
+}
+
+std::string SchedulerTimersPerformance::subtitle() const
+{
+    return "10000 timers updated by a per-frame walk vs the scheduler heap";
+}
+
+// SchedulerPerformFunctions
+
+static const int kPerformFunctionsProducers = 4;
+static const int kPerformFunctionsBatch = 500;
+
+void SchedulerPerformFunctions::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    _statsLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _statsLabel->setAlignment(TextHAlignment::CENTER);
+    _statsLabel->setPosition(Vec2(s.width / 2, s.height / 2));
+    addChild(_statsLabel);
+
+    auto scheduler = Director::getInstance()->getScheduler();
+    scheduler->setPerformFunctionsTimeBudget(0.002f);
+
+    // the functions may be called after this layer is gone, they only keep the counter alive
+    _performed = std::make_shared<std::atomic<int>>(0);
+    _stopProducers = false;
+    for (int i = 0; i < kPerformFunctionsProducers; ++i)
+    {
+        _producers.push_back(std::thread([this, scheduler]() {
+            auto performed = _performed;
+            while (!_stopProducers)
+            {
+                for (int j = 0; j < kPerformFunctionsBatch; ++j)
+                {
+                    scheduler->performFunctionInCocosThread([performed]() { ++*performed; });
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }));
+    }
+
+    scheduleUpdate();
+}
+
+void SchedulerPerformFunctions::onExit()
+{
+    _stopProducers = true;
+    for (auto& producer : _producers)
+    {
+        producer.join();
+    }
+    _producers.clear();
+
+    Director::getInstance()->getScheduler()->setPerformFunctionsTimeBudget(0);
+
+    SchedulerTestLayer::onExit();
+}
+
+void SchedulerPerformFunctions::update(float dt)
+{
+    auto scheduler = Director::getInstance()->getScheduler();
+    _statsLabel->setString(StringUtils::format("performed: %d (total %d)\nqueued: %d\nlatency: %.2f ms max, %.2f ms average",
+                                               scheduler->getPerformedFunctionsCount(), _performed->load(),
+                                               (int)scheduler->getPerformFunctionsQueueSize(),
+                                               scheduler->getPerformFunctionsMaxLatency() * 1000,
+                                               scheduler->getPerformFunctionsAverageLatency() * 1000));
+}
+
+std::string SchedulerPerformFunctions::title() const
+{
+    return "Perform Functions In Cocos Thread";
+}
+
+std::string SchedulerPerformFunctions::subtitle() const
+{
+    return "4 threads queue functions, 2 ms per frame are spent calling them";
+}
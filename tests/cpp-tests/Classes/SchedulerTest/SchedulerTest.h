@@ -5,6 +5,8 @@
 #include "extensions/cocos-ext.h"
 #include "../testBasic.h"
 #include "../BaseTest.h"
+#include <atomic>
+#include <thread>
 
 USING_NS_CC_EXT;
 
@@ -342,4 +344,34 @@ public:
     void update(float dt) override;
 };
 
+class SchedulerTimersPerformance : public SchedulerTestLayer
+{
+public:
+    CREATE_FUNC(SchedulerTimersPerformance);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void onEnter() override;
+};
+
+class SchedulerPerformFunctions : public SchedulerTestLayer
+{
+public:
+    CREATE_FUNC(SchedulerPerformFunctions);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void onEnter() override;
+    void onExit() override;
+    void update(float dt) override;
+
+private:
+    std::vector<std::thread> _producers;
+    std::atomic<bool> _stopProducers;
+    std::shared_ptr<std::atomic<int>> _performed;
+    Label* _statsLabel;
+};
+
 #endif
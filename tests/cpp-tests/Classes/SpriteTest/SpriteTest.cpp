@@ -109,6 +109,7 @@ static std::function<Layer*()> createFunctions[] =
 	CL(SpriteAnimationSplit),
 	CL(SpriteFrameTest),
 	CL(SpriteFrameAliasNameTest),
+	CL(SpriteFrameIndexTest),
 	CL(SpriteFramesFromFileContent),
 	CL(SpriteBatchNodeReorder),
 	CL(SpriteBatchNodeReorderIssue744),
@@ -1881,6 +1882,55 @@ std::string SpriteFrameAliasNameTest::subtitle() const
     return "SpriteFrames are obtained using the alias name";
 }
 
+//------------------------------------------------------------------
+//
+// SpriteFrameIndexTest
+//
+//------------------------------------------------------------------
+void SpriteFrameIndexTest::onEnter()
+{
+    SpriteTestDemo::onEnter();
+    auto s = Director::getInstance()->getWinSize();
+
+    // grossini-aliases.cssi was converted from grossini-aliases.plist by tools/sprite-sheet-index/plist_to_index.py,
+    // it is loaded without parsing the plist
+    auto cache = SpriteFrameCache::getInstance();
+    cache->addSpriteFramesWithFile("animations/grossini-aliases.cssi", "animations/grossini-aliases.png");
+
+    auto sprite = Sprite::createWithSpriteFrameName("grossini_dance_01.png");
+    sprite->setPosition(Vec2(s.width * 0.5f, s.height * 0.5f));
+    addChild(sprite);
+
+    Vector<SpriteFrame*> animFrames(15);
+    char str[100] = {0};
+    for(int i = 1; i < 15; i++)
+    {
+        // the aliases are in the index too
+        sprintf(str, "dance_%02d", i);
+        auto frame = cache->getSpriteFrameByName(str);
+        animFrames.pushBack(frame);
+    }
+
+    auto animation = Animation::createWithSpriteFrames(animFrames, 0.3f);
+    sprite->runAction(RepeatForever::create(Animate::create(animation)));
+}
+
+void SpriteFrameIndexTest::onExit()
+{
+    SpriteTestDemo::onExit();
+    SpriteFrameCache::getInstance()->removeSpriteFramesFromFile("animations/grossini-aliases.cssi");
+}
+
+std::string SpriteFrameIndexTest::title() const
+{
+    return "SpriteFrame Binary Index";
+}
+
+std::string SpriteFrameIndexTest::subtitle() const
+{
+    return "Same animation as SpriteFrame Alias Name, from a binary index";
+}
+
 //------------------------------------------------------------------
 //
 // SpriteFramesFromFileContent
@@ -337,6 +337,17 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class SpriteFrameIndexTest : public SpriteTestDemo
+{
+public:
+    CREATE_FUNC(SpriteFrameIndexTest);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 class SpriteFramesFromFileContent : public SpriteTestDemo
 {
 public:
@@ -39,6 +39,7 @@ static std::function<Layer*()> createFunctions[] =
 
     CL(TextureMipMap),
     CL(TextureMemoryAlloc),
+    CL(TextureMemoryBudget),
     CL(TextureAlias),
     CL(TexturePVRMipMap),
     CL(TexturePVRMipMap2),
@@ -98,6 +99,7 @@ static std::function<Layer*()> createFunctions[] =
     CL(TextureS3TCDxt3),
     CL(TextureS3TCDxt5),
     CL(TextureS3TCWithNoMipmaps),
+    CL(TextureTranscode),
     
     CL(TextureATITCRGB),
     CL(TextureATITCExplicit),
@@ -2015,6 +2017,66 @@ std::string TextureMemoryAlloc::subtitle() const
     return "Testing Texture Memory allocation. Use Instruments + VM Tracker";
 }
 
+// TextureMemoryBudget
+static const char* s_budgetImages[] = {
+    "Images/background1.png", "Images/background2.png", "Images/background3.png", "Images/HelloWorld.png",
+};
+
+void TextureMemoryBudget::onEnter()
+{
+    TextureDemo::onEnter();
+    _background = nullptr;
+    _imageIndex = 0;
+    
+    // 480x320 RGBA8888 textures use 600 KB, at most one unused background fits beside the displayed one
+    auto cache = Director::getInstance()->getTextureCache();
+    cache->setMemoryBudget(cache->getMemoryUsage() + 1280 * 1024);
+    
+    auto s = Director::getInstance()->getWinSize();
+    _memoryLabel = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _memoryLabel->setPosition(Vec2(s.width/2, s.height/4));
+    addChild(_memoryLabel, 1);
+    
+    showNextImage(0);
+    schedule(CC_SCHEDULE_SELECTOR(TextureMemoryBudget::showNextImage), 0.5f);
+}
+
+void TextureMemoryBudget::onExit()
+{
+    Director::getInstance()->getTextureCache()->setMemoryBudget(0);
+    TextureDemo::onExit();
+}
+
+void TextureMemoryBudget::showNextImage(float dt)
+{
+    if (_background)
+    {
+        _background->removeFromParentAndCleanup(true);
+    }
+    
+    _background = Sprite::create(s_budgetImages[_imageIndex]);
+    _imageIndex = (_imageIndex + 1) % (sizeof(s_budgetImages) / sizeof(s_budgetImages[0]));
+    addChild(_background, -10);
+    
+    auto s = Director::getInstance()->getWinSize();
+    _background->setPosition(Vec2(s.width/2, s.height/2));
+    
+    auto cache = Director::getInstance()->getTextureCache();
+    char text[64];
+    snprintf(text, sizeof(text), "%.2f MB used, budget %.2f MB", cache->getMemoryUsage() / (1024.0f * 1024.0f), cache->getMemoryBudget() / (1024.0f * 1024.0f));
+    _memoryLabel->setString(text);
+}
+
+std::string TextureMemoryBudget::title() const
+{
+    return "Texture memory budget";
+}
+
+std::string TextureMemoryBudget::subtitle() const
+{
+    return "The unused backgrounds are evicted, least recently used first";
+}
+
 // TexturePVRv3Premult
 TexturePVRv3Premult::TexturePVRv3Premult()
 {
@@ -2169,6 +2231,55 @@ std::string TextureS3TCWithNoMipmaps::title() const
     return "S3TC with no mipmaps";
 }
 
+//Implement of the transcoded textures
+static const char* s_transcodedImages[] = {"Images/test_image.jpeg", "Images/test_image_rgba8888.png"};
+
+void TextureTranscode::onEnter()
+{
+    TextureDemo::onEnter();
+    
+    auto cache = Director::getInstance()->getTextureCache();
+    auto transcoder = TextureTranscoder::getInstance();
+    transcoder->setEnabled(true);
+    
+    auto s = Director::getInstance()->getWinSize();
+    for (int i = 0; i < 2; ++i)
+    {
+        // the textures may have been loaded uncompressed by other tests
+        cache->removeTextureForKey(s_transcodedImages[i]);
+        auto sprite = Sprite::create(s_transcodedImages[i]);
+        sprite->setPosition(Vec2((i + 1) * s.width / 3, s.height / 2));
+        addChild(sprite);
+        
+        auto label = Label::createWithTTF(sprite->getTexture()->getStringForFormat(), "fonts/arial.ttf", 14);
+        label->setPosition(Vec2((i + 1) * s.width / 3, s.height / 2 - sprite->getContentSize().height / 2 - 16));
+        addChild(label);
+    }
+    log("%s\n", cache->getCachedTextureInfo().c_str());
+}
+
+void TextureTranscode::onExit()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    for (auto image : s_transcodedImages)
+    {
+        cache->removeTextureForKey(image);
+    }
+    TextureTranscoder::getInstance()->setEnabled(false);
+    
+    TextureDemo::onExit();
+}
+
+std::string TextureTranscode::title() const
+{
+    return "Transcoded textures";
+}
+
+std::string TextureTranscode::subtitle() const
+{
+    return "JPEG and PNG compressed to ETC1 or S3TC\nand cached on disk";
+}
+
 //Implement of ATITC
 TextureATITCRGB::TextureATITCRGB()
 {
@@ -510,6 +510,21 @@ private:
     Sprite *_background;
 };
 
+class TextureMemoryBudget : public TextureDemo
+{
+public:
+    CREATE_FUNC(TextureMemoryBudget);
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    void showNextImage(float dt);
+private:
+    Sprite *_background;
+    Label *_memoryLabel;
+    int _imageIndex;
+};
+
 class TexturePVRv3Premult : public TextureDemo
 {
 public:
@@ -577,6 +592,17 @@ public:
     virtual std::string title() const override;
 };
 
+// PNG/JPEG textures compressed to ETC1/S3TC by the TextureTranscoder
+class TextureTranscode : public TextureDemo
+{
+public:
+    CREATE_FUNC(TextureTranscode);
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 // ATITC RGB texture format test
 class TextureATITCRGB : public TextureDemo
 {
@@ -21,8 +21,16 @@ TextureCacheTest::TextureCacheTest()
     this->addChild(_labelLoading);
     this->addChild(_labelPercent);
 
-    // load textrues
-    Director::getInstance()->getTextureCache()->addImageAsync("Images/HelloWorld.png", CC_CALLBACK_1(TextureCacheTest::loadingCallBack, this));
+    // log the timings of each texture, and create several textures per frame
+    auto textureCache = Director::getInstance()->getTextureCache();
+    textureCache->setAsyncLoadTimingsCallback([](const TextureCache::AsyncLoadTimings& timings){
+        CCLOG("%s: waited %.2f ms, decoded in %.2f ms, uploaded in %.2f ms", timings.filename.c_str(),
+              timings.waitTime * 1000, timings.decodeTime * 1000, timings.uploadTime * 1000);
+    });
+    textureCache->setAsyncUploadBudget(0.004f);
+
+    // load textrues, the background first
+    textureCache->addImageAsync("Images/HelloWorld.png", CC_CALLBACK_1(TextureCacheTest::loadingCallBack, this), ThreadPool::TaskPriority::HIGH);
     Director::getInstance()->getTextureCache()->addImageAsync("Images/grossini.png", CC_CALLBACK_1(TextureCacheTest::loadingCallBack, this));
     Director::getInstance()->getTextureCache()->addImageAsync("Images/grossini_dance_01.png", CC_CALLBACK_1(TextureCacheTest::loadingCallBack, this));
     Director::getInstance()->getTextureCache()->addImageAsync("Images/grossini_dance_02.png", CC_CALLBACK_1(TextureCacheTest::loadingCallBack, this));
@@ -44,6 +52,13 @@ TextureCacheTest::TextureCacheTest()
     Director::getInstance()->getTextureCache()->addImageAsync("Images/blocks.png", CC_CALLBACK_1(TextureCacheTest::loadingCallBack, this));
 }
 
+TextureCacheTest::~TextureCacheTest()
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+    textureCache->setAsyncLoadTimingsCallback(nullptr);
+    textureCache->setAsyncUploadBudget(0);
+}
+
 void TextureCacheTest::loadingCallBack(cocos2d::Texture2D *texture)
 {
     ++_numberOfLoadedSprites;
@@ -136,3 +151,128 @@ void TextureCacheTestScene::runThisTest()
     Director::getInstance()->replaceScene(this);
     layer->release();
 }
+
+static const char* s_asyncBoundImages[] = {
+    "Images/HelloWorld.png",
+    "Images/grossini.png",
+    "Images/grossini_dance_01.png",
+    "Images/grossini_dance_02.png",
+    "Images/grossini_dance_03.png",
+    "Images/grossini_dance_04.png",
+    "Images/grossini_dance_05.png",
+    "Images/grossini_dance_06.png",
+    "Images/grossini_dance_07.png",
+    "Images/grossini_dance_08.png",
+    "Images/grossini_dance_09.png",
+    "Images/grossini_dance_10.png",
+    "Images/grossini_dance_11.png",
+    "Images/grossini_dance_12.png",
+    "Images/grossini_dance_13.png",
+    "Images/grossini_dance_14.png",
+    "Images/background1.png",
+    "Images/background2.png",
+    "Images/background3.png",
+    "Images/blocks.png",
+};
+
+TextureCacheAsyncBoundTest::TextureCacheAsyncBoundTest()
+: _decodeThreadCount(2)
+, _numberOfImages(sizeof(s_asyncBoundImages) / sizeof(s_asyncBoundImages[0]))
+, _numberOfLoadedImages(0)
+{
+    auto size = Director::getInstance()->getWinSize();
+
+    _labelPeak = Label::createWithTTF("loading...", "fonts/arial.ttf", 15);
+    _labelPeak->setPosition(Vec2(size.width / 2, size.height / 2 + 40));
+    this->addChild(_labelPeak);
+
+    _labelOrder = Label::createWithTTF("", "fonts/arial.ttf", 12);
+    _labelOrder->setDimensions(size.width - 40, 0);
+    _labelOrder->setAlignment(TextHAlignment::CENTER);
+    _labelOrder->setPosition(Vec2(size.width / 2, size.height / 2 - 20));
+    this->addChild(_labelOrder);
+
+    auto textureCache = Director::getInstance()->getTextureCache();
+    textureCache->setAsyncDecodeThreadCount(_decodeThreadCount);
+
+    // the images are requested in the same frame, so the timings of each one are relative to the same moment.
+    // the timings are reported in the order the textures are created
+    textureCache->setAsyncLoadTimingsCallback([this](const TextureCache::AsyncLoadTimings& timings){
+        DecodeInterval interval;
+        interval.begin = timings.waitTime;
+        interval.end = timings.waitTime + timings.decodeTime;
+        _decodeIntervals.push_back(interval);
+        _completionOrder.push_back(timings.filename.substr(timings.filename.find_last_of("/\\") + 1));
+    });
+
+    for (int i = 0; i < _numberOfImages; ++i)
+    {
+        // loaded by another test, the texture would be returned without being decoded
+        textureCache->removeTextureForKey(s_asyncBoundImages[i]);
+        textureCache->addImageAsync(s_asyncBoundImages[i], CC_CALLBACK_1(TextureCacheAsyncBoundTest::loadingCallBack, this));
+    }
+}
+
+TextureCacheAsyncBoundTest::~TextureCacheAsyncBoundTest()
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+    textureCache->setAsyncLoadTimingsCallback(nullptr);
+    textureCache->setAsyncDecodeThreadCount(0);
+}
+
+void TextureCacheAsyncBoundTest::loadingCallBack(cocos2d::Texture2D *texture)
+{
+    ++_numberOfLoadedImages;
+    char tmp[64];
+    sprintf(tmp, "loading... %d/%d", _numberOfLoadedImages, _numberOfImages);
+    _labelPeak->setString(tmp);
+
+    if (_numberOfLoadedImages == _numberOfImages)
+    {
+        showResults();
+    }
+}
+
+void TextureCacheAsyncBoundTest::showResults()
+{
+    // the most intervals overlapping at the same time, the ends first when an image starts as another one ends
+    std::vector<std::pair<float, int>> events;
+    for (const auto& interval : _decodeIntervals)
+    {
+        events.push_back(std::make_pair(interval.begin, 1));
+        events.push_back(std::make_pair(interval.end, -1));
+    }
+    std::sort(events.begin(), events.end());
+
+    int inFlight = 0;
+    int peak = 0;
+    for (const auto& event : events)
+    {
+        inFlight += event.second;
+        peak = std::max(peak, inFlight);
+    }
+
+    char tmp[128];
+    sprintf(tmp, "%d images, peak decodes in flight: %d (bound: %d) %s", _numberOfImages, peak, _decodeThreadCount,
+            peak <= _decodeThreadCount ? "OK" : "EXCEEDED");
+    _labelPeak->setString(tmp);
+    _labelPeak->setColor(peak <= _decodeThreadCount ? Color3B::GREEN : Color3B::RED);
+    CCLOG("%s", tmp);
+
+    std::string order = "completion order:";
+    for (const auto& name : _completionOrder)
+    {
+        order += " " + name;
+    }
+    _labelOrder->setString(order);
+    CCLOG("%s", order.c_str());
+}
+
+void TextureCacheAsyncBoundTestScene::runThisTest()
+{
+    auto layer = new (std::nothrow) TextureCacheAsyncBoundTest();
+    addChild(layer);
+
+    Director::getInstance()->replaceScene(this);
+    layer->release();
+}
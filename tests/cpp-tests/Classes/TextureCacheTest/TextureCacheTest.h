@@ -9,6 +9,7 @@ class TextureCacheTest : public Layer
 {
 public:
     TextureCacheTest();
+    virtual ~TextureCacheTest();
     void addSprite();
     void loadingCallBack(cocos2d::Texture2D *texture);
 
@@ -25,4 +26,35 @@ public:
     virtual void runThisTest();
 };
 
+// queues more images than the decodes allowed in flight, and shows the most decodes that overlapped and the order the images completed in
+class TextureCacheAsyncBoundTest : public Layer
+{
+public:
+    TextureCacheAsyncBoundTest();
+    virtual ~TextureCacheAsyncBoundTest();
+    void loadingCallBack(cocos2d::Texture2D *texture);
+    void showResults();
+
+private:
+    struct DecodeInterval
+    {
+        float begin;
+        float end;
+    };
+
+    cocos2d::Label *_labelPeak;
+    cocos2d::Label *_labelOrder;
+    int _decodeThreadCount;
+    int _numberOfImages;
+    int _numberOfLoadedImages;
+    std::vector<DecodeInterval> _decodeIntervals;
+    std::vector<std::string> _completionOrder;
+};
+
+class TextureCacheAsyncBoundTestScene : public TestScene
+{
+public:
+    virtual void runThisTest();
+};
+
 #endif // _TEXTURECACHE_TEST_H_
@@ -25,7 +25,7 @@ enum
 
 static int sceneIdx = -1;
 
-#define MAX_LAYER    29
+#define MAX_LAYER    31
 
 static std::function<Layer*()> createFunctions[] = {
     CLN(TMXIsoZorder),
@@ -58,6 +58,7 @@ static std::function<Layer*()> createFunctions[] = {
     CLN(TMXBug987),
     CLN(TMXBug787),
     CLN(TMXGIDObjectsTest),
+    CLN(TMXAsyncLoadTest),
 
 };
 
@@ -1536,3 +1537,43 @@ std::string TMXGIDObjectsTest::subtitle() const
 {
     return "Tiles are created from an object group";
 }
+
+//------------------------------------------------------------------
+//
+// TMXAsyncLoadTest
+//
+//------------------------------------------------------------------
+
+TMXAsyncLoadTest::TMXAsyncLoadTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF("Loading...", "fonts/arial.ttf", 24);
+    label->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(label);
+
+    // the test can be left before the map is loaded
+    retain();
+    TMXTiledMap::createAsync("TileMaps/orthogonal-test1.tmx", [this, label](TMXTiledMap* map) {
+        label->removeFromParent();
+        if (map)
+        {
+            addChild(map, 0, kTagTileMap);
+            map->runAction(ScaleBy::create(2, 0.5f));
+        }
+        else
+        {
+            CCLOG("TMXAsyncLoadTest: can't load the map");
+        }
+        release();
+    });
+}
+
+std::string TMXAsyncLoadTest::title() const
+{
+    return "TMX async load";
+}
+
+std::string TMXAsyncLoadTest::subtitle() const
+{
+    return "The map is parsed and its textures loaded in the background";
+}
@@ -296,6 +296,14 @@ public:
     virtual std::string subtitle() const override;    
 };
 
+class TMXAsyncLoadTest : public TileDemo
+{
+public:
+    TMXAsyncLoadTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 class TileMapTestScene : public TestScene
 {
 public:
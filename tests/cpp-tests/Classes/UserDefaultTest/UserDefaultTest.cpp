@@ -88,6 +88,24 @@ void UserDefaultTest::doTest()
     {
         CCLOG("bool is false");
     }
+
+    CCLOG("********************** after reload ***********************");
+
+    // the values are saved on a worker thread, then read back from the file
+
+    UserDefault::getInstance()->setStringForKey("string", "value3");
+    UserDefault::getInstance()->setIntegerForKey("integer", 12);
+    UserDefault::getInstance()->flushAsync();
+    UserDefault::destroyInstance();
+
+    ret = UserDefault::getInstance()->getStringForKey("string");
+    CCLOG("string is %s", ret.c_str());
+
+    i = UserDefault::getInstance()->getIntegerForKey("integer");
+    CCLOG("integer is %d", i);
+
+    b = UserDefault::getInstance()->getBoolForKey("bool", true);
+    CCLOG("bool is %s", b ? "true" : "false");
 }
 
 
@@ -93,6 +93,7 @@ Controller g_aTestNames[] = {
     { "Shader - Sprite", []() { return new ShaderTestScene2(); } },
 	{ "Texture2D", [](){return new TextureTestScene(); } },
 	{ "TextureCache", []() { return new TextureCacheTestScene(); } },
+	{ "TextureCache - Async Bound", []() { return new TextureCacheAsyncBoundTestScene(); } },
 	{ "TexturePacker Encryption", []() { return new TextureAtlasEncryptionTestScene(); } },
 	{ "Touches", [](){return new PongScene();} },
 	{ "Transitions", [](){return new TransitionsTestScene();} },
@@ -93,6 +93,9 @@ LOCAL_SRC_FILES := main.cpp \
 ../../Classes/PerformanceTest/PerformanceScenarioTest.cpp \
 ../../Classes/PerformanceTest/PerformanceCallbackTest.cpp \
 ../../Classes/PerformanceTest/PerformanceMathTest.cpp \
+../../Classes/PerformanceTest/PerformanceRenderQueueTest.cpp \
+../../Classes/PerformanceTest/PerformanceFileUtilsTest.cpp \
+../../Classes/PerformanceTest/PerformanceLocalStorageTest.cpp \
 ../../Classes/PhysicsTest/PhysicsTest.cpp \
 ../../Classes/ReleasePoolTest/ReleasePoolTest.cpp \
 ../../Classes/RenderTextureTest/RenderTextureTest.cpp \
@@ -149,7 +152,9 @@ LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../Classes \
                     $(LOCAL_PATH)/../../../..
 
 LOCAL_STATIC_LIBRARIES := cocos2dx_static
+LOCAL_STATIC_LIBRARIES += cocos_localstorage_static
 
 include $(BUILD_SHARED_LIBRARY)
 
 $(call import-module,.)
+$(call import-module,storage/local-storage)
@@ -0,0 +1,128 @@
+#!/usr/bin/python
+#build_pack.py
+#Builds a read-only file pack from a directory, which FileUtils::addSearchPack() mounts as a search path.
+#The entries are stored compressed with zlib when it makes them smaller enough, uncompressed otherwise.
+
+import os
+import argparse
+import struct
+import zlib
+
+MAGIC = b'CCPK'
+VERSION = 1
+NO_ENTRY = 0xffffffff
+
+COMPRESSION_NONE = 0
+COMPRESSION_ZLIB = 1
+
+HEADER_FORMAT = '<4sHHIIIIII'
+ENTRY_FORMAT = '<IIHHIII'
+
+#32 bits FNV-1a, the hash used by FilePack
+def hashName(name):
+    hash = 2166136261
+    for byte in bytearray(name):
+        hash ^= byte
+        hash = (hash * 16777619) & 0xffffffff
+    return hash
+
+def align(data, alignment=4):
+    while len(data) % alignment != 0:
+        data += b'\0'
+
+#returns the files of a directory as (name in the pack, path), names use '/' as separator
+def listFiles(directory):
+    files = []
+    for root, dirs, filenames in os.walk(directory):
+        dirs.sort()
+        for filename in sorted(filenames):
+            if filename.startswith('.'):
+                continue
+            path = os.path.join(root, filename)
+            name = os.path.relpath(path, directory).replace(os.sep, '/')
+            files.append((name, path))
+    return files
+
+def build(directory, output, level, ratio):
+    files = listFiles(directory)
+    headerSize = struct.calcsize(HEADER_FORMAT)
+    entrySize = struct.calcsize(ENTRY_FORMAT)
+
+    #at most half of the buckets are used
+    bucketCount = 1
+    while bucketCount < len(files) * 2:
+        bucketCount *= 2
+
+    strings = bytearray()
+    names = []
+    for name, path in files:
+        encoded = name.encode('utf-8')
+        if len(encoded) > 0xffff:
+            raise ValueError('%s: the name is too long' % name)
+        names.append((encoded, len(strings)))
+        strings += encoded + b'\0'
+    align(strings)
+
+    bucketsOffset = headerSize
+    entriesOffset = bucketsOffset + bucketCount * 4
+    stringsOffset = entriesOffset + len(files) * entrySize
+    dataOffset = stringsOffset + len(strings)
+
+    entries = bytearray()
+    data = bytearray()
+    buckets = [NO_ENTRY] * bucketCount
+    storedBytes = 0
+    totalBytes = 0
+    for index, (name, path) in enumerate(files):
+        with open(path, 'rb') as fp:
+            content = fp.read()
+
+        compression = COMPRESSION_NONE
+        stored = content
+        if level > 0 and len(content) > 0:
+            compressed = zlib.compress(content, level)
+            if len(compressed) <= len(content) * ratio:
+                compression = COMPRESSION_ZLIB
+                stored = compressed
+
+        encoded, nameOffset = names[index]
+        hash = hashName(encoded)
+        entries += struct.pack(ENTRY_FORMAT, hash, nameOffset, len(encoded), compression,
+                               dataOffset + len(data), len(content), len(stored))
+        data += stored
+        align(data)
+
+        bucket = hash & (bucketCount - 1)
+        while buckets[bucket] != NO_ENTRY:
+            bucket = (bucket + 1) & (bucketCount - 1)
+        buckets[bucket] = index
+
+        totalBytes += len(content)
+        storedBytes += len(stored)
+
+    if dataOffset + len(data) > 0xffffffff:
+        raise ValueError('the pack is larger than 4GB')
+
+    with open(output, 'wb') as fp:
+        fp.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, 0, len(files), bucketCount,
+                             bucketsOffset, entriesOffset, stringsOffset, len(strings)))
+        fp.write(struct.pack('<%dI' % bucketCount, *buckets))
+        fp.write(entries)
+        fp.write(strings)
+        fp.write(data)
+
+    print('%s: %d files, %d bytes stored for %d bytes' % (output, len(files), storedBytes, totalBytes))
+
+# -------------- entrance --------------
+if __name__ == '__main__':
+    argparser = argparse.ArgumentParser(
+        description="Builds a file pack for FileUtils::addSearchPack() from the files of a directory.")
+    argparser.add_argument('directory', help="the directory to pack, its files are named relatively to it")
+    argparser.add_argument('-o', '--output', help="the pack file, the directory name followed by .ccpk by default")
+    argparser.add_argument('-l', '--level', type=int, default=6, help="the zlib compression level, 0 to store all the files uncompressed")
+    argparser.add_argument('-r', '--ratio', type=float, default=0.9,
+                           help="a file is compressed only if it makes it smaller than this ratio of its size, 0.9 by default")
+    args = argparser.parse_args()
+
+    output = args.output or os.path.normpath(args.directory) + '.ccpk'
+    build(args.directory, output, args.level, args.ratio)
@@ -0,0 +1,112 @@
+#!/usr/bin/python
+#plist_to_index.py
+#Converts the plist files of sprite sheets to binary sprite sheet indices,
+#which SpriteFrameCache loads in place instead of parsing XML.
+
+import plistlib
+import os.path
+import argparse
+import re
+import struct
+
+MAGIC = b'CSSI'
+VERSION = 1
+NO_STRING = 0xffffffff
+ROTATED = 1
+
+HEADER_FORMAT = '<4sHHIIIIIII'
+FRAME_FORMAT = '<II8f'
+ALIAS_FORMAT = '<II'
+
+#reads "{{x,y},{w,h}}", "{x,y}" or "{w,h}" strings, as written by the sprite sheet tools
+def parseNumbers(value):
+    return [float(n) for n in re.findall(r'[-+]?[0-9]*\.?[0-9]+(?:[eE][-+]?[0-9]+)?', value)]
+
+def readPlist(filename):
+    if hasattr(plistlib, 'load'):
+        with open(filename, 'rb') as fp:
+            return plistlib.load(fp)
+    return plistlib.readPlist(filename)
+
+#string pool, each string is stored once
+class StringPool:
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, string):
+        if string not in self.offsets:
+            self.offsets[string] = len(self.data)
+            self.data += string.encode('utf-8') + b'\0'
+        return self.offsets[string]
+
+#returns the frames as (name, flags, x, y, width, height, offsetX, offsetY, sourceWidth, sourceHeight) and the aliases,
+#the same way SpriteFrameCache::addSpriteFramesWithDictionary() reads them
+def readFrames(plist):
+    metadata = plist.get('metadata', {})
+    format = metadata.get('format', 0)
+    if format < 0 or format > 3:
+        raise ValueError('format %d is not supported' % format)
+
+    frames = []
+    aliases = []
+    for name in sorted(plist['frames'].keys()):
+        frame = plist['frames'][name]
+        if format == 0:
+            rect = [frame.get('x', 0), frame.get('y', 0), frame.get('width', 0), frame.get('height', 0)]
+            offset = [frame.get('offsetX', 0), frame.get('offsetY', 0)]
+            source = [abs(int(frame.get('originalWidth', 0))), abs(int(frame.get('originalHeight', 0)))]
+            rotated = False
+        elif format == 1 or format == 2:
+            rect = parseNumbers(frame['frame'])
+            offset = parseNumbers(frame['offset'])
+            source = parseNumbers(frame['sourceSize'])
+            rotated = format == 2 and bool(frame.get('rotated', False))
+        else:
+            size = parseNumbers(frame['spriteSize'])
+            rect = parseNumbers(frame['textureRect'])[0:2] + size
+            offset = parseNumbers(frame['spriteOffset'])
+            source = parseNumbers(frame['spriteSourceSize'])
+            rotated = bool(frame.get('textureRotated', False))
+            for alias in frame.get('aliases', []):
+                aliases.append((alias, len(frames)))
+        frames.append((name, ROTATED if rotated else 0, rect, offset, source))
+    return frames, aliases, metadata.get('textureFileName', '')
+
+def convert(filename, output):
+    frames, aliases, textureFileName = readFrames(readPlist(filename))
+
+    strings = StringPool()
+    frameData = bytearray()
+    for name, flags, rect, offset, source in frames:
+        values = [float(v) for v in rect + offset + source]
+        frameData += struct.pack(FRAME_FORMAT, strings.add(name), flags, *values)
+    aliasData = bytearray()
+    for alias, frame in aliases:
+        aliasData += struct.pack(ALIAS_FORMAT, strings.add(alias), frame)
+    textureName = strings.add(textureFileName) if textureFileName else NO_STRING
+    if len(strings.data) == 0:
+        strings.add('')
+
+    framesOffset = struct.calcsize(HEADER_FORMAT)
+    aliasesOffset = framesOffset + len(frameData)
+    stringsOffset = aliasesOffset + len(aliasData)
+    header = struct.pack(HEADER_FORMAT, MAGIC, VERSION, 0, len(frames), len(aliases),
+                         framesOffset, aliasesOffset, stringsOffset, len(strings.data), textureName)
+
+    with open(output, 'wb') as fp:
+        fp.write(header + frameData + aliasData + strings.data)
+    print('%s: %d frames, %d aliases -> %s' % (filename, len(frames), len(aliases), output))
+
+# -------------- entrance --------------
+if __name__ == '__main__':
+    argparser = argparse.ArgumentParser(description = 'Converts sprite sheet plist files to binary indices for SpriteFrameCache')
+    argparser.add_argument('file', nargs = '+', help = 'plist files to convert')
+    argparser.add_argument('-e', '--extension', default = '.cssi', help = 'extension of the output files, .cssi by default')
+    args = argparser.parse_args()
+
+    for file in args.file:
+        if not os.path.isfile(file):
+            print(file + ' does not exist!')
+            continue
+        convert(file, os.path.splitext(file)[0] + args.extension)